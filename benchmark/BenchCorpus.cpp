@@ -0,0 +1,181 @@
+// Author: Akira Kudo
+
+#include <algorithm>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark/BenchCorpus.h"
+#include "src/cspSolver/CSPGraph.h"
+#include "src/graphImplementation/vertices/ConstraintVertex.h"
+#include "src/graphImplementation/vertices/VariableVertex.h"
+
+using CSPSolverImplementation::CSPGraph, GraphImplementation::ConstraintVertex, GraphImplementation::VariableVertex;
+
+namespace
+{
+    // roles of Gnosia, in the order of main.cpp
+    enum Role { acFollower, bug, crewMember, doctor, engineer, gnosia, guardianAngel, guardDuty, Role_MAX };
+
+    // small deterministic generator, so that the corpus is the same on every platform
+    struct Lcg
+    {
+        uint32_t state;
+        uint32_t next() { state = state * 1664525u + 1013904223u; return state >> 8; };
+        uint32_t below(uint32_t bound) { return next() % bound; };
+    };
+
+    // solved 9x9 sudoku and its puzzles, as in testCSPSolver.cpp
+    const std::string EASY_9X9 = "x82167534" "5x3924168" "14x358972"
+                                 "3685x9247" "21473x895" "759x42613"
+                                 "831495x26" "42x671389" "6x7283451";
+    const std::string HARD_9X9 = "xxxx6753x" "5xx92x1xx" "x4xxxxx7x"
+                                 "xxxxx92xx" "x1473xxxx" "7x9xxxx1x"
+                                 "x3xxxxx26" "425x71x89" "6x7283x51";
+
+    char sudokuSymbol(int val) { return (val < 10) ? (char) ('0' + val) : (char) ('A' + val - 10); };
+    int sudokuValue(char symbol) { return (symbol <= '9') ? (symbol - '0') : (symbol - 'A' + 10); };
+
+    // builds a 16x16 puzzle: a solved grid from the usual band pattern, shuffled & 
+    // relabeled from seed, then with open_percent of its squares left open
+    std::string make16x16Puzzle(uint32_t seed, uint32_t open_percent)
+    {
+        const int box_size = 4, side = 16;
+        Lcg lcg { seed };
+        std::vector<int> relabel(side);
+        for (int i = 0; i < side; i++) relabel[i] = i + 1;
+        for (int i = side - 1; i > 0; i--) std::swap(relabel[i], relabel[lcg.below(i + 1)]);
+        // rows within a band / columns within a stack can be swapped freely
+        std::vector<int> rows(side), cols(side);
+        for (int i = 0; i < side; i++) rows[i] = cols[i] = i;
+        for (int band = 0; band < box_size; band++)
+            for (int i = box_size - 1; i > 0; i--)
+            {
+                std::swap(rows[band * box_size + i], rows[band * box_size + lcg.below(i + 1)]);
+                std::swap(cols[band * box_size + i], cols[band * box_size + lcg.below(i + 1)]);
+            }
+
+        std::string grid;
+        for (int r = 0; r < side; r++)
+            for (int c = 0; c < side; c++)
+            {
+                int row = rows[r], col = cols[c];
+                int val = relabel[(box_size * (row % box_size) + row / box_size + col) % side];
+                grid += (lcg.below(100) < open_percent) ? 'x' : sudokuSymbol(val);
+            }
+        return grid;
+    };
+
+    // allows either zero or exactly two guard duties among the players
+    bool zeroOrTwoGuardDuties(int mainVal, std::vector<VariableVertex*> varList)
+    {
+        int can_be = (mainVal == guardDuty), has_to_be = (mainVal == guardDuty);
+        for (VariableVertex* var : varList)
+        {
+            if (!var->domainContains(guardDuty)) continue;
+            can_be++;
+            if (var->getDomainSize() == 1) has_to_be++;
+        }
+        return (has_to_be == 0) || (has_to_be <= 2 && can_be >= 2);
+    };
+}
+
+// creates a sudoku with boxes of box_size x box_size squares, values going from 1 to box_size^2
+// grid gives the squares row by row: 'x' is left open, '1'-'9' then 'A'-'G' stand for 1 to 16
+CSPGraph Benchmark::makeSudoku(int box_size, const std::string& grid)
+{
+    CSPGraph graph;
+    int side = box_size * box_size;
+    std::set<int> full_domain;
+    for (int val = 1; val <= side; val++) full_domain.insert(val);
+
+    // variables are named "Square row-col" as in the tests
+    auto square_name = [] (int row, int col) 
+    { 
+        return "Square " + std::to_string(row + 1) + "-" + std::to_string(col + 1); 
+    };
+    for (int row = 0; row < side; row++)
+        for (int col = 0; col < side; col++)
+        {
+            char symbol = grid[row * side + col];
+            if (symbol == 'x') graph.add_variable(square_name(row, col), full_domain);
+            else graph.add_variable(square_name(row, col), {sudokuValue(symbol)});
+        }
+
+    // one "exactly one of val" constraint per value and row / column / box
+    for (int val = 1; val <= side; val++)
+        for (int pos = 0; pos < side; pos++)
+            for (std::string type : {"row", "col", "squ"})
+            {
+                std::string cv_name = "OnlyOne" + std::to_string(val) + "-" + type + "-" + std::to_string(pos + 1);
+                graph.add_constraint(cv_name, ConstraintVertex::exactlyN(val, 1));
+                for (int i = 0; i < side; i++)
+                {
+                    int row = pos, col = i;
+                    if (type == "col") { row = i; col = pos; }
+                    else if (type == "squ") 
+                    { 
+                        row = (pos / box_size) * box_size + i / box_size; 
+                        col = (pos % box_size) * box_size + i % box_size; 
+                    }
+                    graph.add_edge(square_name(row, col), cv_name);
+                }
+            }
+    return graph;
+};
+
+// creates a Gnosia game of given number of players, where the roles of some players
+// are revealed and the others are narrowed down to a few roles, as generated from seed
+CSPGraph Benchmark::makeGnosiaGame(int players, uint32_t seed)
+{
+    CSPGraph graph;
+    Lcg lcg { seed };
+
+    // hidden roles: the usual special roles depending on the crew size, crew members otherwise
+    int gnosia_count = std::max(1, (players - 1) / 3);
+    std::vector<int> roles(gnosia_count, gnosia);
+    roles.push_back(engineer);
+    roles.push_back(doctor);
+    if (players >= 6) roles.push_back(guardianAngel);
+    if (players >= 7) roles.push_back(acFollower);
+    if (players >= 9) roles.push_back(bug);
+    if (players >= 10) { roles.push_back(guardDuty); roles.push_back(guardDuty); }
+    roles.resize(players, crewMember);
+    for (int i = players - 1; i > 0; i--) std::swap(roles[i], roles[lcg.below(i + 1)]);
+
+    // observations: a few players stay uncertain between their role and two others
+    int uncertain = std::min(players, 2 + players / 3);
+    std::vector<std::string> names;
+    for (int p = 0; p < players; p++)
+    {
+        names.push_back("Player " + std::to_string(p + 1));
+        std::set<int> candidates { roles[p] };
+        if (p < uncertain)
+            while (candidates.size() < 3) candidates.insert((int) lcg.below(Role_MAX));
+        graph.add_variable(names.back(), candidates);
+    }
+
+    // game rules
+    graph.add_constraint("ExactGnosiaCount", ConstraintVertex::exactlyN(gnosia, gnosia_count));
+    for (int role : {acFollower, bug, doctor, engineer, guardianAngel})
+        graph.add_constraint("AtMostOne" + std::to_string(role), ConstraintVertex::lesserOrEqualToN(role, 1));
+    graph.add_constraint("ZeroOrTwoGuardDuties", zeroOrTwoGuardDuties);
+    for (const std::string& cv_name : graph.get_all_constraint_names())
+        for (const std::string& vv_name : names) graph.add_edge(vv_name, cv_name);
+    return graph;
+};
+
+// returns every instance of the corpus, in the order they are run
+std::vector<Benchmark::BenchInstance> Benchmark::makeCorpus()
+{
+    std::vector<BenchInstance> corpus;
+    corpus.push_back({"sudoku9-empty", makeSudoku(3, std::string(81, 'x')), true});
+    corpus.push_back({"sudoku9-easy", makeSudoku(3, EASY_9X9), false});
+    corpus.push_back({"sudoku9-hard", makeSudoku(3, HARD_9X9), false});
+    corpus.push_back({"sudoku16", makeSudoku(4, make16x16Puzzle(16, 35)), false});
+    for (int players = 5; players <= 15; players += 2)
+        corpus.push_back({"gnosia" + std::to_string(players), makeGnosiaGame(players, (uint32_t) players), false});
+    return corpus;
+};
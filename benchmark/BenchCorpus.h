@@ -0,0 +1,35 @@
+// Author: Akira Kudo
+// Description: Builds the fixed corpus of CSP instances run by the bench executable.
+//  Every instance is generated deterministically, so that two builds solving the 
+//  corpus report the same answers & revisions and only differ in timings.
+
+#ifndef BENCHMARK_BENCHCORPUS_H
+#define BENCHMARK_BENCHCORPUS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "src/cspSolver/CSPGraph.h"
+
+namespace Benchmark
+{
+    struct BenchInstance
+    {
+        std::string name;
+        CSPSolverImplementation::CSPGraph graph;
+        // instances with too many answers to enumerate only look for their first answer
+        bool needs_answer_limit;
+    };
+
+    // creates a sudoku with boxes of box_size x box_size squares, values going from 1 to box_size^2
+    // grid gives the squares row by row: 'x' is left open, '1'-'9' then 'A'-'G' stand for 1 to 16
+    CSPSolverImplementation::CSPGraph makeSudoku(int box_size, const std::string& grid);
+    // creates a Gnosia game of given number of players, where the roles of some players
+    // are revealed and the others are narrowed down to a few roles, as generated from seed
+    CSPSolverImplementation::CSPGraph makeGnosiaGame(int players, uint32_t seed);
+    // returns every instance of the corpus, in the order they are run
+    std::vector<BenchInstance> makeCorpus();
+}
+
+#endif
@@ -0,0 +1,165 @@
+// Author: Akira Kudo
+// Description: Runs the solver on the fixed corpus of BenchCorpus.h, printing for every instance
+//  the answers found, the arc revisions made, the median wall time over the repeated runs,
+//  the revisions per second and the peak resident set size of the process so far.
+//  Columns up to revisions only depend on the solver, so they can be diffed between builds.
+//  Instances with too many answers to enumerate only look for the first one, shown as "1+".
+//  Usage: ./bench [--repeat N] [--filter SUBSTRING] [--engine ac|dfs] [--search-mode copy|trail|parallel]
+//                 [--solve-mode all|first|count] [--propagation ac3|residue] 
+//                 [--branching input|mrv|deg|domdeg|domwdeg] [--fuse yes|no] [--backjump yes|no]
+//                 [--symmetry none|lex|canonical] [--cache N] [--decompose yes|no]
+//  --fuse yes replaces cardinality constraints sharing a scope by global cardinality constraints.
+//  --backjump yes uses conflict-directed backjumping with nogood learning instead of chronological backtracking.
+//  --symmetry lex|canonical breaks symmetries between interchangeable variables & values; answers then
+//  count the answers reported, not the ones they stand for.
+//  --cache N keeps up to N propagated states in a transposition cache shared by the repeated runs of
+//  an instance, so that runs after the first replay the states the first one searched.
+//  --decompose yes searches each connected component of an instance on its own, combining their answers.
+//  Unknown options, unknown values & options missing their value print the usage and exit with 1.
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "benchmark/BenchCorpus.h"
+#include "src/cspSolver/CSPGraph.h"
+#include "src/cspSolver/CSPSolver.h"
+
+using CSPSolverImplementation::CSPGraph, CSPSolverImplementation::CSPSolver;
+
+// peak resident set size of this process, in kilobytes
+long peakRssKb()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+};
+
+// prints the usage to stderr, returning the exit code of malformed options
+int usage()
+{
+    std::fprintf(stderr, "Usage: ./bench [--repeat N] [--filter SUBSTRING] [--engine ac|dfs] [--search-mode copy|trail|parallel]\n"
+                         "               [--solve-mode all|first|count] [--propagation ac3|residue]\n"
+                         "               [--branching input|mrv|deg|domdeg|domwdeg] [--fuse yes|no] [--backjump yes|no]\n"
+                         "               [--symmetry none|lex|canonical] [--cache N] [--decompose yes|no]\n");
+    return 1;
+};
+
+// whether value is one of choices
+bool isOneOf(const std::string& value, std::initializer_list<const char*> choices)
+{
+    return std::any_of(choices.begin(), choices.end(), [&value] (const char* choice) { return value == choice; });
+};
+
+// reads a non-negative integer into count; returns false if value is anything else
+bool parseCount(const std::string& value, int& count)
+{
+    auto result = std::from_chars(value.data(), value.data() + value.size(), count);
+    return (result.ec == std::errc() && result.ptr == value.data() + value.size() && count >= 0);
+};
+
+int main(int argc, char* argv[])
+{
+    int repeat = 3;
+    std::string filter = "";
+    std::string engine = "ac";
+    CSPSolver::SearchMode search_mode = CSPSolver::TrailMode;
+    CSPSolver::SolveMode solve_mode = CSPSolver::AllSolutionsMode;
+    CSPSolver::PropagationMode propagation_mode = CSPSolver::AC3Mode;
+    std::string branching = "input";
+    bool fuse = false;
+    bool backjump = false;
+    std::string symmetry = "none";
+    size_t cache_size = 0;
+    bool decompose = false;
+
+    for (int i = 1; i < argc; i += 2)
+    {
+        if (i + 1 == argc) return usage();
+        std::string option = argv[i], value = argv[i + 1];
+        int count;
+        if (option == "--repeat" && parseCount(value, count)) repeat = std::max(1, count);
+        else if (option == "--filter") filter = value;
+        else if (option == "--engine" && isOneOf(value, { "ac", "dfs" })) engine = value;
+        else if (option == "--search-mode" && isOneOf(value, { "copy", "trail", "parallel" }))
+            search_mode = (value == "copy") ? CSPSolver::CopyMode : 
+                          ((value == "parallel") ? CSPSolver::ParallelMode : CSPSolver::TrailMode);
+        else if (option == "--solve-mode" && isOneOf(value, { "all", "first", "count" }))
+            solve_mode = (value == "first") ? CSPSolver::FirstSolutionMode : 
+                         ((value == "count") ? CSPSolver::CountOnlyMode : CSPSolver::AllSolutionsMode);
+        else if (option == "--propagation" && isOneOf(value, { "ac3", "residue" }))
+            propagation_mode = (value == "residue") ? CSPSolver::ResidueMode : CSPSolver::AC3Mode;
+        else if (option == "--branching" && isOneOf(value, { "input", "mrv", "deg", "domdeg", "domwdeg" })) branching = value;
+        else if (option == "--fuse" && isOneOf(value, { "yes", "no" })) fuse = (value == "yes");
+        else if (option == "--backjump" && isOneOf(value, { "yes", "no" })) backjump = (value == "yes");
+        else if (option == "--symmetry" && isOneOf(value, { "none", "lex", "canonical" })) symmetry = value;
+        else if (option == "--cache" && parseCount(value, count)) cache_size = (size_t) count;
+        else if (option == "--decompose" && isOneOf(value, { "yes", "no" })) decompose = (value == "yes");
+        else return usage();
+    }
+
+    CSPSolver::BranchingHeuristic branching_heuristic = 
+        (branching == "mrv") ? CSPSolver::SmallestDomain : 
+        (branching == "deg") ? CSPSolver::LargestDegree : 
+        (branching == "domdeg") ? CSPSolver::DomainOverDegree : 
+        (branching == "domwdeg") ? CSPSolver::DomainOverWeightedDegree : CSPSolver::InputOrder;
+    CSPSolver::SymmetryMode symmetry_mode = 
+        (symmetry == "lex") ? CSPSolver::LexLeaderMode : 
+        (symmetry == "canonical") ? CSPSolver::CanonicalMode : CSPSolver::NoSymmetryBreaking;
+
+    std::printf("# engine=%s propagation=%s branching=%s fuse=%s backjump=%s symmetry=%s cache=%zu decompose=%s repeat=%d\n", 
+                engine.c_str(), (propagation_mode == CSPSolver::ResidueMode) ? "residue" : "ac3", branching.c_str(), 
+                fuse ? "yes" : "no", backjump ? "yes" : "no", symmetry.c_str(), cache_size, decompose ? "yes" : "no", repeat);
+    std::printf("%-16s %6s %6s %8s %12s %10s %12s %12s\n", 
+                "instance", "vars", "cons", "answers", "revisions", "wall_ms", "rev_per_s", "peak_rss_kb");
+
+    for (Benchmark::BenchInstance& instance : Benchmark::makeCorpus())
+    {
+        if (instance.name.find(filter) == std::string::npos) continue;
+        CSPGraph& graph = instance.graph;
+        if (fuse) graph.fuse_cardinality_constraints();
+        graph.freeze();
+        CSPSolver::SolveMode instance_solve_mode = instance.needs_answer_limit ? CSPSolver::FirstSolutionMode : solve_mode;
+
+        CSPSolver settings = CSPSolver(search_mode);
+        settings.setSolveMode(instance_solve_mode);
+        settings.setPropagationMode(propagation_mode);
+        settings.setBranchingHeuristic(branching_heuristic);
+        if (backjump) settings.setBacktrackMode(CSPSolver::BackjumpingMode);
+        settings.setSymmetryMode(symmetry_mode);
+        if (decompose) settings.setDecompositionMode(CSPSolver::ComponentMode);
+        // every run copies settings, hence shares its cache
+        settings.setTranspositionCacheSize(cache_size);
+
+        size_t answers = 0, revisions = 0;
+        std::vector<double> wall_ms;
+        for (int run = 0; run < repeat; run++)
+        {
+            CSPSolver solver = settings;
+            // the copy handed to the solver is made outside of the timed section
+            CSPGraph copy = graph;
+            auto start = std::chrono::steady_clock::now();
+            auto found = (engine == "dfs") ? solver.depthFirstSearchWithPruning(std::move(copy)) 
+                                           : solver.arcConsistency(std::move(copy));
+            auto stop = std::chrono::steady_clock::now();
+            wall_ms.push_back(std::chrono::duration<double, std::milli>(stop - start).count());
+            answers = solver.getSolutionCount();
+            revisions = solver.getRevisionCount();
+        }
+        std::sort(wall_ms.begin(), wall_ms.end());
+        double median_ms = wall_ms[wall_ms.size() / 2];
+        double rev_per_s = (median_ms > 0) ? revisions / (median_ms / 1000.0) : 0;
+
+        std::string answers_column = std::to_string(answers) + (instance.needs_answer_limit ? "+" : "");
+        std::printf("%-16s %6u %6u %8s %12zu %10.2f %12.0f %12ld\n", 
+                    instance.name.c_str(), graph.num_variables(), graph.num_constraints(), 
+                    answers_column.c_str(), revisions, median_ms, rev_per_s, peakRssKb());
+    }
+    return 0;
+};
@@ -2,12 +2,17 @@
 // Description: Defines a struct ARC holding data of an arc in the CSP Graph.
 //  An ARC holds: 1) the main variable, 2) other variables linked to 1, and 
 //  3) a constraint which links variables in 1 and 2.
+//  Arcs built from a frozen CSPGraph also carry the id of the arc, which
+//  identifies them in O(1) without looking at any name.
 
 #ifndef ARC_H
 #define ARC_H
 
 #include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <set>
+#include <string>
 #include <vector>
 
 #include "src/graphImplementation/vertices/ConstraintVertex.h"
@@ -19,15 +24,21 @@ namespace CSPSolverImplementation
     // a struct indicating an arc to be checked in arc consistency
     struct ARC
     {
+        // id of arcs which weren't built from a frozen CSPGraph
+        static const uint32_t NO_ARC_ID = UINT32_MAX;
+
         GraphImplementation::VariableVertex* main_var;
         std::vector<GraphImplementation::VariableVertex*> other_var_list; 
         GraphImplementation::ConstraintVertex* constraint;
+        // id of this arc in the frozen CSPGraph it was built from, see CSPGraph::arc_id
+        uint32_t arc_id;
 
         ARC() 
         {
             this->main_var = nullptr;
             this->other_var_list = std::vector<GraphImplementation::VariableVertex*>();
             this->constraint = nullptr;
+            this->arc_id = NO_ARC_ID;
         };
 
         std::string generate_unique_string()
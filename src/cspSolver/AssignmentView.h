@@ -0,0 +1,60 @@
+// Author: Akira Kudo
+// Description: Defines a lightweight view over one answer found by the CSPSolver.
+//  The view doesn't own anything: it points at the frozen CSPGraph being searched
+//  and at the value assigned to each of its variables, numbered by variable id.
+//  It is only valid for the duration of the visitor call it is handed to;
+//  call toVariables to keep a copy of the answer around.
+
+#ifndef ASSIGNMENTVIEW_H
+#define ASSIGNMENTVIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#include "src/cspSolver/CSPGraph.h"
+#include "src/graphImplementation/vertices/VariableVertex.h"
+
+namespace CSPSolverImplementation
+{
+    class AssignmentView
+    {
+    public:
+        AssignmentView(const CSPGraph& graph, const int* values, size_t multiplicity=1)
+            : graph(&graph), values(values), answer_multiplicity(multiplicity) {};
+
+        // number of variables in the answer
+        uint32_t size() const { return this->graph->num_variables(); };
+        // value assigned to the variable with given id
+        int valueAt(uint32_t vv_id) const { return this->values[vv_id]; };
+        // number of answers this one stands for, itself included; only above 1 for answers
+        // reported in CSPSolver::CanonicalMode, where answers symmetric to it aren't reported
+        size_t multiplicity() const { return this->answer_multiplicity; };
+        // name of the variable with given id
+        const std::string& nameAt(uint32_t vv_id) const
+        {
+            return this->graph->variable_at(vv_id)->getNameReference();
+        };
+
+        // copies the answer in the format returned by CSPSolver::arcConsistency,
+        // as one variable vertex with a single domain value per variable
+        std::vector<GraphImplementation::VariableVertex> toVariables() const
+        {
+            std::vector<GraphImplementation::VariableVertex> returned;
+            returned.reserve(size());
+            for (uint32_t vv_id = 0; vv_id < size(); vv_id++)
+                returned.emplace_back(nameAt(vv_id), std::initializer_list<int>{ valueAt(vv_id) },
+                                      this->graph->get_domain_mode());
+            return returned;
+        };
+
+    private:
+        const CSPGraph* graph;
+        const int* values;
+        size_t answer_multiplicity;
+    };
+}
+
+#endif
@@ -1,26 +1,42 @@
 // Author: Akira Kudo
 
+#include <algorithm>
+#include <cstdint>
 #include <initializer_list>
+#include <map>
 #include <memory>
 #include <tuple>
 #include <set>
+#include <utility>
 #include <string>
 #include <vector>
 
 #include <iostream>
 
 #include "src/cspSolver/CSPGraph.h"
+#include "src/graphImplementation/vertices/ConstraintKernel.h"
 #include "src/graphImplementation/vertices/ConstraintVertex.h"
 #include "src/graphImplementation/vertices/VariableVertex.h"
 
 using GraphImplementation::ConstraintVertex, GraphImplementation::VariableVertex;
 
 CSPSolverImplementation::CSPGraph::CSPGraph()
+    : domain_mode(GraphImplementation::Domain::BitsetMode), frozen(false)
 {
     
 }
 
+CSPSolverImplementation::CSPGraph::CSPGraph(GraphImplementation::Domain::DomainMode domain_mode)
+    : domain_mode(domain_mode), frozen(false)
+{
+
+}
+
 CSPSolverImplementation::CSPGraph::CSPGraph(const CSPGraph& other)
+    : domain_mode(other.domain_mode), 
+      vv_names_in_order(other.vv_names_in_order), 
+      cv_names_in_order(other.cv_names_in_order),
+      frozen(false)
 { 
     // copy vv_map & cv_map, hence keeping data for both cvs and vvs
     this->vv_map = other.vv_map;
@@ -30,22 +46,109 @@ CSPSolverImplementation::CSPGraph::CSPGraph(const CSPGraph& other)
     for (auto& vv_pair : this->vv_map) this->add_vertex(vv_pair.second);
     for (auto& cv_pair : this->cv_map) this->add_vertex(cv_pair.second);
 
-    // for each vv-adjacencyList pair in other.adjList
-    for (auto vv_adjacency_list_pair : other.adjList)
+    // adjacency lists are rebuilt in the exact same order as in other, such that
+    // neighbors (and hence ids of arcs) come out identical in both graphs
+    if (other.frozen)
     {
-        // go through the list, getting adjacent cvs to first of vv_adjacency_list_pair
-        for (auto cv : vv_adjacency_list_pair.second)
+        // copied vertices keep their ids, so the frozen view can be rebuilt without any name lookup
+        this->variables_by_id.resize(other.variables_by_id.size());
+        this->constraints_by_id.resize(other.constraints_by_id.size());
+        for (auto& vv_pair : this->vv_map) this->variables_by_id[vv_pair.second.getId()] = &vv_pair.second;
+        for (auto& cv_pair : this->cv_map) this->constraints_by_id[cv_pair.second.getId()] = &cv_pair.second;
+        this->var_constraint_offsets = other.var_constraint_offsets;
+        this->var_constraint_ids = other.var_constraint_ids;
+        this->scope_offsets = other.scope_offsets;
+        this->scope_var_ids = other.scope_var_ids;
+        this->arc_constraint_ids = other.arc_constraint_ids;
+        this->requeue_arcs = other.requeue_arcs;
+
+        for (uint32_t vv_id = 0; vv_id < this->num_variables(); vv_id++)
+        {
+            auto& adjacency_list = this->adjList[this->variables_by_id[vv_id]];
+            for (uint32_t cv_id : this->constraint_neighbor_ids(vv_id)) 
+                adjacency_list.push_back(this->constraints_by_id[cv_id]);
+        }
+        for (uint32_t cv_id = 0; cv_id < this->num_constraints(); cv_id++)
         {
-            // add corresponding edges to the graph
-            this->add_edge(vv_adjacency_list_pair.first->getName(), cv->getName());
+            auto& adjacency_list = this->adjList[this->constraints_by_id[cv_id]];
+            for (uint32_t vv_id : this->variable_neighbor_ids(cv_id)) 
+                adjacency_list.push_back(this->variables_by_id[vv_id]);
         }
-        // checking for adjacency on all variables is enough, as 
-        // constraints are only adjacent to variables in a CSPGraph
+        this->frozen = true;
+        return;
     }
+
+    // otherwise, find the vertices corresponding to other's by name
+    auto vertex_with_name = [this](const std::string& name) -> GraphImplementation::Vertex*
+    {
+        auto position_in_vv_map = this->vv_map.find(name);
+        if (position_in_vv_map != this->vv_map.end()) return &(position_in_vv_map->second);
+        return &(this->cv_map.at(name));
+    };
+    for (auto& vertex_adjacency_list_pair : other.adjList)
+    {
+        auto& adjacency_list = this->adjList[vertex_with_name(vertex_adjacency_list_pair.first->getNameReference())];
+        for (auto neighbor : vertex_adjacency_list_pair.second)
+            adjacency_list.push_back(vertex_with_name(neighbor->getNameReference()));
+    }
+}
+
+// copy-and-swap, so that the adjacency list always points into our own maps
+CSPSolverImplementation::CSPGraph& CSPSolverImplementation::CSPGraph::operator=(CSPGraph other)
+{
+    swap_contents(other);
+    return *this;
 }
 
+// numbers variables & constraints densely in the order they were added, and
+// stores the adjacency as flat arrays of ids; does nothing if already frozen
+void CSPSolverImplementation::CSPGraph::freeze()
+{
+    if (frozen) return;
+
+    variables_by_id.clear();
+    constraints_by_id.clear();
+    for (auto& vv_name : vv_names_in_order)
+    {
+        VariableVertex* vv = &vv_map.at(vv_name);
+        vv->setId((uint32_t) variables_by_id.size());
+        variables_by_id.push_back(vv);
+    }
+    for (auto& cv_name : cv_names_in_order)
+    {
+        ConstraintVertex* cv = &cv_map.at(cv_name);
+        cv->setId((uint32_t) constraints_by_id.size());
+        constraints_by_id.push_back(cv);
+    }
+
+    // variable -> constraints adjacency
+    var_constraint_offsets.assign(1, 0);
+    var_constraint_ids.clear();
+    for (VariableVertex* vv : variables_by_id)
+    {
+        for (auto neighbor : adjList.at(vv)) var_constraint_ids.push_back(neighbor->getId());
+        var_constraint_offsets.push_back((uint32_t) var_constraint_ids.size());
+    }
+    // constraint -> variables adjacency, which also numbers arcs
+    scope_offsets.assign(1, 0);
+    scope_var_ids.clear();
+    arc_constraint_ids.clear();
+    for (ConstraintVertex* cv : constraints_by_id)
+    {
+        for (auto neighbor : adjList.at(cv)) 
+        {
+            scope_var_ids.push_back(neighbor->getId());
+            arc_constraint_ids.push_back(cv->getId());
+        }
+        scope_offsets.push_back((uint32_t) scope_var_ids.size());
+    }
+    build_requeue_arcs();
+
+    frozen = true;
+};
+
 // returns a pointer to a constraint vertex with the given name, or nullptr if it doesn't exist
-GraphImplementation::ConstraintVertex* CSPSolverImplementation::CSPGraph::get_constraint(std::string name)
+GraphImplementation::ConstraintVertex* CSPSolverImplementation::CSPGraph::get_constraint(const std::string& name)
 {
     auto name_position = cv_map.find(name);
     if (name_position == cv_map.end()) return nullptr;
@@ -56,7 +159,7 @@ GraphImplementation::ConstraintVertex* CSPSolverImplementation::CSPGraph::get_co
 };
 
 // returns a pointer to a variable vertex with the given name, or nullptr if it doesn't exist
-GraphImplementation::VariableVertex* CSPSolverImplementation::CSPGraph::get_variable(std::string name)
+GraphImplementation::VariableVertex* CSPSolverImplementation::CSPGraph::get_variable(const std::string& name)
 {
     auto name_position = vv_map.find(name);
     if (name_position == vv_map.end()) return nullptr;
@@ -68,13 +171,13 @@ GraphImplementation::VariableVertex* CSPSolverImplementation::CSPGraph::get_vari
 };
 
 // returns whether any vertex of given name is in the graph
-bool CSPSolverImplementation::CSPGraph::contains_vertex(std::string name) const
+bool CSPSolverImplementation::CSPGraph::contains_vertex(const std::string& name) const
 {
     return (vv_map.find(name) != vv_map.end() || cv_map.find(name) != cv_map.end());
 };
 
 // return if vertices of given names are adjacent
-bool CSPSolverImplementation::CSPGraph::adjacent(std::string name1, std::string name2)
+bool CSPSolverImplementation::CSPGraph::adjacent(const std::string& name1, const std::string& name2)
 {
     // find both vertices searching in cv_map first
     auto adjacent_pair = find_adjacent_vertex_pair_from_name(name1, name2);
@@ -89,7 +192,7 @@ bool CSPSolverImplementation::CSPGraph::adjacent(std::string name1, std::string
 
 // return all constraint neighbors of a variable vertex with given name
 std::vector<GraphImplementation::ConstraintVertex*> 
-CSPSolverImplementation::CSPGraph::get_constraint_neighbors(std::string name)
+CSPSolverImplementation::CSPGraph::get_constraint_neighbors(const std::string& name)
 {
     // if there's no variable with given name, return an empty vector
     if (vv_map.find(name) == vv_map.end()) return std::vector<GraphImplementation::ConstraintVertex*>();
@@ -107,7 +210,7 @@ CSPSolverImplementation::CSPGraph::get_constraint_neighbors(std::string name)
 
 // return all variable neighbors of a constraint vertex with given name
 std::vector<GraphImplementation::VariableVertex*> 
-CSPSolverImplementation::CSPGraph::get_variable_neighbors(std::string name)
+CSPSolverImplementation::CSPGraph::get_variable_neighbors(const std::string& name)
 {
     // if there's no constraint with given name, return an empty vector
     if (cv_map.find(name) == cv_map.end()) return std::vector<GraphImplementation::VariableVertex*>();
@@ -123,23 +226,25 @@ CSPSolverImplementation::CSPGraph::get_variable_neighbors(std::string name)
     return returned;
 };
         
-// adds a constraint vertex with given name and predicate to the graph
+// adds a constraint vertex with given name and kernel (or any predicate) to the graph
 // * Inserting vertex with existing name doesn't do anything,
 //   even when the older one was a VariableVertex
 void CSPSolverImplementation::CSPGraph::add_constraint(
     std::string name, 
-    std::function<bool(int, std::vector<GraphImplementation::VariableVertex*>)> pred,
+    GraphImplementation::ConstraintKernel kernel,
     std::string description)
 {
     // first check for any existing vertex with the same name, and if there is, do nothing
     if (contains_vertex(name)) return;
     // otherwise, create the new constraint vertex
-    ConstraintVertex new_cv = ConstraintVertex(name, pred, description);
+    ConstraintVertex new_cv = ConstraintVertex(name, std::move(kernel), description);
     // copy the resulting object into the cv_map first
     cv_map.emplace(name, new_cv);
     // then access that object's reference, adding it to the Graph to be controlled
     auto& cv_reference = cv_map.at(name);
     this->Graph::add_vertex(cv_reference);
+    cv_names_in_order.push_back(name);
+    unfreeze();
 };
 
 // adds a variable vertex with given name and domain to the graph
@@ -154,12 +259,35 @@ void CSPSolverImplementation::CSPGraph::add_variable(std::string name, std::set<
     // first check for any existing vertex with the same name, and if there is, do nothing
     if (contains_vertex(name)) return;
     // otherwise, create the new variable vertex
-    VariableVertex new_vv = VariableVertex(name, std::move(domain));
+    VariableVertex new_vv = VariableVertex(name, std::move(domain), domain_mode);
     // copy the resulting object into the vv_map first
     vv_map.emplace(name, new_vv);
     // then access that object's reference, adding it to the Graph to be controlled
     auto& vv_reference = vv_map.at(name);
     this->Graph::add_vertex(vv_reference);
+    vv_names_in_order.push_back(name);
+    unfreeze();
+};
+
+// domain is converted to the domain backend of this graph if needed
+void CSPSolverImplementation::CSPGraph::add_variable(std::string name, const GraphImplementation::Domain& domain)
+{
+    if (contains_vertex(name)) return;
+    if (domain.getMode() == domain_mode) vv_map.emplace(name, VariableVertex(name, domain));
+    else vv_map.emplace(name, VariableVertex(name, domain.toSet(), domain_mode));
+    this->Graph::add_vertex(vv_map.at(name));
+    vv_names_in_order.push_back(std::move(name));
+    unfreeze();
+};
+
+// reserves room for the given number of variables & constraints, for graphs built in bulk
+void CSPSolverImplementation::CSPGraph::reserve(size_t num_variables, size_t num_constraints)
+{
+    vv_map.reserve(num_variables);
+    cv_map.reserve(num_constraints);
+    vv_names_in_order.reserve(num_variables);
+    cv_names_in_order.reserve(num_constraints);
+    adjList.reserve(num_variables + num_constraints);
 };
 
 // removes vertex with given name if there, as well as edges connected to it
@@ -180,17 +308,20 @@ void CSPSolverImplementation::CSPGraph::remove_vertex(std::string name) {
         this->Graph::remove_vertex(cv_to_remove);
         // then from cv_map
         cv_map.erase(name);
+        cv_names_in_order.erase(std::find(cv_names_in_order.begin(), cv_names_in_order.end(), name));
     } else { //otherwise, we've found the vertex in vv_map
         // remove our VariableVertex of interest from Graph
         auto& vv_to_remove = position_in_vv_map->second;
         this->Graph::remove_vertex(vv_to_remove);
         // then from vv_map
         vv_map.erase(name);
+        vv_names_in_order.erase(std::find(vv_names_in_order.begin(), vv_names_in_order.end(), name));
     }
+    unfreeze();
 };
 
 // adds edge between given variable vertex and constraint vertex identified by name, if not there
-void CSPSolverImplementation::CSPGraph::add_edge(std::string vv_name, std::string cv_name) {
+void CSPSolverImplementation::CSPGraph::add_edge(const std::string& vv_name, const std::string& cv_name) {
     // we first obtain if this is a pair of constraint and vertex
     // vertices are adjacent as such in a CSP Graph
     auto adjacent_pair = find_adjacent_vertex_pair_from_name(vv_name, cv_name);
@@ -202,10 +333,11 @@ void CSPSolverImplementation::CSPGraph::add_edge(std::string vv_name, std::strin
     ConstraintVertex& cv = cv_map.at(std::get<1>(adjacent_pair));
     // add edge using Graph functionality
     this->Graph::add_edge(vv, cv, {});
+    unfreeze();
 };
 
 // removes edge between given variable vertex and constraint vertex identified by name, if there
-void CSPSolverImplementation::CSPGraph::remove_edge(std::string vv_name, std::string cv_name) {
+void CSPSolverImplementation::CSPGraph::remove_edge(const std::string& vv_name, const std::string& cv_name) {
     // first check if given names are a valid vertex-constraint pair
     auto adjacent_pair = find_adjacent_vertex_pair_from_name(vv_name, cv_name);
     // if it isn't a valid pair or we didn't find vertices, do nothing
@@ -216,15 +348,316 @@ void CSPSolverImplementation::CSPGraph::remove_edge(std::string vv_name, std::st
     ConstraintVertex& cv = cv_map.at(std::get<1>(adjacent_pair));
     // remove edge using Graph functionality
     this->Graph::remove_edge(vv, cv);
+    unfreeze();
 }; 
 
+// replaces every group of two or more cardinality constraints (exactlyN & friends) over the same 
+// variables by a single global cardinality constraint bounding each of their values, which takes 
+// the name of the first constraint of the group; returns the number of constraints created
+size_t CSPSolverImplementation::CSPGraph::fuse_cardinality_constraints()
+{
+    using GraphImplementation::ConstraintKernel;
+    freeze();
+    // constraints grouped by the sorted ids of their variables, groups coming in order of their first constraint
+    std::map<std::vector<uint32_t>, size_t> group_of_scope;
+    std::vector<std::vector<uint32_t>> groups;
+    for (uint32_t cv_id = 0; cv_id < num_constraints(); cv_id++)
+    {
+        ConstraintKernel::KernelType type = constraint_at(cv_id)->getKernel().getType();
+        if (type != ConstraintKernel::LesserOrEqualToN && type != ConstraintKernel::GreaterOrEqualToN && 
+            type != ConstraintKernel::ExactlyN) continue;
+        IdSpan scope = variable_neighbor_ids(cv_id);
+        if (scope.size() == 0) continue;
+        std::vector<uint32_t> sorted_scope(scope.begin(), scope.end());
+        std::sort(sorted_scope.begin(), sorted_scope.end());
+        auto inserted = group_of_scope.emplace(std::move(sorted_scope), groups.size());
+        if (inserted.second) groups.emplace_back();
+        groups[inserted.first->second].push_back(cv_id);
+    }
+
+    // names are gathered first, as ids change once the graph is modified
+    struct Fusion
+    {
+        std::vector<std::string> cv_names;
+        std::vector<std::string> vv_names;
+        std::vector<ConstraintKernel::CardinalityBound> bounds;
+    };
+    std::vector<Fusion> fusions;
+    for (const std::vector<uint32_t>& group : groups)
+    {
+        if (group.size() < 2) continue;
+        Fusion fusion;
+        for (uint32_t vv_id : variable_neighbor_ids(group.front())) fusion.vv_names.push_back(variable_at(vv_id)->getName());
+        int scope_size = (int) fusion.vv_names.size();
+        for (uint32_t cv_id : group)
+        {
+            const ConstraintKernel& kernel = constraint_at(cv_id)->getKernel();
+            int value = kernel.getCheckedValue(), n = kernel.getN();
+            if (kernel.getType() == ConstraintKernel::LesserOrEqualToN) fusion.bounds.push_back({ value, 0, n });
+            else if (kernel.getType() == ConstraintKernel::GreaterOrEqualToN) fusion.bounds.push_back({ value, n, scope_size });
+            else fusion.bounds.push_back({ value, n, n });
+            fusion.cv_names.push_back(constraint_at(cv_id)->getName());
+        }
+        fusions.push_back(std::move(fusion));
+    }
+
+    for (Fusion& fusion : fusions)
+    {
+        std::string description = "Fuses";
+        for (const std::string& cv_name : fusion.cv_names) 
+        {
+            description += " " + cv_name;
+            remove_vertex(cv_name);
+        }
+        add_constraint(fusion.cv_names.front(), ConstraintKernel::globalCardinality(std::move(fusion.bounds)), description);
+        for (const std::string& vv_name : fusion.vv_names) add_edge(vv_name, fusion.cv_names.front());
+    }
+    return fusions.size();
+};
+
+// ids of the variables of each connected component, variables being connected through the 
+// constraints they share; components come in the order of their smallest id, each sorted by id
+std::vector<std::vector<uint32_t>> CSPSolverImplementation::CSPGraph::connected_components() const
+{
+    std::vector<std::vector<uint32_t>> returned;
+    std::vector<bool> reached_variables(num_variables(), false), reached_constraints(num_constraints(), false);
+    for (uint32_t first_id = 0; first_id < num_variables(); first_id++)
+    {
+        if (reached_variables[first_id]) continue;
+        reached_variables[first_id] = true;
+        std::vector<uint32_t> component = { first_id };
+        // the component grows as its variables are gone through, each constraint being crossed once
+        for (size_t i = 0; i < component.size(); i++)
+            for (uint32_t cv_id : constraint_neighbor_ids(component[i]))
+            {
+                if (reached_constraints[cv_id]) continue;
+                reached_constraints[cv_id] = true;
+                for (uint32_t vv_id : variable_neighbor_ids(cv_id))
+                {
+                    if (reached_variables[vv_id]) continue;
+                    reached_variables[vv_id] = true;
+                    component.push_back(vv_id);
+                }
+            }
+        std::sort(component.begin(), component.end());
+        returned.push_back(std::move(component));
+    }
+    return returned;
+};
+
+// graph holding copies of the variables of given distinct ids, numbered in the given order, along 
+// with the constraints whose scope is non-empty & among them, and their edges; comes out frozen
+CSPSolverImplementation::CSPGraph CSPSolverImplementation::CSPGraph::induced_subgraph(const std::vector<uint32_t>& vv_ids) const
+{
+    // id of each variable kept within the subgraph, by its id here
+    std::vector<uint32_t> kept_ids(num_variables(), UINT32_MAX);
+    std::vector<VariableVertex> variables;
+    variables.reserve(vv_ids.size());
+    for (uint32_t i = 0; i < vv_ids.size(); i++)
+    {
+        kept_ids[vv_ids[i]] = i;
+        variables.push_back(*variable_at(vv_ids[i]));
+    }
+
+    std::vector<ConstraintVertex> constraints;
+    std::vector<uint32_t> scope_offsets = { 0 }, scope_var_ids;
+    std::vector<std::vector<uint32_t>> constraints_of(vv_ids.size());
+    for (uint32_t cv_id = 0; cv_id < num_constraints(); cv_id++)
+    {
+        IdSpan scope = variable_neighbor_ids(cv_id);
+        if (scope.size() == 0 || 
+            std::any_of(scope.begin(), scope.end(), [&kept_ids](uint32_t vv_id) { return kept_ids[vv_id] == UINT32_MAX; }))
+            continue;
+        // scopes keep their order, which custom predicates may rely on
+        for (uint32_t vv_id : scope)
+        {
+            scope_var_ids.push_back(kept_ids[vv_id]);
+            constraints_of[kept_ids[vv_id]].push_back((uint32_t) constraints.size());
+        }
+        scope_offsets.push_back((uint32_t) scope_var_ids.size());
+        constraints.push_back(*constraint_at(cv_id));
+    }
+    std::vector<uint32_t> var_constraint_offsets = { 0 }, var_constraint_ids;
+    for (const std::vector<uint32_t>& constraint_ids : constraints_of)
+    {
+        var_constraint_ids.insert(var_constraint_ids.end(), constraint_ids.begin(), constraint_ids.end());
+        var_constraint_offsets.push_back((uint32_t) var_constraint_ids.size());
+    }
+
+    CSPGraph returned = CSPGraph(domain_mode);
+    returned.build_frozen(std::move(variables), std::move(constraints), std::move(var_constraint_offsets), 
+                          std::move(var_constraint_ids), std::move(scope_offsets), std::move(scope_var_ids));
+    return returned;
+};
+
 
 // ###################
 // PRIVATE FUNCTIONS
+// drops the frozen view after a structural change
+void CSPSolverImplementation::CSPGraph::unfreeze()
+{
+    if (!frozen) return;
+    frozen = false;
+    variables_by_id.clear();
+    constraints_by_id.clear();
+    var_constraint_offsets.clear();
+    var_constraint_ids.clear();
+    scope_offsets.clear();
+    scope_var_ids.clear();
+    arc_constraint_ids.clear();
+    requeue_arcs.reset();
+};
+
+// fills an empty graph with given vertices, numbered in order, and the adjacency of 
+// the frozen view, which is taken as is; leaves the graph frozen
+// returns false (leaving the graph empty) if names repeat, ids are out of range or repeat within
+// a list, or if both halves of the adjacency don't mirror each other
+bool CSPSolverImplementation::CSPGraph::build_frozen(
+    std::vector<VariableVertex> variables, std::vector<ConstraintVertex> constraints,
+    std::vector<uint32_t> var_constraint_offsets, std::vector<uint32_t> var_constraint_ids,
+    std::vector<uint32_t> scope_offsets, std::vector<uint32_t> scope_var_ids)
+{
+    uint32_t num_vv = (uint32_t) variables.size(), num_cv = (uint32_t) constraints.size();
+    // check the adjacency is well formed before touching anything
+    auto offsets_are_valid = [] (const std::vector<uint32_t>& offsets, uint32_t count, 
+                                 const std::vector<uint32_t>& ids, uint32_t id_bound)
+    {
+        if (offsets.size() != count + 1 || offsets.front() != 0 || offsets.back() != ids.size()) return false;
+        for (uint32_t i = 0; i < count; i++) if (offsets[i] > offsets[i + 1]) return false;
+        for (uint32_t id : ids) if (id >= id_bound) return false;
+        return true;
+    };
+    // no list may name the same vertex twice
+    auto has_duplicates = [] (const std::vector<uint32_t>& offsets, const std::vector<uint32_t>& ids, uint32_t id_bound)
+    {
+        std::vector<uint32_t> last_listed_by(id_bound, UINT32_MAX);
+        for (uint32_t owner = 0; owner + 1 < offsets.size(); owner++)
+        {
+            for (uint32_t i = offsets[owner]; i < offsets[owner + 1]; i++)
+            {
+                if (last_listed_by[ids[i]] == owner) return true;
+                last_listed_by[ids[i]] = owner;
+            }
+        }
+        return false;
+    };
+    if (!offsets_are_valid(var_constraint_offsets, num_vv, var_constraint_ids, num_cv) ||
+        !offsets_are_valid(scope_offsets, num_cv, scope_var_ids, num_vv) ||
+        var_constraint_ids.size() != scope_var_ids.size() ||
+        has_duplicates(var_constraint_offsets, var_constraint_ids, num_cv) ||
+        has_duplicates(scope_offsets, scope_var_ids, num_vv))
+        return false;
+    // both halves have to hold the same arcs: the scopes are regrouped per variable, then every
+    // variable has to list exactly the constraints whose scope holds it
+    std::vector<uint32_t> regrouped_offsets(num_vv + 1, 0);
+    for (uint32_t vv_id : scope_var_ids) regrouped_offsets[vv_id + 1]++;
+    for (uint32_t vv_id = 0; vv_id < num_vv; vv_id++)
+    {
+        regrouped_offsets[vv_id + 1] += regrouped_offsets[vv_id];
+        if (regrouped_offsets[vv_id + 1] != var_constraint_offsets[vv_id + 1]) return false;
+    }
+    std::vector<uint32_t> regrouped_ids(scope_var_ids.size());
+    std::vector<uint32_t> next_slot(regrouped_offsets.begin(), regrouped_offsets.end() - 1);
+    for (uint32_t cv_id = 0; cv_id < num_cv; cv_id++)
+        for (uint32_t arc = scope_offsets[cv_id]; arc < scope_offsets[cv_id + 1]; arc++)
+            regrouped_ids[next_slot[scope_var_ids[arc]]++] = cv_id;
+    std::vector<uint32_t> listed_by(num_cv, UINT32_MAX);
+    for (uint32_t vv_id = 0; vv_id < num_vv; vv_id++)
+    {
+        for (uint32_t i = var_constraint_offsets[vv_id]; i < var_constraint_offsets[vv_id + 1]; i++)
+            listed_by[var_constraint_ids[i]] = vv_id;
+        for (uint32_t i = regrouped_offsets[vv_id]; i < regrouped_offsets[vv_id + 1]; i++)
+            if (listed_by[regrouped_ids[i]] != vv_id) return false;
+    }
+
+    *this = CSPGraph(domain_mode);
+    for (VariableVertex& vv : variables)
+    {
+        std::string name = vv.getName();
+        if (contains_vertex(name)) { *this = CSPGraph(domain_mode); return false; }
+        VariableVertex& vv_reference = vv_map.emplace(name, std::move(vv)).first->second;
+        vv_reference.setId((uint32_t) variables_by_id.size());
+        variables_by_id.push_back(&vv_reference);
+        this->Graph::add_vertex(vv_reference);
+        vv_names_in_order.push_back(std::move(name));
+    }
+    for (ConstraintVertex& cv : constraints)
+    {
+        std::string name = cv.getName();
+        if (contains_vertex(name)) { *this = CSPGraph(domain_mode); return false; }
+        ConstraintVertex& cv_reference = cv_map.emplace(name, std::move(cv)).first->second;
+        cv_reference.setId((uint32_t) constraints_by_id.size());
+        constraints_by_id.push_back(&cv_reference);
+        this->Graph::add_vertex(cv_reference);
+        cv_names_in_order.push_back(std::move(name));
+    }
+
+    this->var_constraint_offsets = std::move(var_constraint_offsets);
+    this->var_constraint_ids = std::move(var_constraint_ids);
+    this->scope_offsets = std::move(scope_offsets);
+    this->scope_var_ids = std::move(scope_var_ids);
+    arc_constraint_ids.resize(this->scope_var_ids.size());
+    for (uint32_t cv_id = 0; cv_id < num_cv; cv_id++)
+        for (uint32_t arc = this->scope_offsets[cv_id]; arc < this->scope_offsets[cv_id + 1]; arc++)
+            arc_constraint_ids[arc] = cv_id;
+    build_requeue_arcs();
+
+    // the adjacency list follows the frozen view, as when copying a frozen graph
+    for (uint32_t vv_id = 0; vv_id < num_vv; vv_id++)
+    {
+        auto& adjacency_list = adjList[variables_by_id[vv_id]];
+        for (uint32_t cv_id : constraint_neighbor_ids(vv_id)) adjacency_list.push_back(constraints_by_id[cv_id]);
+    }
+    for (uint32_t cv_id = 0; cv_id < num_cv; cv_id++)
+    {
+        auto& adjacency_list = adjList[constraints_by_id[cv_id]];
+        for (uint32_t vv_id : variable_neighbor_ids(cv_id)) adjacency_list.push_back(variables_by_id[vv_id]);
+    }
+    frozen = true;
+    return true;
+};
+
+// exchanges every content with other, vertex addresses being kept
+// (swapping unordered_maps doesn't move their elements in memory)
+void CSPSolverImplementation::CSPGraph::swap_contents(CSPGraph& other)
+{
+    std::swap(this->adjList, other.adjList);
+    std::swap(this->vv_map, other.vv_map);
+    std::swap(this->cv_map, other.cv_map);
+    std::swap(this->domain_mode, other.domain_mode);
+    std::swap(this->vv_names_in_order, other.vv_names_in_order);
+    std::swap(this->cv_names_in_order, other.cv_names_in_order);
+    std::swap(this->frozen, other.frozen);
+    std::swap(this->variables_by_id, other.variables_by_id);
+    std::swap(this->constraints_by_id, other.constraints_by_id);
+    std::swap(this->var_constraint_offsets, other.var_constraint_offsets);
+    std::swap(this->var_constraint_ids, other.var_constraint_ids);
+    std::swap(this->scope_offsets, other.scope_offsets);
+    std::swap(this->scope_var_ids, other.scope_var_ids);
+    std::swap(this->arc_constraint_ids, other.arc_constraint_ids);
+    std::swap(this->requeue_arcs, other.requeue_arcs);
+};
+
+// lists the arcs to revise again once the domain of each variable shrank, from the adjacency
+// of the frozen view: every arc of each constraint around it whose main variable is another one
+void CSPSolverImplementation::CSPGraph::build_requeue_arcs()
+{
+    std::shared_ptr<RequeueArcs> built = std::make_shared<RequeueArcs>();
+    built->offsets.push_back(0);
+    for (uint32_t vv_id = 0; vv_id < num_variables(); vv_id++)
+    {
+        for (uint32_t cv_id : constraint_neighbor_ids(vv_id))
+            for (uint32_t arc = scope_offsets[cv_id]; arc < scope_offsets[cv_id + 1]; arc++)
+                if (scope_var_ids[arc] != vv_id) built->arc_ids.push_back(arc);
+        built->offsets.push_back((uint32_t) built->arc_ids.size());
+    }
+    requeue_arcs = std::move(built);
+};
+
 // given two names assumed adjacent vertices, return a tuple:
 // <name of variable, name of constraint, if such pair was found>
 std::tuple<std::string, std::string, bool> 
-CSPSolverImplementation::CSPGraph::find_adjacent_vertex_pair_from_name(std::string name1, std::string name2) const
+CSPSolverImplementation::CSPGraph::find_adjacent_vertex_pair_from_name(const std::string& name1, const std::string& name2) const
 {
     std::string vv_name = "";
     std::string cv_name = "";
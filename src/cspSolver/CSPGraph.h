@@ -2,27 +2,54 @@
 // Description: Implements a CSP Graph object which inherits from Graph.
 //  Allows the creation of a graph by giving variable names & domains, 
 //  and edges by giving varaible names.
+//  Once built, a graph can be frozen into an index-based view where variables
+//  and constraints get dense uint32_t ids & adjacency is stored as flat arrays;
+//  the solver works on those ids only, names being kept for I/O and printing.
+//  The frozen view also lists, for each variable, the arcs to revise again once its
+//  domain shrank, so that re-queueing them is a single pass over a flat array.
 
 #ifndef CSPGRAPH_H
 #define CSPGRAPH_H
 
+#include <cstdint>
 #include <functional>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <string>
 #include <tuple>
 #include <vector>
 
+#include "src/graphImplementation/domains/Domain.h"
 #include "src/graphImplementation/Graph.h"
+#include "src/graphImplementation/vertices/ConstraintKernel.h"
 #include "src/graphImplementation/vertices/ConstraintVertex.h"
 #include "src/graphImplementation/vertices/VariableVertex.h"
 #include "src/graphImplementation/vertices/Vertex.h"
 
 namespace CSPSolverImplementation
 {
+    // a contiguous run of ids held by the frozen view of a CSPGraph
+    struct IdSpan
+    {
+        const uint32_t* first;
+        const uint32_t* last;
+
+        const uint32_t* begin() const { return first; };
+        const uint32_t* end() const { return last; };
+        uint32_t size() const { return (uint32_t) (last - first); };
+        uint32_t operator[](uint32_t i) const { return first[i]; };
+    };
+
+    // forward declaration for befriending
+    class CSPGraphSerializer;
+
     class CSPGraph : private GraphImplementation::Graph
     {
     private:
+        // the serializer builds loaded graphs directly from their frozen view
+        friend class CSPSolverImplementation::CSPGraphSerializer;
+
         // maps each variable vertex by their unique names
         // * Inserting vertex with existing name doesn't do anything,
         //   even when the older one was a ConstraintVertex
@@ -31,61 +58,159 @@ namespace CSPSolverImplementation
         // * Inserting vertex with existing name doesn't do anything,
         //   even when the older one was a VariableVertex
         std::unordered_map<std::string, GraphImplementation::ConstraintVertex> cv_map;
+        // backend used for the domains of variables added to this graph
+        GraphImplementation::Domain::DomainMode domain_mode;
+        // names of variables / constraints in the order they were added;
+        // ids of the frozen view follow this order
+        std::vector<std::string> vv_names_in_order;
+        std::vector<std::string> cv_names_in_order;
+
+        // ##### frozen view - only valid while frozen is true #####
+        // any change to the structure of the graph unfreezes it
+        bool frozen;
+        std::vector<GraphImplementation::VariableVertex*> variables_by_id;
+        std::vector<GraphImplementation::ConstraintVertex*> constraints_by_id;
+        // constraint ids around variable v are found in
+        // var_constraint_ids[var_constraint_offsets[v] .. var_constraint_offsets[v+1])
+        std::vector<uint32_t> var_constraint_offsets;
+        std::vector<uint32_t> var_constraint_ids;
+        // variable ids in the scope of constraint c are found in
+        // scope_var_ids[scope_offsets[c] .. scope_offsets[c+1]), in the order of get_variable_neighbors.
+        // An arc (c, main variable) is identified by the index of its main variable in scope_var_ids
+        std::vector<uint32_t> scope_offsets;
+        std::vector<uint32_t> scope_var_ids;
+        // constraint id of each arc
+        std::vector<uint32_t> arc_constraint_ids;
+        // ids of the arcs to revise again once the domain of variable v shrank are found in
+        // arc_ids[offsets[v] .. offsets[v+1]), grouped by constraint in the order of 
+        // constraint_neighbor_ids; constraints over v alone bring no arc
+        struct RequeueArcs
+        {
+            std::vector<uint32_t> offsets;
+            std::vector<uint32_t> arc_ids;
+        };
+        // never changed once built, hence shared by the copies of a frozen graph rather than copied
+        std::shared_ptr<const RequeueArcs> requeue_arcs;
+
+        // drops the frozen view after a structural change
+        void unfreeze();
+        // lists the arcs to revise again once the domain of each variable shrank, from the adjacency
+        // of the frozen view: every arc of each constraint around it whose main variable is another one
+        void build_requeue_arcs();
+        // exchanges every content with other, vertex addresses being kept
+        void swap_contents(CSPGraph& other);
+        // fills an empty graph with given vertices, numbered in order, and the adjacency of 
+        // the frozen view, which is taken as is; leaves the graph frozen
+        // returns false (leaving the graph empty) if names repeat, ids are out of range or repeat within
+        // a list, or if both halves of the adjacency don't mirror each other
+        bool build_frozen(std::vector<GraphImplementation::VariableVertex> variables, 
+                          std::vector<GraphImplementation::ConstraintVertex> constraints,
+                          std::vector<uint32_t> var_constraint_offsets, std::vector<uint32_t> var_constraint_ids,
+                          std::vector<uint32_t> scope_offsets, std::vector<uint32_t> scope_var_ids);
 
         // given two names assumed adjacent vertices, return a tuple:
         // <name of variable, name of constraint, if such pair was found>
         std::tuple<std::string, std::string, bool> 
-        find_adjacent_vertex_pair_from_name(std::string name1, std::string name2) const;
+        find_adjacent_vertex_pair_from_name(const std::string& name1, const std::string& name2) const;
         
     public:
         CSPGraph();
+        // domain_mode selects the domain backend of every variable added later on
+        CSPGraph(GraphImplementation::Domain::DomainMode domain_mode);
         CSPGraph(const CSPGraph& other);
+        CSPGraph(CSPGraph&& other) = default;
+        CSPGraph& operator=(CSPGraph other);
 
         // returns a pointer to a constraint vertex with the given name, or nullptr if it doesn't exist
-        GraphImplementation::ConstraintVertex* get_constraint(std::string name);
+        GraphImplementation::ConstraintVertex* get_constraint(const std::string& name);
         // returns a pointer to a variable vertex with the given name, or nullptr if it doesn't exist
-        GraphImplementation::VariableVertex* get_variable(std::string name);
+        GraphImplementation::VariableVertex* get_variable(const std::string& name);
         // returns whether any vertex of given name is in the graph
-        bool contains_vertex(std::string name) const;
+        bool contains_vertex(const std::string& name) const;
         // return if vertices of given names are adjacent
-        bool adjacent(std::string name1, std::string name2);
+        bool adjacent(const std::string& name1, const std::string& name2);
         // return all constraint neighbors of a variable vertex with given name
-        std::vector<GraphImplementation::ConstraintVertex*> get_constraint_neighbors(std::string name);
+        std::vector<GraphImplementation::ConstraintVertex*> get_constraint_neighbors(const std::string& name);
         // return all variable neighbors of a constraint vertex with given name
-        std::vector<GraphImplementation::VariableVertex*> get_variable_neighbors(std::string name);
-        // adds a constraint vertex with given name and predicate to the graph
+        std::vector<GraphImplementation::VariableVertex*> get_variable_neighbors(const std::string& name);
+        // adds a constraint vertex with given name and kernel (or any predicate) to the graph
         // * Inserting vertex with existing name doesn't do anything,
         //   even when the older one was a VariableVertex
         void add_constraint(
             std::string name, 
-            std::function<bool(int, std::vector<GraphImplementation::VariableVertex*>)> pred,
+            GraphImplementation::ConstraintKernel kernel,
             std::string description="This is the default description.");
         // adds a variable vertex with given name and domain to the graph
         // * Inserting vertex with existing name doesn't do anything,
         //   even when the older one was a ConstraintVertex
         void add_variable(std::string name, std::initializer_list<int> domain);
         void add_variable(std::string name, std::set<int> domain);
+        // domain is converted to the domain backend of this graph if needed
+        void add_variable(std::string name, const GraphImplementation::Domain& domain);
+        // reserves room for the given number of variables & constraints, for graphs built in bulk
+        void reserve(size_t num_variables, size_t num_constraints);
         // removes vertex with given name if there, as well as edges connected to it
         void remove_vertex(std::string name);
         // adds edge between given variable vertex and constraint vertex identified by name, if not there
-        void add_edge(std::string vv_name, std::string cv_name);
+        void add_edge(const std::string& vv_name, const std::string& cv_name);
         // removes edge between given variable vertex and constraint vertex identified by name, if there
-        void remove_edge(std::string vv_name, std::string cv_name);
+        void remove_edge(const std::string& vv_name, const std::string& cv_name);
+        // replaces every group of two or more cardinality constraints (exactlyN & friends) over the same 
+        // variables by a single global cardinality constraint bounding each of their values, which takes 
+        // the name of the first constraint of the group; returns the number of constraints created
+        // answers stay the same, but arc consistency then also makes pigeonhole deductions
+        size_t fuse_cardinality_constraints();
 
-        // getters
-        std::vector<std::string> get_all_constraint_names() const
+        // numbers variables & constraints densely in the order they were added, and
+        // stores the adjacency as flat arrays of ids; does nothing if already frozen
+        void freeze();
+        bool is_frozen() const { return this->frozen; };
+
+        // ##### frozen view accessors #####
+        // REQUIRE that the graph is frozen - or do undefined behavior!
+        uint32_t num_variables() const { return (uint32_t) this->variables_by_id.size(); };
+        uint32_t num_constraints() const { return (uint32_t) this->constraints_by_id.size(); };
+        uint32_t num_arcs() const { return (uint32_t) this->scope_var_ids.size(); };
+        GraphImplementation::VariableVertex* variable_at(uint32_t vv_id) const
+        { return this->variables_by_id[vv_id]; };
+        GraphImplementation::ConstraintVertex* constraint_at(uint32_t cv_id) const
+        { return this->constraints_by_id[cv_id]; };
+        // ids of all constraints adjacent to variable vv_id
+        IdSpan constraint_neighbor_ids(uint32_t vv_id) const
         {
-            auto returned = std::vector<std::string>();
-            for (auto kv_pair : cv_map) returned.push_back(kv_pair.first);
-            return returned;
+            const uint32_t* ids = this->var_constraint_ids.data();
+            return IdSpan { ids + var_constraint_offsets[vv_id], ids + var_constraint_offsets[vv_id + 1] };
         };
-
-        std::vector<std::string> get_all_variable_names() const
+        // ids of all variables adjacent to constraint cv_id
+        IdSpan variable_neighbor_ids(uint32_t cv_id) const
         {
-            auto returned = std::vector<std::string>();
-            for (auto kv_pair : vv_map) returned.push_back(kv_pair.first);
-            return returned;
+            const uint32_t* ids = this->scope_var_ids.data();
+            return IdSpan { ids + scope_offsets[cv_id], ids + scope_offsets[cv_id + 1] };
         };
+        // id of the arc whose main variable is the position-th variable neighbor of cv_id
+        uint32_t arc_id(uint32_t cv_id, uint32_t position) const { return this->scope_offsets[cv_id] + position; };
+        uint32_t arc_constraint_id(uint32_t arc) const { return this->arc_constraint_ids[arc]; };
+        uint32_t arc_main_variable_id(uint32_t arc) const { return this->scope_var_ids[arc]; };
+        // ids of the arcs to revise again once the domain of variable vv_id shrank, that is every arc
+        // of each constraint around vv_id whose main variable is another one, grouped by constraint
+        IdSpan requeue_arc_ids_of(uint32_t vv_id) const
+        {
+            const uint32_t* ids = this->requeue_arcs->arc_ids.data();
+            return IdSpan { ids + requeue_arcs->offsets[vv_id], ids + requeue_arcs->offsets[vv_id + 1] };
+        };
+        // ids of the variables of each connected component, variables being connected through the 
+        // constraints they share; components come in the order of their smallest id, each sorted by id
+        std::vector<std::vector<uint32_t>> connected_components() const;
+        // graph holding copies of the variables of given distinct ids, numbered in the given order, along 
+        // with the constraints whose scope is non-empty & among them, and their edges; comes out frozen
+        CSPGraph induced_subgraph(const std::vector<uint32_t>& vv_ids) const;
+
+        // getters
+        GraphImplementation::Domain::DomainMode get_domain_mode() const { return this->domain_mode; };
+
+        // names are returned in the order they were added to the graph
+        std::vector<std::string> get_all_constraint_names() const { return this->cv_names_in_order; };
+        std::vector<std::string> get_all_variable_names() const { return this->vv_names_in_order; };
 
         // overload << operator
         friend std::ostream& operator<<(std::ostream& os, const CSPGraph& g) {
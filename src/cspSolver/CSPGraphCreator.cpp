@@ -160,7 +160,6 @@ void CSPGraphCreator::process(std::string const & line)
         case evAddConstraint:
         {
             std::string cv_name;
-            std::function<bool(int, std::vector<GraphImplementation::VariableVertex*>)> pred;
             std::string description;
 
             int domain_val; int n;
@@ -184,22 +183,21 @@ void CSPGraphCreator::process(std::string const & line)
             cout << "Enter description: " && std::getline(cin, description);
             cout << "Given description was: " << description << "." << endl;
 
+            GraphImplementation::ConstraintKernel kernel = GraphImplementation::ConstraintVertex::exactlyN(domain_val, n);
             switch (choice) {
                 case 1:
-                    pred = GraphImplementation::ConstraintVertex::greaterOrEqualToN(domain_val, n);
+                    kernel = GraphImplementation::ConstraintVertex::greaterOrEqualToN(domain_val, n);
                     break;
                 case 2:
-                    pred = GraphImplementation::ConstraintVertex::lesserOrEqualToN(domain_val, n);
+                    kernel = GraphImplementation::ConstraintVertex::lesserOrEqualToN(domain_val, n);
                     break;
                 case 3:
-                    pred = GraphImplementation::ConstraintVertex::exactlyN(domain_val, n);
                     break;
                 default:
                     cout << "The choice was invalid; defaulting to '='." << endl;
-                    pred = GraphImplementation::ConstraintVertex::exactlyN(domain_val, n);
                     break;
             }
-            returnedGraph.add_constraint(cv_name, pred, description);
+            returnedGraph.add_constraint(cv_name, kernel, description);
             cout << "Successfully added: constraint " << cv_name << " with type "\
                  << ((n==1) ? ">=" : ((n==2) ? "<=" : "=")) << ", checking domain "
                  << domain_val << " for n : " << n  <<"!" << endl;
@@ -1,6 +1,7 @@
 // Author: Akira Kudo
 // Description: A command line user interface implemented using the standard library.
 //  Allows the user to specify any graphs by interacting through the CLI.
+//  For headless runs, graphs are read from problem files by CSPProblemLoader instead.
 
 #ifndef CSPGRAPHCREATOR_H
 #define CSPGRAPHCREATOR_H
@@ -0,0 +1,170 @@
+// Author: Akira Kudo
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "src/cspSolver/ARC.h"
+#include "src/cspSolver/CSPGraph.h"
+#include "src/cspSolver/CSPSession.h"
+#include "src/cspSolver/CSPSolver.h"
+#include "src/graphImplementation/vertices/ConstraintVertex.h"
+#include "src/graphImplementation/vertices/VariableVertex.h"
+
+using GraphImplementation::VariableVertex;
+
+// propagates graph to its fixpoint right away; settings sets the modes used for
+// propagation & for solving, and frontier the order in which arcs are checked
+CSPSolverImplementation::CSPSession::CSPSession(CSPGraph graph, const CSPSolver& settings, Frontier frontier)
+    : graph(std::move(graph)), solver(settings), frontier(std::move(frontier)), consistent(true),
+      solve_revision_count(0)
+{
+    solver.trail.clear();
+    solver.revision_count = 0;
+    refreeze();
+    // at first, every arc may have values without support
+    solver.getAllToDoArcs(this->frontier, this->graph);
+    propagate();
+};
+
+CSPSolverImplementation::CSPSession::~CSPSession()
+{
+
+};
+
+// adds a variable with given domain, not yet part of any constraint
+bool CSPSolverImplementation::CSPSession::addVariable(const std::string& name, const GraphImplementation::Domain& domain)
+{
+    if (graph.contains_vertex(name)) return false;
+    graph.add_variable(name, domain);
+    refreeze();
+    // without any constraint, only an empty domain can change anything
+    if (solver.trail.emptyDomainCount() > 0) consistent = false;
+    return consistent;
+};
+
+// adds a constraint over the variables of scope, then revises each of its arcs
+bool CSPSolverImplementation::CSPSession::addConstraint(const std::string& name, GraphImplementation::ConstraintKernel kernel,
+                                                        const std::vector<std::string>& scope, std::string description)
+{
+    if (graph.contains_vertex(name)) return false;
+    for (const std::string& vv_name : scope) if (graph.get_variable(vv_name) == nullptr) return false;
+    graph.add_constraint(name, std::move(kernel), std::move(description));
+    for (const std::string& vv_name : scope) graph.add_edge(vv_name, name);
+    refreeze();
+    queueConstraintArcs(graph.get_constraint(name)->getId());
+    return propagate();
+};
+
+// adds an edge between an existing variable & constraint, then revises each arc of the constraint
+bool CSPSolverImplementation::CSPSession::addEdge(const std::string& vv_name, const std::string& cv_name)
+{
+    GraphImplementation::ConstraintVertex* cv = graph.get_constraint(cv_name);
+    if (graph.get_variable(vv_name) == nullptr || cv == nullptr) return false;
+    graph.add_edge(vv_name, cv_name);
+    refreeze();
+    // the constraint now reads differently for each of its variables
+    queueConstraintArcs(cv->getId());
+    return propagate();
+};
+
+// removes every value but val from the domain of a variable, then revises the arcs of its neighbors
+bool CSPSolverImplementation::CSPSession::restrictDomainTo(const std::string& vv_name, int val)
+{
+    VariableVertex* vv = graph.get_variable(vv_name);
+    if (vv == nullptr) return false;
+    std::vector<int> removed_values;
+    for (int dom_val : vv->getDomainStore()) if (dom_val != val) removed_values.push_back(dom_val);
+    // a value that isn't there wipes out the domain
+    if (solver.trail.restrictDomainTo(vv, val)) queueNeighborArcs(vv, removed_values);
+    return propagate();
+};
+
+// removes val from the domain of a variable, then revises the arcs of its neighbors
+bool CSPSolverImplementation::CSPSession::removeFromDomain(const std::string& vv_name, int val)
+{
+    VariableVertex* vv = graph.get_variable(vv_name);
+    if (vv == nullptr) return false;
+    if (solver.trail.removeFromDomain(vv, val)) queueNeighborArcs(vv, { val });
+    return propagate();
+};
+
+// searches every answer left from the current fixpoint, as CSPSolver::arcConsistency would
+// on the current graph; answers come in the same format, and as many as the solve mode asks for
+std::vector<std::vector<VariableVertex>> CSPSolverImplementation::CSPSession::solve()
+{
+    std::vector<std::vector<VariableVertex>> to_be_returned;
+    solve([&to_be_returned](const AssignmentView& answer)
+    {
+        to_be_returned.push_back(answer.toVariables());
+        return CSPSolver::KeepSearching;
+    });
+    return to_be_returned;
+};
+
+// hands each answer to visitor instead, returning the number of answers found
+size_t CSPSolverImplementation::CSPSession::solve(CSPSolver::SolutionVisitor visitor)
+{
+    if (!consistent)
+    {
+        solve_revision_count = 0;
+        return 0;
+    }
+    // searching a copy leaves the fixpoint of the session untouched
+    CSPGraph searched = graph;
+    CSPSolver searcher = solver;
+    Frontier search_frontier = frontier;
+    searcher.startSearch(searched, visitor);
+    // the copy is at its fixpoint already, hence the search starts from an empty frontier
+    if (!searcher.searchComponents(search_frontier, searched))
+    {
+        searcher.startArcConsistency(searched);
+        searcher.runArcConsistency(search_frontier, searched);
+    }
+    searcher.visitor = nullptr;
+    solve_revision_count = searcher.getRevisionCount();
+    return searcher.getSolutionCount();
+};
+
+// ####################
+// PRIVATE FUNCTIONS
+// queues every arc of the constraint with given id
+void CSPSolverImplementation::CSPSession::queueConstraintArcs(uint32_t cv_id)
+{
+    uint32_t scope_size = graph.variable_neighbor_ids(cv_id).size();
+    for (uint32_t position = 0; position < scope_size; position++)
+        frontier.push(solver.makeArc(graph, graph.arc_id(cv_id, position)));
+};
+
+// queues the arcs to revise once removed_values were removed from the domain of vv
+void CSPSolverImplementation::CSPSession::queueNeighborArcs(VariableVertex* vv, const std::vector<int>& removed_values)
+{
+    // no constraint was revised; every constraint touching vv is looked at
+    ARC reduced;
+    reduced.main_var = vv;
+    solver.getAllCheckAgainArcs(frontier, graph, reduced, &removed_values);
+};
+
+// revises queued arcs until reaching a fixpoint or wiping out a domain
+// returns whether the session is still consistent
+bool CSPSolverImplementation::CSPSession::propagate()
+{
+    while (!frontier.empty() && solver.trail.emptyDomainCount() == 0) solver.singleArcConsistencyStep(graph, frontier);
+    // arcs left over once a domain is wiped out don't matter anymore
+    while (!frontier.empty()) frontier.pop();
+    if (solver.trail.emptyDomainCount() > 0) consistent = false;
+    return consistent;
+};
+
+// numbers the graph again after a structural change, counting domains anew
+void CSPSolverImplementation::CSPSession::refreeze()
+{
+    graph.freeze();
+    solver.countDomains(graph);
+    // constraint weights are only kept for constraints of the current numbering
+    solver.constraint_weights.resize(graph.num_constraints(), 0);
+    // ids may have changed, and constraints may have gained variables
+    solver.cardinality_at_fixpoint.assign(graph.num_constraints(), false);
+    solver.cardinality_matchings.assign(graph.num_constraints(), {});
+};
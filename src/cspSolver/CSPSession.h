@@ -0,0 +1,87 @@
+// Author: Akira Kudo
+// Description: Implements a solver session holding a CSP graph at its arc consistency fixpoint.
+//  Facts learned one at a time (e.g. a new claim made during a Gnosia loop) are added to
+//  the session, which only queues the arcs they may affect and propagates from the current
+//  fixpoint, instead of running arc consistency on the whole graph all over again.
+//  Domains only ever shrink within a session; solving searches a copy of the current state,
+//  leaving the session as it was.
+
+#ifndef CSPSESSION_H
+#define CSPSESSION_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "src/cspSolver/CSPGraph.h"
+#include "src/cspSolver/CSPSolver.h"
+#include "src/cspSolver/frontier/Frontier.h"
+#include "src/graphImplementation/domains/Domain.h"
+#include "src/graphImplementation/vertices/ConstraintKernel.h"
+#include "src/graphImplementation/vertices/VariableVertex.h"
+
+namespace CSPSolverImplementation
+{
+    class CSPSession
+    {
+    public:
+        // propagates graph to its fixpoint right away; settings sets the modes used for
+        // propagation & for solving, and frontier the order in which arcs are checked
+        CSPSession(CSPGraph graph, const CSPSolver& settings=CSPSolver(),
+                   Frontier frontier=Frontier(Frontier::QueueMode));
+        ~CSPSession();
+
+        // each fact below returns false if a name is unknown or already taken, in which case nothing
+        // changes, or if the session is left inconsistent - some domain having been wiped out
+        // adds a variable with given domain, not yet part of any constraint
+        bool addVariable(const std::string& name, const GraphImplementation::Domain& domain);
+        // adds a constraint over the variables of scope, then revises each of its arcs
+        bool addConstraint(const std::string& name, GraphImplementation::ConstraintKernel kernel,
+                           const std::vector<std::string>& scope,
+                           std::string description="This is the default description.");
+        // adds an edge between an existing variable & constraint, then revises each arc of the constraint
+        bool addEdge(const std::string& vv_name, const std::string& cv_name);
+        // removes every value but val / removes val from the domain of a variable, then revises
+        // the arcs of its neighbors through the constraints touching it
+        bool restrictDomainTo(const std::string& vv_name, int val);
+        bool removeFromDomain(const std::string& vv_name, int val);
+
+        // searches every answer left from the current fixpoint, as CSPSolver::arcConsistency would
+        // on the current graph; answers come in the same format, and as many as the solve mode asks for
+        std::vector<std::vector<GraphImplementation::VariableVertex>> solve();
+        // hands each answer to visitor instead, returning the number of answers found
+        size_t solve(CSPSolver::SolutionVisitor visitor);
+
+        // getters
+        // false once a domain was wiped out, after which no answer is left
+        bool isConsistent() const { return this->consistent; };
+        // the graph at its current fixpoint
+        const CSPGraph& getGraph() const { return this->graph; };
+        // number of arc revisions made to propagate every fact since the session started
+        size_t getRevisionCount() const { return this->solver.getRevisionCount(); };
+        // number of arc revisions made by the last call to solve
+        size_t getSolveRevisionCount() const { return this->solve_revision_count; };
+
+    private:
+        CSPGraph graph;
+        // propagates facts, using the trail to keep count of empty & single valued domains
+        CSPSolver solver;
+        // arcs left to revise; always empty in between facts, so that arc ids changing
+        // as the graph is frozen again after a structural change never matter
+        Frontier frontier;
+        bool consistent;
+        size_t solve_revision_count;
+
+        // queues every arc of the constraint with given id
+        void queueConstraintArcs(uint32_t cv_id);
+        // queues the arcs to revise once removed_values were removed from the domain of vv
+        void queueNeighborArcs(GraphImplementation::VariableVertex* vv, const std::vector<int>& removed_values);
+        // revises queued arcs until reaching a fixpoint or wiping out a domain
+        // returns whether the session is still consistent
+        bool propagate();
+        // numbers the graph again after a structural change, counting domains anew
+        void refreeze();
+    };
+}
+
+#endif
@@ -1,17 +1,34 @@
 // Author: Akira Kudo
 
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
 #include <string>
+#include <thread>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include "src/cspSolver/CSPGraphCreator.h"
 #include "src/cspSolver/CSPSolver.h"
+#include "src/cspSolver/io/CSPGraphSerializer.h"
 #include "src/graphImplementation/Graph.h"
+#include "src/graphImplementation/vertices/ConstraintKernel.h"
+#include "src/graphImplementation/vertices/ConstraintVertex.h"
 #include "src/graphImplementation/vertices/VariableVertex.h"
 
 using GraphImplementation::Graph, GraphImplementation::VariableVertex;
 
-CSPSolverImplementation::CSPSolver::CSPSolver() 
+CSPSolverImplementation::CSPSolver::CSPSolver(SearchMode search_mode) 
+    : search_mode(search_mode), solve_mode(AllSolutionsMode), solution_limit(SIZE_MAX), 
+      propagation_mode(AC3Mode), branching_heuristic(InputOrder), backtrack_mode(ChronologicalMode), 
+      symmetry_mode(NoSymmetryBreaking), decomposition_mode(WholeGraphMode), depth(0), 
+      thread_count(std::max(1u, std::thread::hardware_concurrency())), spawn_cutoff_depth(3), 
+      pool(nullptr), revision_count(0), visitor(nullptr), stop_requested(false), solution_count(0),
+      failure_explained(false), skipped_node_count(0), learned_nogood_count(0), expanded_solution_count(0),
+      transpositions(std::make_shared<TranspositionCache>()), caching(false), graph_fingerprint(0), recording_depth(0),
+      component_count(1)
 {
 
 };
@@ -21,39 +38,93 @@ CSPSolverImplementation::CSPSolver::~CSPSolver()
 
 };
 
-// save a created CSP graph
-// * not implemented yet; have to find a way to serialize 
-// constraints first, and I don't think we need that yet
-void CSPSolverImplementation::CSPSolver::saveCspGraph(const CSPGraph& graph, std::string saveDir)
+// save a created CSP graph to a binary file at savePath; see CSPGraphSerializer
+// returns false if the graph holds custom predicates, which can't be saved
+bool CSPSolverImplementation::CSPSolver::saveCspGraph(const CSPGraph& graph, std::string savePath)
 {
+    return CSPGraphSerializer::save(graph, savePath);
+};
 
+// load a CSP graph saved with saveCspGraph, which comes out frozen
+// returns an empty graph if the file is missing or malformed
+CSPSolverImplementation::CSPGraph CSPSolverImplementation::CSPSolver::loadCspGraph(std::string loadPath)
+{
+    CSPGraph loaded;
+    CSPGraphSerializer::load(loadPath, loaded);
+    return loaded;
 };
 
-// load a CSP graph
-// *not implemented yet; have to find a way to serialize 
-// constraints first, and I don't think we need that yet
-void CSPSolverImplementation::CSPSolver::loadCspGraph(std::string loadDir)
+// run arc consistency and return all possible answers, or as many as the solve mode asks for
+// the frontier mode & heuristic set the order in which arcs are checked
+std::vector<std::vector<VariableVertex>> CSPSolverImplementation::CSPSolver::arcConsistency(
+    CSPGraph graph, Frontier::FrontierMode mode, Frontier::ArcHeuristic heuristic)
 {
-    
-};            
+    return arcConsistency(std::move(graph), Frontier(mode, heuristic));
+};
 
-// run arc consistency and return all possible answers
-std::vector<std::vector<VariableVertex>> CSPSolverImplementation::CSPSolver::arcConsistency(CSPGraph graph)
+// run arc consistency using the given empty frontier, e.g. one created with a custom comparator
+std::vector<std::vector<VariableVertex>> CSPSolverImplementation::CSPSolver::arcConsistency(CSPGraph graph, Frontier frontier)
 {
     std::vector<std::vector<VariableVertex>> to_be_returned;
+    std::vector<size_t> answer_multiplicities;
+    arcConsistency(std::move(graph), std::move(frontier), [&to_be_returned, &answer_multiplicities](const AssignmentView& answer)
+    {
+        to_be_returned.push_back(answer.toVariables());
+        answer_multiplicities.push_back(answer.multiplicity());
+        return KeepSearching;
+    });
+    multiplicities = std::move(answer_multiplicities);
+    return to_be_returned;
+};
+
+// run arc consistency, handing each answer to visitor as soon as it is found instead of 
+// collecting them; the search ends early once visitor returns StopSearching
+size_t CSPSolverImplementation::CSPSolver::arcConsistency(
+    CSPGraph graph, SolutionVisitor visitor, Frontier::FrontierMode mode, Frontier::ArcHeuristic heuristic)
+{
+    return arcConsistency(std::move(graph), Frontier(mode, heuristic), std::move(visitor));
+};
+
+size_t CSPSolverImplementation::CSPSolver::arcConsistency(CSPGraph graph, Frontier frontier, SolutionVisitor visitor)
+{
+    startSearch(graph, visitor);
+    // independent parts of the graph are searched one at a time, see DecompositionMode
+    if (!searchComponents(frontier, graph))
+    {
+        startArcConsistency(graph);
+        // we initially generate all arc to be checked using getAllToDoArcs
+        getAllToDoArcs(frontier, graph);
 
-    Frontier frontier = Frontier(Frontier::QueueMode); //queue mode by default for now
-    // we initially generate all arc to be checked using getAllToDoArcs
-    getAllToDoArcs(frontier, graph);
-    // then call arc consistency trampoline, returning results
-    return arcConsistency_trampoline(frontier, graph);
+        // then call arc consistency trampoline, which reports answers as it finds them
+        runArcConsistency(frontier, graph);
+    }
+    this->visitor = nullptr;
+    return solution_count;
 };
 
 // run DFS with pruning and return all possible answers
+// variables are assigned one at a time, picking the one with minimum remaining values;
+// each assignment only forward checks the constraints touching the assigned variable
 std::vector<std::vector<VariableVertex>> CSPSolverImplementation::CSPSolver::depthFirstSearchWithPruning(CSPGraph graph)
 {
-    // stub maybe implement another time
-    return std::vector<std::vector<VariableVertex>>();
+    std::vector<std::vector<VariableVertex>> to_be_returned;
+    depthFirstSearchWithPruning(std::move(graph), [&to_be_returned](const AssignmentView& answer)
+    {
+        to_be_returned.push_back(answer.toVariables());
+        return KeepSearching;
+    });
+    return to_be_returned;
+};
+
+// run DFS with pruning, handing each answer to visitor as soon as it is found
+// the search ends early once visitor returns StopSearching; returns the number of answers visited
+size_t CSPSolverImplementation::CSPSolver::depthFirstSearchWithPruning(CSPGraph graph, SolutionVisitor visitor)
+{
+    startSearch(graph, visitor);
+    std::vector<bool> assigned(graph.num_variables(), false);
+    depthFirstSearch_recursive(graph, assigned);
+    this->visitor = nullptr;
+    return solution_count;
 };
 
 // create a CSP graph for a given problem - using a CLI?
@@ -68,150 +139,543 @@ CSPSolverImplementation::CSPGraph CSPSolverImplementation::CSPSolver::createCspG
 
 // trampoline for starting a call to arc consistency
 // enables recursive calls after domain splitting
-std::vector<std::vector<GraphImplementation::VariableVertex>>
-CSPSolverImplementation::CSPSolver::arcConsistency_trampoline(
+void CSPSolverImplementation::CSPSolver::arcConsistency_trampoline(
     CSPSolverImplementation::Frontier& frontier, 
     CSPSolverImplementation::CSPGraph& graph)
 {
-    std::vector<std::vector<VariableVertex>> to_be_returned; //holds answers to be returned
-    std::tuple<std::vector<VariableVertex>, bool> checked_answer; //result checking for answers
-    
-    // we repeatedly call singleArcConsistencyStep, until we deplete the frontier
-    do {
-        // we check if we've reached a determinate answer
-        checked_answer = checkAnswer(graph);
-        // if we've reached a determinate answer, break out of loop
-        if (std::get<1>(checked_answer)) break;
-        // otherwise, apply a single step of arc consistency
-        singleArcConsistencyStep(graph, frontier);
-
-    } while (!frontier.empty());
+    // until shown otherwise, this branch can't be backjumped over
+    failure_explained = false;
+    // enough answers were found already
+    if (stop_requested) return;
+    propagate(frontier, graph);
 
-    // check we didn't run out of frontier simultaenously to reaching a determinate answer
-    checked_answer = checkAnswer(graph);
-
-    // once out of loop, we have either:
+    // once propagation stops, we have either:
     // 1 - reached a determinate solution (unique / non-existent)
-    //     in which case we return the result
-    if (std::get<1>(checked_answer))
+    //     in which case we report the result; every variable having a single value is only
+    //     an answer once the frontier is depleted, as unchecked arcs might still rule it out
+    if (trail.emptyDomainCount() > 0) return explainFailure(graph);
+    if (graph.num_variables() == 0) return;
+    if (trail.singleDomainCount() == graph.num_variables())
     {
-        if (!std::get<0>(checked_answer).empty())
-            to_be_returned.push_back(std::get<0>(checked_answer));
-        return to_be_returned;
+        reportSolution(graph);
+        return;
     }
     
     // 2 - reached an indeterminate state where domain splitting is required
     //     in which case we apply domain splitting then recursively call this function
-    // when result is indeterminate, var_with... will never be assigned to a nullptr
-    VariableVertex* var_with_domain_size_more_than_one;
-    for (std::string vv_name : graph.get_all_variable_names())
+    // when result is indeterminate, we will always find such a variable
+    graph.freeze();
+    // a state searched before has its answers reported again instead of being searched
+    TranspositionCache::Key key {};
+    if (caching)
     {
-        // find a variable with domain size greater than 1
-        if (graph.get_variable(vv_name)->getDomain().size() > 1)
-        {
-            var_with_domain_size_more_than_one = graph.get_variable(vv_name);
-            break;
-        }
+        key = TranspositionCache::Key { graph_fingerprint, trail.domainHash(), trail.checkHash(), 
+                                        solve_mode == CountOnlyMode };
+        if (reportCachedResult(graph, key)) return;
+        recording_depth++;
     }
+    size_t solutions_before = solution_count, recorded_from = recorded_values.size();
+    uint32_t split_var_id = pickSplitVariable(graph);
+
+    // then explore every value of that variable as its own branch
+    if (search_mode == ParallelMode) branchInParallel(frontier, graph, split_var_id);
+    else if (search_mode == TrailMode) branchOnTrail(frontier, graph, split_var_id);
+    else branchOnCopies(frontier, graph, split_var_id);
+    if (caching) cacheResult(key, solutions_before, recorded_from);
+};
+
+// revises arcs in frontier until it is depleted or a domain is wiped out, checking the lex-leader
+// constraints over symmetries & learned nogoods in BackjumpingMode each time the frontier is depleted
+void CSPSolverImplementation::CSPSolver::propagate(Frontier& frontier, CSPGraph& graph)
+{
+    do
+    {
+        // we repeatedly call singleArcConsistencyStep, until we deplete the frontier or wipe out 
+        // a domain; the domain counts kept by the trail make checking the latter O(1)
+        while (!frontier.empty() && trail.emptyDomainCount() == 0) singleArcConsistencyStep(graph, frontier);
+    } 
+    // values ruled out by symmetry breaking or nogoods call for more revisions
+    while (trail.emptyDomainCount() == 0 && 
+           (propagateSymmetries(frontier, graph) || 
+            (backtrack_mode == BackjumpingMode && propagateNogoods(frontier, graph))));
+};
 
+// explores each value of the split variable on a copy of graph, as in CopyMode
+void CSPSolverImplementation::CSPSolver::branchOnCopies(Frontier& frontier, CSPGraph& graph, uint32_t split_var_id)
+{
     // split the domain of the variable we found
-    std::vector<CSPGraph> subgraphs = splitDomain(
-        graph,
-        var_with_domain_size_more_than_one
-        );
+    std::vector<CSPGraph> subgraphs = splitDomain(graph, graph.variable_at(split_var_id));
+    // why the split variable lost its other values already, before any branch is explored
+    LevelSet node_failure = (backtrack_mode == BackjumpingMode) ? explainer.explanationOf(split_var_id) : LevelSet();
+    bool node_explained = true;
 
     // for each subgraph obtained by splitting
-    for (CSPGraph subg : subgraphs)
+    for (size_t i = 0; i < subgraphs.size(); i++)
     {
+        CSPGraph& subg = subgraphs[i];
         // copy the frontier to create a new one
         Frontier new_frontier = frontier;
         
         // add back nodes to check as a result of reducing domain
         // for this arc, only main_var matters
-        ARC a; a.main_var = var_with_domain_size_more_than_one;
+        ARC a; a.main_var = subg.variable_at(split_var_id);
         a.other_var_list = std::vector<VariableVertex*>();
         a.constraint = nullptr; //nullptr should work equally
 
         getAllCheckAgainArcs(new_frontier, subg, a);
 
-        // recursively call arc consistency trampoline
-        auto subg_solu = arcConsistency_trampoline(new_frontier, subg);
-        if (!subg_solu.empty())
+        // recursively call arc consistency trampoline, counting domains of the copy it works on
+        countDomains(subg);
+        if (backtrack_mode == BackjumpingMode) explainer.decide(split_var_id, subg.variable_at(split_var_id)->getDomainStore().min());
+        depth++;
+        arcConsistency_trampoline(new_frontier, subg);
+        depth--;
+        if (backtrack_mode == BackjumpingMode) explainer.undoLastDecision();
+        if (stop_requested) break;
+        if (backtrack_mode == BackjumpingMode && 
+            backjumpsPast(explainer.level() + 1, subgraphs.size() - i - 1, node_failure, node_explained)) break;
+    }
+    // changes were only ever made to copies of graph
+    countDomains(graph);
+    if (backtrack_mode == BackjumpingMode && !stop_requested) endBranching(node_failure, node_explained);
+};
+
+// explores each value of the split variable in place, undoing through the trail, as in TrailMode
+void CSPSolverImplementation::CSPSolver::branchOnTrail(Frontier& frontier, CSPGraph& graph, uint32_t split_var_id)
+{
+    VariableVertex* split_var = graph.variable_at(split_var_id);
+    // the domain changes while we branch, hence iterate over a snapshot of it
+    std::vector<int> split_values(split_var->getDomainStore().begin(), split_var->getDomainStore().end());
+    // why the split variable lost its other values already, before any branch is explored
+    LevelSet node_failure = (backtrack_mode == BackjumpingMode) ? explainer.explanationOf(split_var_id) : LevelSet();
+    bool node_explained = true;
+
+    for (size_t i = 0; i < split_values.size(); i++)
+    {
+        int dom_val = split_values[i];
+        // every removal from here on is undone once this branch is explored
+        trail.markChoicePoint();
+        if (backtrack_mode == BackjumpingMode) explainer.decide(split_var_id, dom_val);
+        trail.restrictDomainTo(split_var, dom_val);
+
+        // copy the frontier, adding back arcs affected by the reduced domain
+        Frontier new_frontier = frontier;
+        ARC a; a.main_var = split_var;
+        getAllCheckAgainArcs(new_frontier, graph, a);
+
+        // recursively call arc consistency trampoline on the same graph
+        depth++;
+        arcConsistency_trampoline(new_frontier, graph);
+        depth--;
+        // backtrack
+        trail.undoToLastChoicePoint();
+        if (backtrack_mode == BackjumpingMode) explainer.undoLastDecision();
+        if (stop_requested) return;
+        if (backtrack_mode == BackjumpingMode && 
+            backjumpsPast(explainer.level() + 1, split_values.size() - i - 1, node_failure, node_explained)) break;
+    }
+    if (backtrack_mode == BackjumpingMode) endBranching(node_failure, node_explained);
+};
+
+// in BackjumpingMode, takes in how the branch just explored at level ended; returns true if
+// it failed whatever was decided at level, in which case the values_left values still to
+// try at level are skipped, and the failure is passed up as is through node_failure
+// otherwise, node_failure & node_explained gather why every branch at level failed so far
+bool CSPSolverImplementation::CSPSolver::backjumpsPast(size_t level, size_t values_left, 
+                                                       LevelSet& node_failure, bool& node_explained)
+{
+    // an answer was found below, which no decision above can be blamed for
+    if (!failure_explained)
+    {
+        node_explained = false;
+        return false;
+    }
+    if (!failure_levels.contains(level))
+    {
+        // every other value at level fails for the very same reasons
+        skipped_node_count += values_left;
+        node_failure = failure_levels;
+        return true;
+    }
+    failure_levels.erase(level);
+    node_failure.merge(failure_levels);
+    return false;
+};
+
+// in BackjumpingMode, ends a branching whose branches failed for node_failure, if node_explained, 
+// learning the nogood made of the branchings at those levels
+void CSPSolverImplementation::CSPSolver::endBranching(const LevelSet& node_failure, bool node_explained)
+{
+    failure_levels = node_failure;
+    failure_explained = node_explained;
+    if (!node_explained) return;
+    // an empty failure means there is no answer at all, which backjumping already takes care of
+    NogoodStore::Nogood nogood;
+    for (size_t level : node_failure.levels()) nogood.push_back(explainer.decisionAt(level));
+    if (nogood.empty() || nogoods.getCapacity() == 0) return;
+    nogoods.add(std::move(nogood));
+    learned_nogood_count++;
+};
+
+// sets the failure of the branch explored last to the explanation of a wiped out domain of graph
+void CSPSolverImplementation::CSPSolver::explainFailure(const CSPGraph& graph)
+{
+    if (backtrack_mode != BackjumpingMode) return;
+    for (uint32_t vv_id = 0; vv_id < graph.num_variables(); vv_id++)
+    {
+        if (!graph.variable_at(vv_id)->getDomainStore().empty()) continue;
+        failure_levels = explainer.explanationOf(vv_id);
+        failure_explained = true;
+        return;
+    }
+};
+
+// removes values ruled out by the learned nogoods whose other decisions all hold, adding the 
+// arcs to check again; wipes out a domain if every decision of a nogood holds
+// returns whether any domain was reduced
+bool CSPSolverImplementation::CSPSolver::propagateNogoods(Frontier& frontier, CSPGraph& graph)
+{
+    bool reduced = false;
+    for (size_t i = 0; i < nogoods.size() && trail.emptyDomainCount() == 0; i++)
+    {
+        const NogoodStore::Nogood& nogood = nogoods.at(i);
+        // the one decision of the nogood that doesn't hold yet, if only one
+        const ConflictExplainer::Decision* open = nullptr;
+        bool ruled_out = true;
+        for (const ConflictExplainer::Decision& decision : nogood)
+        {
+            const GraphImplementation::Domain& domain = graph.variable_at(decision.vv_id)->getDomainStore();
+            if (domain.size() == 1 && domain.contains(decision.val)) continue;
+            // a decision that can't hold anymore makes the nogood hold
+            if (!domain.contains(decision.val) || open != nullptr)
+            {
+                ruled_out = false;
+                break;
+            }
+            open = &decision;
+        }
+        if (!ruled_out) continue;
+
+        // every other decision holds, which is why the open one can't
+        LevelSet why;
+        for (const ConflictExplainer::Decision& decision : nogood)
+            if (&decision != open) why.merge(explainer.explanationOf(decision.vv_id));
+        ARC reduced_arc;
+        reduced_arc.main_var = graph.variable_at((open != nullptr) ? open->vv_id : nogood.back().vv_id);
+        explainer.explainBy(reduced_arc.main_var->getId(), why);
+        revised_values.clear();
+        if (open != nullptr) revised_values.push_back(open->val);
+        // every decision holds: wiping out a domain fails the branch
+        else revised_values.assign(reduced_arc.main_var->getDomainStore().begin(), reduced_arc.main_var->getDomainStore().end());
+        for (int val : revised_values) trail.removeFromDomain(reduced_arc.main_var, val);
+        getAllCheckAgainArcs(frontier, graph, reduced_arc, &revised_values);
+        reduced = true;
+    }
+    return reduced;
+};
+
+// sets up what only arc consistency uses once startSearch was called: the interchangeable 
+// variables & values of graph unless in NoSymmetryBreaking, and the transposition cache
+void CSPSolverImplementation::CSPSolver::startArcConsistency(const CSPGraph& graph)
+{
+    if (symmetry_mode == NoSymmetryBreaking) symmetries.clear();
+    else symmetries.detect(graph);
+    // answers below a state only depend on the graph & its domains once no symmetry is broken
+    caching = (transpositions->getCapacity() > 0 && symmetries.empty());
+    // what a custom predicate checks is unknown, so that nothing tells two graphs differing only by one
+    // apart; graphs holding any are never cached, as their variables are never swapped by symmetries
+    for (uint32_t cv_id = 0; cv_id < graph.num_constraints() && caching; cv_id++)
+        if (graph.constraint_at(cv_id)->getKernel().getType() == GraphImplementation::ConstraintKernel::CustomPredicate)
+            caching = false;
+    if (!caching) return;
+    graph_fingerprint = fingerprintOf(graph);
+    trail.setHashing(true);
+    countDomains(graph);
+};
+
+// hash of the constraints of graph, which holds no custom predicate
+uint64_t CSPSolverImplementation::CSPSolver::fingerprintOf(const CSPGraph& graph) const
+{
+    uint64_t returned = 0;
+    // each number is folded in along with its position, so that the order of the constraints matters
+    uint32_t position = 0;
+    auto fold = [&returned, &position](int number) { returned = Trail::valueKey(position++, number, returned); };
+    fold((int) graph.num_variables());
+    for (uint32_t cv_id = 0; cv_id < graph.num_constraints(); cv_id++)
+    {
+        const GraphImplementation::ConstraintKernel& kernel = graph.constraint_at(cv_id)->getKernel();
+        fold((int) kernel.getType());
+        fold(kernel.getCheckedValue());
+        fold(kernel.getN());
+        for (const GraphImplementation::ConstraintKernel::CardinalityBound& bound : kernel.getBounds())
         {
-            to_be_returned.reserve(to_be_returned.size() + subg_solu.size());
-            to_be_returned.insert(to_be_returned.end(), subg_solu.begin(), subg_solu.end());
+            fold(bound.value);
+            fold(bound.min);
+            fold(bound.max);
         }
+        IdSpan scope = graph.variable_neighbor_ids(cv_id);
+        fold((int) scope.size());
+        for (uint32_t vv_id : scope) fold((int) vv_id);
     }
-    // return the result
-    return to_be_returned;
+    return returned;
 };
 
+// reports the answers cached for the state of key again, returning false if none are cached
+bool CSPSolverImplementation::CSPSolver::reportCachedResult(const CSPGraph& graph, const TranspositionCache::Key& key)
+{
+    std::shared_ptr<const TranspositionCache::Result> cached = transpositions->find(key);
+    if (cached == nullptr) return false;
+    if (key.counted)
+    {
+        solution_count += cached->solution_count;
+        expanded_solution_count = solution_count;
+        return true;
+    }
+    size_t num_variables = graph.num_variables();
+    for (size_t offset = 0; offset + num_variables <= cached->values.size() && !stop_requested; offset += num_variables)
+        reportSolution(graph, cached->values.data() + offset);
+    return true;
+};
 
-// populates the given frontier with the set of all arcs to be checked given a CSPGraph
-// used at the beginning when running arc consistency
-void CSPSolverImplementation::CSPSolver::getAllToDoArcs(
-    CSPSolverImplementation::Frontier& frontier, 
-    CSPSolverImplementation::CSPGraph& graph) 
+// caches the answers found below the state of key since solution_count was solutions_before &
+// recorded_values held recorded_from values, unless the search below it was cut short
+void CSPSolverImplementation::CSPSolver::cacheResult(const TranspositionCache::Key& key, 
+                                                     size_t solutions_before, size_t recorded_from)
 {
-    ARC new_arc;
-    // for every constraint vertex in the graph:
-    for (auto cv_name: graph.get_all_constraint_names()) 
+    recording_depth--;
+    if (!stop_requested)
     {
-        // generate an arc choosing each varaible vertex in their adjacency list
-        auto variable_neighbors = graph.get_variable_neighbors(cv_name);
-        int neighbor_size = variable_neighbors.size();
-        
-        // pick each neighbor as main variable
-        for (int i=0; i < neighbor_size; i++) 
+        TranspositionCache::Result result;
+        result.solution_count = solution_count - solutions_before;
+        if (!key.counted) result.values.assign(recorded_values.begin() + recorded_from, recorded_values.end());
+        transpositions->insert(key, std::move(result));
+    }
+    // answers are only kept while a state they were found below is being searched
+    if (recording_depth == 0) recorded_values.clear();
+};
+
+// removes values ruled out by the lex-leader constraints over interchangeable variables & values,
+// adding the arcs to check again; returns whether any domain was reduced
+bool CSPSolverImplementation::CSPSolver::propagateSymmetries(Frontier& frontier, CSPGraph& graph)
+{
+    if (symmetries.empty()) return false;
+    bool reduced = false;
+    for (const std::vector<uint32_t>& variable_class : symmetries.getVariableClasses())
+    {
+        // interchangeable variables take non-decreasing values: none takes less than the smallest
+        // value left to the one before it...
+        for (size_t i = 1; i < variable_class.size() && trail.emptyDomainCount() == 0; i++)
+        {
+            int lowest = graph.variable_at(variable_class[i - 1])->getDomainStore().min();
+            revised_values.clear();
+            for (int val : graph.variable_at(variable_class[i])->getDomainStore())
+            {
+                if (val >= lowest) break;
+                revised_values.push_back(val);
+            }
+            if (revised_values.empty()) continue;
+            removeRevisedValues(frontier, graph, variable_class[i], (backtrack_mode == BackjumpingMode) ? 
+                                explainer.explanationOf(variable_class[i - 1]) : LevelSet());
+            reduced = true;
+        }
+        // ...nor more than the largest value left to the one after it
+        for (size_t i = variable_class.size() - 1; i-- > 0 && trail.emptyDomainCount() == 0;)
+        {
+            int highest = graph.variable_at(variable_class[i + 1])->getDomainStore().max();
+            revised_values.clear();
+            for (int val : graph.variable_at(variable_class[i])->getDomainStore())
+                if (val > highest) revised_values.push_back(val);
+            if (revised_values.empty()) continue;
+            removeRevisedValues(frontier, graph, variable_class[i], (backtrack_mode == BackjumpingMode) ? 
+                                explainer.explanationOf(variable_class[i + 1]) : LevelSet());
+            reduced = true;
+        }
+    }
+    for (size_t i = 0; i < symmetries.getValueClasses().size(); i++)
+    {
+        const std::vector<int>& value_class = symmetries.getValueClasses()[i];
+        // each interchangeable value is first taken after the one right below it: variables before the 
+        // first one that can take the smaller value can't take the larger one
+        for (size_t j = 1; j < value_class.size() && trail.emptyDomainCount() == 0; j++)
         {
-            new_arc.main_var = variable_neighbors[i];
-            new_arc.other_var_list = std::vector<VariableVertex*>();
-            
-            // add all other neighbors into the list
-            for (int j=0; j < neighbor_size; j++) 
+            LevelSet why;
+            for (uint32_t vv_id : symmetries.getValueHolders(i))
             {
-                if (i != j) new_arc.other_var_list.push_back(variable_neighbors[j]);
+                const GraphImplementation::Domain& domain = graph.variable_at(vv_id)->getDomainStore();
+                if (domain.contains(value_class[j]))
+                {
+                    revised_values.assign(1, value_class[j]);
+                    removeRevisedValues(frontier, graph, vv_id, why);
+                    reduced = true;
+                }
+                if (domain.contains(value_class[j - 1]) || trail.emptyDomainCount() > 0) break;
+                if (backtrack_mode == BackjumpingMode) why.merge(explainer.explanationOf(vv_id));
             }
-            new_arc.constraint = graph.get_constraint(cv_name);
-            
-            // add it to the frontier
-            frontier.push(new_arc);
-        } 
+        }
     }
+    return reduced;
+};
+
+// removes revised_values from the domain of variable vv_id, which why explains in BackjumpingMode,
+// adding the arcs to check again
+void CSPSolverImplementation::CSPSolver::removeRevisedValues(Frontier& frontier, CSPGraph& graph, 
+                                                             uint32_t vv_id, const LevelSet& why)
+{
+    ARC reduced_arc;
+    reduced_arc.main_var = graph.variable_at(vv_id);
+    explainer.explainBy(vv_id, why);
+    for (int val : revised_values) trail.removeFromDomain(reduced_arc.main_var, val);
+    getAllCheckAgainArcs(frontier, graph, reduced_arc, &revised_values);
+};
+
+// explores each value of the split variable as a pool task, as in ParallelMode
+// answers are buffered per branch, then reported in the order of the values,
+// as if explored sequentially
+void CSPSolverImplementation::CSPSolver::branchInParallel(Frontier& frontier, CSPGraph& graph, uint32_t split_var_id)
+{
+    // deep in the search, branches are too small to be worth a task & a graph copy
+    if (pool == nullptr || depth >= spawn_cutoff_depth) return branchOnTrail(frontier, graph, split_var_id);
+
+    // each branch gets its own copy of the graph, being explored concurrently
+    std::vector<CSPGraph> subgraphs = splitDomain(graph, graph.variable_at(split_var_id));
+    // answers of a branch are kept as the values of every variable, one answer after the other
+    std::vector<std::vector<int>> branch_values(subgraphs.size());
+    std::vector<size_t> branch_revision_counts(subgraphs.size(), 0);
+    std::vector<size_t> branch_solution_counts(subgraphs.size(), 0);
+    std::vector<size_t> branch_skipped_counts(subgraphs.size(), 0);
+    std::vector<size_t> branch_learned_counts(subgraphs.size(), 0);
+    // answers are weighed & told apart from symmetric ones once reported here, which needs their values
+    bool buffers_counted = (solve_mode == CountOnlyMode && weighsAnswers());
+
+    ThreadPool::TaskGroup branches;
+    for (size_t i = 0; i < subgraphs.size(); i++)
+    {
+        pool->submit(branches, [this, &frontier, &subgraphs, &branch_values, &branch_revision_counts, &branch_solution_counts, 
+                               &branch_skipped_counts, &branch_learned_counts, buffers_counted, split_var_id, i]
+        {
+            // a worker-local solver holds the trail & depth of this branch
+            CSPSolver worker = *this;
+            worker.trail.clear();
+            worker.depth = this->depth + 1;
+            worker.recorded_values.clear();
+            worker.recording_depth = 0;
+            worker.revision_count = 0;
+            worker.countDomains(subgraphs[i]);
+            // the worker buffers its answers, which can't be visited out of order
+            std::vector<int>& values = branch_values[i];
+            SolutionVisitor buffer = [&values](const AssignmentView& answer)
+            {
+                for (uint32_t vv_id = 0; vv_id < answer.size(); vv_id++) values.push_back(answer.valueAt(vv_id));
+                return KeepSearching;
+            };
+            worker.visitor = &buffer;
+            if (buffers_counted) worker.solve_mode = AllSolutionsMode;
+            worker.stop_requested = false;
+            // starting from the answers found so far, the worker stops on its own once the limit is reached
+            // (nobody else updates them until every branch is done)
+            worker.solution_count = this->solution_count;
+
+            CSPGraph& subg = subgraphs[i];
+            Frontier new_frontier = frontier;
+            ARC a; a.main_var = subg.variable_at(split_var_id);
+            worker.getAllCheckAgainArcs(new_frontier, subg, a);
+            worker.skipped_node_count = 0;
+            worker.learned_nogood_count = 0;
+            if (worker.backtrack_mode == BackjumpingMode) 
+                worker.explainer.decide(split_var_id, a.main_var->getDomainStore().min());
+            worker.arcConsistency_trampoline(new_frontier, subg);
+            branch_revision_counts[i] = worker.revision_count;
+            branch_skipped_counts[i] = worker.skipped_node_count;
+            branch_learned_counts[i] = worker.learned_nogood_count;
+            branch_solution_counts[i] = worker.solution_count - this->solution_count;
+        });
+    }
+    // we run queued tasks ourselves while waiting
+    pool->wait(branches);
+
+    for (size_t count : branch_revision_counts) revision_count += count;
+    for (size_t count : branch_skipped_counts) skipped_node_count += count;
+    for (size_t count : branch_learned_counts) learned_nogood_count += count;
+    // failures of branches run as tasks aren't passed up, failure_explained staying false
+    // answers weren't buffered when only counting
+    if (solve_mode == CountOnlyMode && !buffers_counted)
+    {
+        for (size_t count : branch_solution_counts) solution_count += count;
+        expanded_solution_count = solution_count;
+        return;
+    }
+    // a stop only takes effect here, as branches run to completion concurrently
+    size_t num_variables = graph.num_variables();
+    for (const std::vector<int>& values : branch_values)
+        for (size_t offset = 0; offset + num_variables <= values.size() && !stop_requested; offset += num_variables)
+            reportSolution(graph, values.data() + offset);
+};
+
+
+// runs the trampoline on the arcs in frontier, within a thread pool in ParallelMode
+void CSPSolverImplementation::CSPSolver::runArcConsistency(Frontier& frontier, CSPGraph& graph)
+{
+    if (search_mode != ParallelMode) return arcConsistency_trampoline(frontier, graph);
+    // the pool only lives for the duration of this search
+    ThreadPool search_pool(thread_count);
+    pool = &search_pool;
+    arcConsistency_trampoline(frontier, graph);
+    pool = nullptr;
+};
+
+// populates the given frontier with the set of all arcs to be checked given a CSPGraph
+// used at the beginning when running arc consistency
+void CSPSolverImplementation::CSPSolver::getAllToDoArcs(
+    CSPSolverImplementation::Frontier& frontier, 
+    CSPSolverImplementation::CSPGraph& graph) 
+{
+    graph.freeze();
+    // arcs are numbered constraint by constraint, each variable neighbor 
+    // of a constraint being picked as main variable once
+    for (uint32_t arc_id = 0; arc_id < graph.num_arcs(); arc_id++) 
+        if (!frontier.contains(arc_id)) frontier.push(makeArc(graph, arc_id));
 };
 
 
 // populates the given frontier with the set of all arcs to be checked, given 
 // we just checked a certain ARC and reduced the domain of the main variable
-void CSPSolverImplementation::CSPSolver::getAllCheckAgainArcs(Frontier& frontier, CSPGraph& graph, const ARC& arc)
+// in ResidueMode, knowing the removed values lets us skip constraints whose supports weren't touched
+void CSPSolverImplementation::CSPSolver::getAllCheckAgainArcs(Frontier& frontier, CSPGraph& graph, const ARC& arc,
+                                                              const std::vector<int>* removed_values)
 {
-    ARC add_back_arc;
-    // iterate over all neighbors of mainVar in arc
-    for (auto C : graph.get_constraint_neighbors(arc.main_var->getName())) 
+    graph.freeze();
+    uint32_t main_var_id = arc.main_var->getId();
+    // the main variable has to be numbered by graph (or a copy of it)
+    if (main_var_id >= graph.num_variables()) return;
+    uint32_t ignored_cv_id = (arc.constraint == nullptr) ? GraphImplementation::Vertex::NO_ID : arc.constraint->getId();
+
+    // the arcs of every constraint neighbor C of mainVar whose main variable V is unequal to mainVar 
+    // were listed when freezing, grouped by C; constraints over mainVar alone never need revising again
+    uint32_t current_cv_id = GraphImplementation::Vertex::NO_ID;
+    bool skips_current = false;
+    bool reorders_on_push = frontier.reordersOnPush();
+    for (uint32_t arc_id : graph.requeue_arc_ids_of(main_var_id)) 
     {
-        // for each such constraint neighbor C, ignore the one given as part of arc
-        if (C == arc.constraint) continue;
-        // for other neighbors C, iterate over its variable neighbors V
-        auto variable_neighbors_of_C = graph.get_variable_neighbors(C->getName());
-        
-        for (auto V : variable_neighbors_of_C)
+        // each C is looked at once, on its first arc
+        uint32_t cv_id = graph.arc_constraint_id(arc_id);
+        if (cv_id != current_cv_id)
         {
-            if (V == arc.main_var) continue;
-            // create an arc containing
-            //  1) V unequal to mainVar as main variable            
-            add_back_arc.main_var = V;
-            //  2) remaining Vs as var_list
-            add_back_arc.other_var_list = std::vector<VariableVertex*>();
-            for (auto other_variable : variable_neighbors_of_C) 
+            current_cv_id = cv_id;
+            // ignore the constraint given as part of arc
+            skips_current = (cv_id == ignored_cv_id);
+            if (!skips_current)
             {
-                if (other_variable != V) 
-                    add_back_arc.other_var_list.push_back(other_variable);
+                // a global cardinality constraint has to be filtered again
+                if (cv_id < cardinality_at_fixpoint.size()) cardinality_at_fixpoint[cv_id] = false;
+                // supports of every value in C might all still be there
+                skips_current = (propagation_mode == ResidueMode && removed_values != nullptr && 
+                                 !removalTouchesSupports(graph.constraint_at(cv_id), arc.main_var, *removed_values));
             }
-            //  3) C as constraint
-            add_back_arc.constraint = C;
-            // add it to the frontier
-            frontier.push(add_back_arc);
         }
+        if (skips_current) continue;
+        // arcs already in the frontier are skipped before being built, 
+        // unless pushing them again may move them up the frontier
+        if (!frontier.contains(arc_id) || reorders_on_push) frontier.push(makeArc(graph, arc_id));
     }
 };
 
@@ -227,26 +691,222 @@ void CSPSolverImplementation::CSPSolver::singleArcConsistencyStep(CSPGraph& grap
     // pop one object from frontier
     ARC next_arc = frontier.pop();
 
+    // a global cardinality constraint is filtered for its whole scope at once, which makes
+    // its other arcs redundant until any of its variables changes again
+    if (next_arc.constraint->getKernel().usesMatching())
+    {
+        uint32_t cv_id = next_arc.constraint->getId();
+        if (cv_id < cardinality_at_fixpoint.size() && cardinality_at_fixpoint[cv_id]) return;
+        return reviseCardinalityScope(graph, frontier, cv_id);
+    }
+
+    // remove any domain value of the main var for which the constraint isn't met
+    reduced_at_least_one_domain_value = reviseArc(next_arc);
+
+    // if domain was reduced, add any arc we need to double check
+    if (reduced_at_least_one_domain_value)
+        getAllCheckAgainArcs(frontier, graph, next_arc, &revised_values);
+};
 
-    // for each domain in the main var, check if constraint is met given other vars
-    for (int dom_val : next_arc.main_var->getDomain())
+// removes every value of the main variable of arc for which its constraint isn't met 
+// given the other variables; returns whether the domain of the main variable was reduced
+bool CSPSolverImplementation::CSPSolver::reviseArc(const ARC& arc)
+{
+    revision_count++;
+    revised_values.clear();
+    const GraphImplementation::ConstraintKernel& kernel = arc.constraint->getKernel();
+    // a global cardinality constraint finds the supports of every value at once, through a matching
+    if (kernel.usesMatching()) 
+    {
+        reviseGlobalCardinality(arc);
+    }
+    else
     {
-        // if the constraint isn't consistent:
-        if (!next_arc.constraint->constraintIsMet(dom_val, next_arc.other_var_list))
+        // in ResidueMode, cardinality kernels give the same verdict for every value but the counted one,
+        // which is then only checked once
+        bool shares_verdict = (propagation_mode == ResidueMode && 
+                               kernel.getType() != GraphImplementation::ConstraintKernel::CustomPredicate);
+        int shared_verdict = -1; // -1 until checked, then 0 / 1
+
+        // for each domain in the main var, check if constraint is met given other vars
+        // (iterating the domain store stays valid while we remove the value we are on)
+        for (int dom_val : arc.main_var->getDomainStore())
         {
-            reduced_at_least_one_domain_value = true;
-            // remove that domain from the mix
-            next_arc.main_var->removeFromDomain(dom_val);
+            bool is_met;
+            if (shares_verdict && dom_val != kernel.getCheckedValue())
+            {
+                if (shared_verdict < 0) shared_verdict = arc.constraint->constraintIsMet(dom_val, arc.other_var_list);
+                is_met = (shared_verdict == 1);
+            }
+            else
+            {
+                is_met = arc.constraint->constraintIsMet(dom_val, arc.other_var_list);
+            }
+            // if the constraint isn't consistent:
+            if (!is_met)
+            {
+                // remove that domain from the mix, through the trail so that it can be undone
+                trail.removeFromDomain(arc.main_var, dom_val);
+                revised_values.push_back(dom_val);
+            }
         }
     }
+    // the removals are explained by whatever reduced the other variables of the constraint
+    if (backtrack_mode == BackjumpingMode && !revised_values.empty()) explainer.explainBy(arc.main_var, arc.other_var_list);
+    // a wiped out domain makes the constraint weigh more for DomainOverWeightedDegree
+    if (arc.main_var->getDomainStore().empty() && arc.constraint->getId() < constraint_weights.size())
+        constraint_weights[arc.constraint->getId()]++;
+    return !revised_values.empty();
+};
 
-    // if domain was reduced, add any arc we need to double check
-    if (reduced_at_least_one_domain_value)
-        getAllCheckAgainArcs(frontier, graph, next_arc);
+// removes every value of the main variable of arc that no matching of the scope of its 
+// global cardinality or alldifferent constraint gives it, or every value if there is no such matching
+void CSPSolverImplementation::CSPSolver::reviseGlobalCardinality(const ARC& arc)
+{
+    cardinality_scope.assign(1, arc.main_var);
+    cardinality_scope.insert(cardinality_scope.end(), arc.other_var_list.begin(), arc.other_var_list.end());
+    bool has_matching = arc.constraint->getKernel().matchingSupports(cardinality_scope, unsupported_values);
+    for (int dom_val : arc.main_var->getDomainStore())
+    {
+        if (has_matching && 
+            std::find(unsupported_values[0].begin(), unsupported_values[0].end(), dom_val) == unsupported_values[0].end()) 
+            continue;
+        trail.removeFromDomain(arc.main_var, dom_val);
+        revised_values.push_back(dom_val);
+    }
+};
+
+// removes every value of each variable of the global cardinality or alldifferent constraint cv_id that
+// no matching of its scope gives it, adding the arcs to check again for each reduced variable
+// the matching found last time for cv_id is repaired rather than built again from nothing
+void CSPSolverImplementation::CSPSolver::reviseCardinalityScope(CSPGraph& graph, Frontier& frontier, uint32_t cv_id)
+{
+    revision_count++;
+    GraphImplementation::ConstraintVertex* cv = graph.constraint_at(cv_id);
+    IdSpan scope = graph.variable_neighbor_ids(cv_id);
+    cardinality_scope.clear();
+    for (uint32_t vv_id : scope) cardinality_scope.push_back(graph.variable_at(vv_id));
+    ARC reduced;
+    reduced.constraint = cv;
+    std::vector<int>* last_matching = (cv_id < cardinality_matchings.size()) ? &cardinality_matchings[cv_id] : nullptr;
+    if (!cv->getKernel().matchingSupports(cardinality_scope, unsupported_values, last_matching))
+    {
+        // no matching at all: wiping out the first domain fails the branch
+        if (cardinality_scope.empty()) return;
+        reduced.main_var = cardinality_scope[0];
+        if (backtrack_mode == BackjumpingMode) explainer.explainBy(reduced.main_var, cardinality_scope);
+        for (int dom_val : reduced.main_var->getDomainStore()) trail.removeFromDomain(reduced.main_var, dom_val);
+        if (cv_id < constraint_weights.size()) constraint_weights[cv_id]++;
+        return;
+    }
+    if (cv_id < cardinality_at_fixpoint.size()) cardinality_at_fixpoint[cv_id] = true;
+    for (size_t position = 0; position < cardinality_scope.size(); position++)
+    {
+        if (unsupported_values[position].empty()) continue;
+        reduced.main_var = cardinality_scope[position];
+        if (backtrack_mode == BackjumpingMode) explainer.explainBy(reduced.main_var, cardinality_scope);
+        for (int dom_val : unsupported_values[position]) trail.removeFromDomain(reduced.main_var, dom_val);
+        getAllCheckAgainArcs(frontier, graph, reduced, &unsupported_values[position]);
+    }
+};
+
+// whether removing removed_values from vv, whose domain is what remains, may have 
+// removed a support of any value in the constraint cv, as used in ResidueMode
+bool CSPSolverImplementation::CSPSolver::removalTouchesSupports(const GraphImplementation::ConstraintVertex* cv,
+                                                                const VariableVertex* vv,
+                                                                const std::vector<int>& removed_values) const
+{
+    const GraphImplementation::ConstraintKernel& kernel = cv->getKernel();
+    if (kernel.getType() == GraphImplementation::ConstraintKernel::CustomPredicate || kernel.usesMatching()) return true;
+
+    int checked_value = kernel.getCheckedValue();
+    // vv can't be the counted value anymore, changing how many variables can be it
+    bool no_longer_possible = 
+        (std::find(removed_values.begin(), removed_values.end(), checked_value) != removed_values.end());
+    // vv is now forced to be the counted value, changing how many variables have to be it
+    // (an emptied domain makes the branch fail anyway)
+    const GraphImplementation::Domain& domain = vv->getDomainStore();
+    bool now_forced = (domain.size() == 1 && domain.contains(checked_value));
+
+    switch (kernel.getType())
+    {
+        case GraphImplementation::ConstraintKernel::LesserOrEqualToN: return now_forced;
+        case GraphImplementation::ConstraintKernel::GreaterOrEqualToN: return no_longer_possible;
+        default: return (no_longer_possible || now_forced);
+    }
+};
+
+// assigns the unassigned variable with minimum remaining values to each of its values in turn,
+// forward checking then recursing; returns every answer found below the current assignment
+void CSPSolverImplementation::CSPSolver::depthFirstSearch_recursive(CSPGraph& graph, std::vector<bool>& assigned)
+{
+    // enough answers were found already
+    if (stop_requested) return;
+
+    // pick the unassigned variable with the smallest domain, ties going to the smallest id
+    // variables reduced to a single value are picked first, as their constraints still need checking
+    uint32_t next_var_id = GraphImplementation::Vertex::NO_ID;
+    for (uint32_t vv_id = 0; vv_id < graph.num_variables(); vv_id++)
+    {
+        if (assigned[vv_id]) continue;
+        if (next_var_id == GraphImplementation::Vertex::NO_ID || 
+            graph.variable_at(vv_id)->getDomainSize() < graph.variable_at(next_var_id)->getDomainSize())
+            next_var_id = vv_id;
+    }
+
+    // every variable is assigned & was forward checked: this is an answer
+    // (forward checking leaves every assigned variable with its single value)
+    if (next_var_id == GraphImplementation::Vertex::NO_ID)
+    {
+        reportSolution(graph);
+        return;
+    }
+
+    VariableVertex* next_var = graph.variable_at(next_var_id);
+    // the domain changes while we branch, hence iterate over a snapshot of it
+    std::vector<int> values(next_var->getDomainStore().begin(), next_var->getDomainStore().end());
+    assigned[next_var_id] = true;
+    for (int dom_val : values)
+    {
+        // every removal from here on is undone once this value is explored
+        trail.markChoicePoint();
+        trail.restrictDomainTo(next_var, dom_val);
+
+        // only recurse if no domain was wiped out by forward checking
+        if (forwardCheck(graph, next_var_id))
+        {
+            depth++;
+            depthFirstSearch_recursive(graph, assigned);
+            depth--;
+        }
+        // backtrack
+        trail.undoToLastChoicePoint();
+        if (stop_requested) break;
+    }
+    assigned[next_var_id] = false;
+};
+
+// revises once every arc of the constraints touching the variable vv_id that was just assigned
+// returns false if the domain of any variable was wiped out
+bool CSPSolverImplementation::CSPSolver::forwardCheck(CSPGraph& graph, uint32_t vv_id)
+{
+    for (uint32_t cv_id : graph.constraint_neighbor_ids(vv_id))
+    {
+        // the arc of the assigned variable itself is revised too, which checks
+        // constraints whose scope is already fully assigned as well as unary ones
+        IdSpan scope = graph.variable_neighbor_ids(cv_id);
+        for (uint32_t position = 0; position < scope.size(); position++)
+        {
+            reviseArc(makeArc(graph, graph.arc_id(cv_id, position)));
+            if (graph.variable_at(scope[position])->getDomainStore().empty()) return false;
+        }
+    }
+    return true;
 };
 
 // checks the existence of a unique solution, returned as vector of Variables with unique domain
 // also return a boolean of "true" if we have a unique / no answer, false if indeterminate
+// this scans every variable; searches rely on the domain counts kept by the trail instead
 std::tuple<std::vector<GraphImplementation::VariableVertex>, bool>
 CSPSolverImplementation::CSPSolver::checkAnswer(CSPSolverImplementation::CSPGraph& graph)
 {
@@ -254,17 +914,19 @@ CSPSolverImplementation::CSPSolver::checkAnswer(CSPSolverImplementation::CSPGrap
     bool determinate_result = true;
 
     // for every variable in graph, check domain size
-    for (std::string vv_name : graph.get_all_variable_names())
+    graph.freeze();
+    returned.reserve(graph.num_variables());
+    for (uint32_t vv_id = 0; vv_id < graph.num_variables(); vv_id++)
     {
-        VariableVertex* vv = graph.get_variable(vv_name);
+        VariableVertex* vv = graph.variable_at(vv_id);
         // if any is 0, return an empty vector
-        if (vv->getDomain().size() == 0)
+        if (vv->getDomainSize() == 0)
         {
             return std::tuple<std::vector<VariableVertex>, bool>({
                 std::vector<VariableVertex>(), true
                 });
         // if any is >= 2, return the set of possible values & false bool
-        } else if (vv->getDomain().size() >= 2)
+        } else if (vv->getDomainSize() >= 2)
         {
             determinate_result = false;
         }
@@ -279,6 +941,44 @@ CSPSolverImplementation::CSPSolver::checkAnswer(CSPSolverImplementation::CSPGrap
 };
 
 
+// picks the variable to split the domain of, as set by the branching heuristic
+// REQUIRES that some variable of graph has two values or more
+uint32_t CSPSolverImplementation::CSPSolver::pickSplitVariable(const CSPGraph& graph) const
+{
+    uint32_t picked_id = GraphImplementation::Vertex::NO_ID;
+    // the picked variable's domain size & (weighted) degree; ratios are compared by cross-multiplying
+    uint64_t picked_dom = 0, picked_deg = 0;
+
+    for (uint32_t vv_id = 0; vv_id < graph.num_variables(); vv_id++)
+    {
+        uint64_t dom = graph.variable_at(vv_id)->getDomainSize();
+        if (dom <= 1) continue;
+        if (branching_heuristic == InputOrder) return vv_id;
+
+        uint64_t deg = 0;
+        if (branching_heuristic == DomainOverWeightedDegree)
+            for (uint32_t cv_id : graph.constraint_neighbor_ids(vv_id)) 
+                deg += 1 + ((cv_id < constraint_weights.size()) ? constraint_weights[cv_id] : 0);
+        else 
+            deg = graph.constraint_neighbor_ids(vv_id).size();
+
+        bool is_better;
+        if (picked_id == GraphImplementation::Vertex::NO_ID) is_better = true;
+        else if (branching_heuristic == SmallestDomain) is_better = (dom < picked_dom);
+        else if (branching_heuristic == LargestDegree) is_better = (deg > picked_deg);
+        // dom / deg < picked_dom / picked_deg, a variable without constraints coming last
+        else is_better = (dom * picked_deg < picked_dom * deg);
+
+        if (is_better)
+        {
+            picked_id = vv_id;
+            picked_dom = dom;
+            picked_deg = deg;
+        }
+    }
+    return picked_id;
+};
+
 // splits domain of specific variable and returns all generated graphs
 std::vector<CSPSolverImplementation::CSPGraph> 
 CSPSolverImplementation::CSPSolver::splitDomain(const CSPSolverImplementation::CSPGraph& graph, 
@@ -287,23 +987,212 @@ CSPSolverImplementation::CSPSolver::splitDomain(const CSPSolverImplementation::C
     std::vector<CSPGraph> returned;
 
     // if domain of given vv is empty, return empty vector
-    if (vv->getDomain().empty()) return std::vector<CSPGraph>();
+    if (vv->getDomainStore().empty()) return std::vector<CSPGraph>();
     // otherwise, if domain has more than one value
     // for domain values in given vv:
-    for (int dom_val : vv->getDomain())
+    for (int dom_val : vv->getDomainStore())
     {
         //  a) copy graph
         CSPGraph new_graph = graph;
         //  b) remove all value but dom_val from new_graph vv's domain
-        VariableVertex* vv_in_new_graph = new_graph.get_variable(vv->getName());
-        for (int dom_val_to_remove : vv->getDomain())
-        {
-            if (dom_val_to_remove != dom_val) 
-                vv_in_new_graph->removeFromDomain(dom_val_to_remove);
-        }
+        //     (a copy of a frozen graph keeps the ids of its vertices)
+        VariableVertex* vv_in_new_graph = new_graph.is_frozen() ? 
+            new_graph.variable_at(vv->getId()) : new_graph.get_variable(vv->getName());
+        vv_in_new_graph->restrictDomainTo(dom_val);
         //  c) add new_graph to returned list of graphs
-        returned.push_back(new_graph);
+        returned.push_back(std::move(new_graph));
     }
 
     return returned;
-};
\ No newline at end of file
+};
+
+// builds the arc with given id from the frozen view of graph
+CSPSolverImplementation::ARC CSPSolverImplementation::CSPSolver::makeArc(const CSPGraph& graph, uint32_t arc_id)
+{
+    ARC returned;
+    returned.arc_id = arc_id;
+    uint32_t cv_id = graph.arc_constraint_id(arc_id);
+    uint32_t main_var_id = graph.arc_main_variable_id(arc_id);
+    returned.main_var = graph.variable_at(main_var_id);
+    returned.constraint = graph.constraint_at(cv_id);
+
+    IdSpan scope = graph.variable_neighbor_ids(cv_id);
+    returned.other_var_list.reserve(scope.size() - 1);
+    for (uint32_t vv_id : scope)
+        if (vv_id != main_var_id) returned.other_var_list.push_back(graph.variable_at(vv_id));
+    return returned;
+};
+
+// drops anything left over by an earlier search, and starts reporting answers to search_visitor
+void CSPSolverImplementation::CSPSolver::startSearch(CSPGraph& graph, SolutionVisitor& search_visitor)
+{
+    // the solver works on the index-based view of the graph from here on
+    graph.freeze();
+    trail.clear();
+    countDomains(graph);
+    constraint_weights.assign(graph.num_constraints(), 0);
+    cardinality_at_fixpoint.assign(graph.num_constraints(), false);
+    cardinality_matchings.assign(graph.num_constraints(), {});
+    // explanations are only kept track of when they may be used
+    explainer.reset((backtrack_mode == BackjumpingMode) ? graph.num_variables() : 0);
+    nogoods.clear();
+    failure_explained = false;
+    skipped_node_count = 0;
+    learned_nogood_count = 0;
+    depth = 0;
+    revision_count = 0;
+    visitor = &search_visitor;
+    solution_count = 0;
+    expanded_solution_count = 0;
+    // symmetries & the cache are only used by arc consistency, see startArcConsistency
+    symmetries.clear();
+    reported_orbits.clear();
+    caching = false;
+    trail.setHashing(false);
+    recorded_values.clear();
+    recording_depth = 0;
+    component_count = 1;
+    // a limit of 0 answers leaves nothing to search for
+    stop_requested = (answersWanted() == 0);
+};
+
+// counts the empty & single valued domains of graph, for the trail to keep them up to date,
+// and hashes every domain if the trail is hashing
+void CSPSolverImplementation::CSPSolver::countDomains(const CSPGraph& graph)
+{
+    size_t empty_domains = 0, single_domains = 0;
+    for (uint32_t vv_id = 0; vv_id < graph.num_variables(); vv_id++)
+    {
+        size_t domain_size = graph.variable_at(vv_id)->getDomainSize();
+        if (domain_size == 0) empty_domains++;
+        else if (domain_size == 1) single_domains++;
+    }
+    trail.setDomainCounts(empty_domains, single_domains);
+    if (!trail.isHashing()) return;
+    uint64_t domain_hash = 0, check_hash = 0;
+    for (uint32_t vv_id = 0; vv_id < graph.num_variables(); vv_id++)
+        for (int val : graph.variable_at(vv_id)->getDomainStore())
+        {
+            domain_hash ^= Trail::valueKey(vv_id, val, 0);
+            check_hash ^= Trail::valueKey(vv_id, val, 1);
+        }
+    trail.setDomainHashes(domain_hash, check_hash);
+};
+
+// reports the answer held by graph, whose variables all have a single domain value, to the visitor
+void CSPSolverImplementation::CSPSolver::reportSolution(const CSPGraph& graph)
+{
+    // answers are never looked at when only counting, unless they are to be weighed
+    if (solve_mode == CountOnlyMode && !weighsAnswers()) return reportSolution(graph, nullptr);
+    solution_values.resize(graph.num_variables());
+    for (uint32_t vv_id = 0; vv_id < graph.num_variables(); vv_id++)
+        solution_values[vv_id] = graph.variable_at(vv_id)->getDomainStore().min();
+    reportSolution(graph, solution_values.data());
+};
+
+// reports an answer given as the value of each variable of graph, numbered by id, to the visitor
+void CSPSolverImplementation::CSPSolver::reportSolution(const CSPGraph& graph, const int* values)
+{
+    // states being searched below keep the answers found, for the cache
+    if (recording_depth > 0 && values != nullptr) recorded_values.insert(recorded_values.end(), values, values + graph.num_variables());
+    size_t multiplicity = 1;
+    if (weighsAnswers())
+    {
+        // with both variables & values interchangeable, the lex-leader constraints may leave several 
+        // answers symmetric to each other, of which only the first one is reported
+        if (!symmetries.getVariableClasses().empty() && !symmetries.getValueClasses().empty() &&
+            !reported_orbits.insert(symmetries.orbitKey(values)).second) return;
+        multiplicity = symmetries.orbitSize(values);
+    }
+    reportWeighedSolution(graph, values, multiplicity);
+};
+
+// reports an answer standing for multiplicity answers, as reportSolution once it was weighed
+void CSPSolverImplementation::CSPSolver::reportWeighedSolution(const CSPGraph& graph, const int* values, size_t multiplicity)
+{
+    solution_count++;
+    expanded_solution_count = (expanded_solution_count > SIZE_MAX - multiplicity) ? SIZE_MAX : 
+                              expanded_solution_count + multiplicity;
+    if (solve_mode != CountOnlyMode && (*visitor)(AssignmentView(graph, values, multiplicity)) == StopSearching) 
+        stop_requested = true;
+    if (solution_count >= answersWanted()) stop_requested = true;
+};
+
+// searches each connected component of graph with a copy of this solver, then reports the 
+// answers of graph as combinations of theirs; returns false, doing nothing, unless in 
+// ComponentMode with two components or more
+bool CSPSolverImplementation::CSPSolver::searchComponents(const Frontier& frontier, const CSPGraph& graph)
+{
+    if (decomposition_mode != ComponentMode) return false;
+    std::vector<std::vector<uint32_t>> components = graph.connected_components();
+    if (components.size() < 2) return false;
+    component_count = components.size();
+    auto saturating_product = [](size_t a, size_t b) { return (a != 0 && b > SIZE_MAX / a) ? SIZE_MAX : a * b; };
+
+    // answers of each component as the values of its variables, one answer after the other, 
+    // & the number of answers each of them stands for
+    std::vector<std::vector<int>> component_values(components.size());
+    std::vector<std::vector<size_t>> component_multiplicities(components.size());
+    size_t combined_count = 1, combined_expanded_count = 1;
+    // a component without any answer leaves none to the whole graph, the others needn't be searched
+    for (size_t i = 0; i < components.size() && combined_count > 0 && !stop_requested; i++)
+    {
+        // each component needs as many answers as the whole graph, the copy sharing the settings & cache
+        CSPSolver component_solver = *this;
+        component_solver.decomposition_mode = WholeGraphMode;
+        std::vector<int>& values = component_values[i];
+        std::vector<size_t>& weights = component_multiplicities[i];
+        component_solver.arcConsistency(graph.induced_subgraph(components[i]), frontier, 
+                                        [&values, &weights](const AssignmentView& answer)
+        {
+            for (uint32_t vv_id = 0; vv_id < answer.size(); vv_id++) values.push_back(answer.valueAt(vv_id));
+            weights.push_back(answer.multiplicity());
+            return KeepSearching;
+        });
+        revision_count += component_solver.revision_count;
+        skipped_node_count += component_solver.skipped_node_count;
+        learned_nogood_count += component_solver.learned_nogood_count;
+        combined_count = saturating_product(combined_count, component_solver.solution_count);
+        combined_expanded_count = saturating_product(combined_expanded_count, component_solver.expanded_solution_count);
+    }
+    // answers weren't buffered when only counting, their product being all there is to know
+    if (solve_mode == CountOnlyMode)
+    {
+        solution_count = combined_count;
+        expanded_solution_count = combined_expanded_count;
+        return true;
+    }
+
+    // combinations are gone through as on an odometer, only built one at a time
+    std::vector<size_t> picked(components.size(), 0);
+    std::vector<int> values(graph.num_variables());
+    while (combined_count > 0 && !stop_requested)
+    {
+        size_t multiplicity = 1;
+        for (size_t i = 0; i < components.size(); i++)
+        {
+            const std::vector<uint32_t>& component = components[i];
+            const int* picked_values = component_values[i].data() + picked[i] * component.size();
+            for (size_t j = 0; j < component.size(); j++) values[component[j]] = picked_values[j];
+            multiplicity = saturating_product(multiplicity, component_multiplicities[i][picked[i]]);
+        }
+        reportWeighedSolution(graph, values.data(), multiplicity);
+        // the last component turns fastest, carrying over to the one before once it went through every answer
+        size_t turned = components.size();
+        for (; turned > 0; turned--)
+        {
+            if (++picked[turned - 1] < component_multiplicities[turned - 1].size()) break;
+            picked[turned - 1] = 0;
+        }
+        if (turned == 0) break;
+    }
+    return true;
+};
+
+// number of answers after which the search stops, as set by the solve mode
+size_t CSPSolverImplementation::CSPSolver::answersWanted() const
+{
+    if (solve_mode == FirstSolutionMode) return 1;
+    else if (solve_mode == SolutionLimitMode) return solution_limit;
+    else return SIZE_MAX;
+};
@@ -17,14 +17,26 @@
 #ifndef CSPSOLVER_H
 #define CSPSOLVER_H
 
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <set>
 #include <string>
 #include <tuple>
 #include <unordered_map>
 #include <vector>
 
+#include "src/cspSolver/AssignmentView.h"
+#include "src/cspSolver/cache/TranspositionCache.h"
 #include "src/cspSolver/CSPGraph.h"
 #include "src/cspSolver/frontier/Frontier.h"
+#include "src/cspSolver/nogood/ConflictExplainer.h"
+#include "src/cspSolver/nogood/NogoodStore.h"
+#include "src/cspSolver/parallel/ThreadPool.h"
+#include "src/cspSolver/symmetry/SymmetryGroup.h"
+#include "src/cspSolver/trail/Trail.h"
 #include "src/graphImplementation/Graph.h"
+#include "src/graphImplementation/vertices/ConstraintVertex.h"
 #include "src/graphImplementation/vertices/VariableVertex.h"
 
 // friending from test class so that private functions are testable
@@ -36,53 +48,361 @@ namespace _unit_test_befriender
 
 namespace CSPSolverImplementation 
 {
+    // forward declaration for befriending
+    class CSPSession;
 
     class CSPSolver 
     {
+        public:
+            // how branches are explored after splitting a domain:
+            // - CopyMode copies the whole graph once per domain value
+            // - TrailMode keeps one graph, undoing removals through a trail on backtrack
+            // - ParallelMode solves branches above the spawn cutoff depth as tasks of a 
+            //   work-stealing thread pool, each on its own copy of the graph; deeper 
+            //   branches are explored as in TrailMode by the thread that owns them
+            enum SearchMode { CopyMode, TrailMode, ParallelMode };
+            // which answers a search looks for:
+            // - AllSolutionsMode enumerates every answer
+            // - FirstSolutionMode stops at the first answer found
+            // - SolutionLimitMode stops once the solution limit is reached
+            // - CountOnlyMode enumerates every answer without building any of them; visitors aren't
+            //   called & the vector returning searches come back empty, see getSolutionCount
+            enum SolveMode { AllSolutionsMode, FirstSolutionMode, SolutionLimitMode, CountOnlyMode };
+            // how arc consistency decides which arcs to revise again after a domain was reduced:
+            // - AC3Mode re-queues every arc sharing a constraint with the reduced variable
+            // - ResidueMode keeps in mind what the supports of each constraint rest on; supports of
+            //   the cardinality kernels only rest on their counted value being possible / forced for 
+            //   each variable, so a removal leaving both unchanged re-queues nothing for that constraint, 
+            //   and a revision checks the constraint once for all values but the counted one
+            //   custom predicates, global cardinality & alldifferent constraints are revised as in AC3Mode
+            enum PropagationMode { AC3Mode, ResidueMode };
+            // which variable arc consistency splits the domain of once propagation stalls,
+            // among those left with two values or more; ties go to the smallest id:
+            // - InputOrder picks the first one in the order variables were added
+            // - SmallestDomain picks the one with the fewest values left (MRV)
+            // - LargestDegree picks the one touching the most constraints
+            // - DomainOverDegree picks the one with the smallest ratio of values left to constraints
+            // - DomainOverWeightedDegree weighs each constraint by 1 + the number of times revising it 
+            //   wiped out a domain during the current search, so that branching focuses on the
+            //   constraints causing failures
+            enum BranchingHeuristic { InputOrder, SmallestDomain, LargestDegree, DomainOverDegree, DomainOverWeightedDegree };
+            // how arc consistency goes back up once every value of a split variable was explored:
+            // - ChronologicalMode goes back to the branching right above, trying its next value
+            // - BackjumpingMode keeps track of the branchings each domain removal results from; a failed
+            //   branch goes back to the deepest branching its failure results from, skipping the values
+            //   left above it, and the branchings a split variable failed for are learned as a nogood, 
+            //   ruling them out in later branches; see ConflictExplainer & NogoodStore
+            //   branches run as separate tasks in ParallelMode only backjump within themselves
+            enum BacktrackMode { ChronologicalMode, BackjumpingMode };
+            // how arc consistency deals with interchangeable variables & values, see SymmetryGroup:
+            // - NoSymmetryBreaking reports every answer
+            // - LexLeaderMode only looks for answers where interchangeable variables take non-decreasing
+            //   values in the order of their ids, & where each interchangeable value is first taken after 
+            //   the smaller ones of its class; values that can't lead to such an answer are removed during
+            //   propagation, and at least one answer of every set of symmetric answers is left
+            // - CanonicalMode also reports a single answer of every set of symmetric answers, handing the 
+            //   number of answers it stands for to the visitor, see AssignmentView::multiplicity
+            //   when variables & values are both interchangeable, the sets reported are kept in mind
+            // depthFirstSearchWithPruning always reports every answer
+            enum SymmetryMode { NoSymmetryBreaking, LexLeaderMode, CanonicalMode };
+            // whether arc consistency splits the graph into independent parts first:
+            // - WholeGraphMode searches the graph as a whole
+            // - ComponentMode searches each connected component on its own, variables being connected through
+            //   the constraints they share, then reports the answers of the graph one combination of theirs 
+            //   at a time, or multiplies their numbers in CountOnlyMode; answers come ordered by component,
+            //   the component holding the last variable changing fastest, and symmetries are only looked 
+            //   for within each component
+            // depthFirstSearchWithPruning always searches the whole graph
+            enum DecompositionMode { WholeGraphMode, ComponentMode };
+            // returned by a solution visitor to tell whether the search should go on
+            enum VisitorAction { KeepSearching, StopSearching };
+            // called with a view of each answer as soon as it is found; the view
+            // is only valid during the call, see AssignmentView
+            using SolutionVisitor = std::function<VisitorAction(const AssignmentView&)>;
+
         private:
             CSPGraph cspGraph;
+            SearchMode search_mode;
+            SolveMode solve_mode;
+            size_t solution_limit;
+            PropagationMode propagation_mode;
+            BranchingHeuristic branching_heuristic;
+            BacktrackMode backtrack_mode;
+            SymmetryMode symmetry_mode;
+            DecompositionMode decomposition_mode;
+            // records domain removals made inside branches, used in TrailMode;
+            // every search changes domains through it, keeping count of empty & single valued domains
+            Trail trail;
+            // number of branchings above the one currently explored
+            size_t depth;
+            // ParallelMode settings, and the pool used during a parallel search
+            size_t thread_count;
+            size_t spawn_cutoff_depth;
+            ThreadPool* pool;
+            // number of arc revisions made by the last search, used to measure its work
+            size_t revision_count;
+            // visitor answers of the current search are reported to, and what it told us so far
+            SolutionVisitor* visitor;
+            bool stop_requested;
+            size_t solution_count;
+            // scratch buffer holding the values of the answer being reported
+            std::vector<int> solution_values;
+            // values removed by the last call to reviseArc
+            std::vector<int> revised_values;
+            // weight of each constraint by id, used by DomainOverWeightedDegree
+            std::vector<size_t> constraint_weights;
+            // whether each global cardinality or alldifferent constraint, by id, was filtered since any of its
+            // variables changed
+            std::vector<bool> cardinality_at_fixpoint;
+            // value of each variable in the last matching found for each of those constraints, by id; only
+            // a starting point for the next one, hence never undone when backtracking
+            std::vector<std::vector<int>> cardinality_matchings;
+            // scratch buffers used to revise global cardinality & alldifferent constraints
+            std::vector<GraphImplementation::VariableVertex*> cardinality_scope;
+            std::vector<std::vector<int>> unsupported_values;
+            // used in BackjumpingMode: the branchings domain removals result from, & the nogoods learned
+            ConflictExplainer explainer;
+            NogoodStore nogoods;
+            // levels of the branchings the branch explored last failed for, if it failed 
+            // without finding any answer nor being stopped
+            LevelSet failure_levels;
+            bool failure_explained;
+            // statistics of the last search in BackjumpingMode
+            size_t skipped_node_count;
+            size_t learned_nogood_count;
+            // used unless in NoSymmetryBreaking: the interchangeable variables & values of the graph searched,
+            // and in CanonicalMode the keys of the sets of symmetric answers reported so far
+            SymmetryGroup symmetries;
+            std::set<std::vector<int>> reported_orbits;
+            // number of answers the answers found by the last search stand for
+            size_t expanded_solution_count;
+            // number of answers each answer returned by the last vector returning arcConsistency stands for
+            std::vector<size_t> multiplicities;
+            // results of the states searched so far, shared by every copy of this solver
+            std::shared_ptr<TranspositionCache> transpositions;
+            // whether the current search uses the cache, and the fingerprint of the constraints it searches
+            bool caching;
+            uint64_t graph_fingerprint;
+            // values of the answers found while searching below states whose result is to be cached, 
+            // one answer after the other, & the number of such states being searched
+            std::vector<int> recorded_values;
+            size_t recording_depth;
+            // number of independent parts the last search went through one at a time
+            size_t component_count;
             
             // befriend TestBefriender to allow testing of private functions
             friend struct _unit_test_befriender::TestBefriender;
+            // sessions propagate & search from their current state using the steps below
+            friend class CSPSolverImplementation::CSPSession;
             
             // trampoline for starting a call to arc consistency
             // enables recursive calls after domain splitting
-            std::vector<std::vector<GraphImplementation::VariableVertex>>
-            arcConsistency_trampoline(Frontier& frontier, CSPGraph& graph);
+            void arcConsistency_trampoline(Frontier& frontier, CSPGraph& graph);
+            // revises arcs in frontier until it is depleted or a domain is wiped out, 
+            // checking learned nogoods each time the frontier is depleted in BackjumpingMode
+            void propagate(Frontier& frontier, CSPGraph& graph);
+            // runs the trampoline on the arcs in frontier, within a thread pool in ParallelMode
+            void runArcConsistency(Frontier& frontier, CSPGraph& graph);
             // populates the given frontier with the set of all arcs to be checked given a CSPGraph
             // used at the beginning when running arc consistency
             void getAllToDoArcs(Frontier& frontier, CSPGraph& graph);
             // populates the given frontier with the set of all arcs to be checked, given 
             // we just checked a certain ARC and reduced the domain of the main variable
-            void getAllCheckAgainArcs(Frontier& frontier, CSPGraph& graph, const ARC& arc);
+            // in ResidueMode, knowing the removed values lets us skip constraints whose supports weren't touched
+            void getAllCheckAgainArcs(Frontier& frontier, CSPGraph& graph, const ARC& arc, 
+                                      const std::vector<int>* removed_values=nullptr);
             // run one arc consistency step on CSPGraph and arcs in Frontier;
             // using differing Frontiers might change the runtime & efficiency of the process
             void singleArcConsistencyStep(CSPGraph& graph, Frontier& frontier);
             // checks the existence of a unique solution, returned as vector of Variables with unique domain
             // also return a boolean of "true" if we have a unique / no answer, false if indeterminate
+            // this scans every variable; searches rely on the domain counts kept by the trail instead
             std::tuple<std::vector<GraphImplementation::VariableVertex>, bool> 
             checkAnswer(CSPGraph& graph);
+            // picks the variable to split the domain of, as set by the branching heuristic
+            // REQUIRES that some variable of graph has two values or more
+            uint32_t pickSplitVariable(const CSPGraph& graph) const;
             // splits domain of specific variable and returns all generated graphs
             std::vector<CSPGraph> splitDomain(const CSPGraph& graph, GraphImplementation::VariableVertex* vv);
+            // explores each value of the split variable on a copy of graph, as in CopyMode
+            void branchOnCopies(Frontier& frontier, CSPGraph& graph, uint32_t split_var_id);
+            // explores each value of the split variable in place, undoing through the trail, as in TrailMode
+            void branchOnTrail(Frontier& frontier, CSPGraph& graph, uint32_t split_var_id);
+            // explores each value of the split variable as a pool task, as in ParallelMode
+            // answers are buffered per branch, then reported in the order of the values,
+            // as if explored sequentially
+            void branchInParallel(Frontier& frontier, CSPGraph& graph, uint32_t split_var_id);
+            // in BackjumpingMode, takes in how the branch just explored at level ended; returns true if
+            // it failed whatever was decided at level, in which case the values_left values still to
+            // try at level are skipped, and the failure is passed up as is through node_failure
+            // otherwise, node_failure & node_explained gather why every branch at level failed so far
+            bool backjumpsPast(size_t level, size_t values_left, LevelSet& node_failure, bool& node_explained);
+            // in BackjumpingMode, ends a branching whose branches failed for node_failure, if node_explained, 
+            // learning the nogood made of the branchings at those levels
+            void endBranching(const LevelSet& node_failure, bool node_explained);
+            // sets the failure of the branch explored last to the explanation of a wiped out domain of graph
+            void explainFailure(const CSPGraph& graph);
+            // removes values ruled out by the learned nogoods whose other decisions all hold, adding the 
+            // arcs to check again; wipes out a domain if every decision of a nogood holds
+            // returns whether any domain was reduced
+            bool propagateNogoods(Frontier& frontier, CSPGraph& graph);
+            // sets up what only arc consistency uses once startSearch was called: the interchangeable 
+            // variables & values of graph unless in NoSymmetryBreaking, and the transposition cache
+            void startArcConsistency(const CSPGraph& graph);
+            // hash of the constraints of graph, which holds no custom predicate
+            uint64_t fingerprintOf(const CSPGraph& graph) const;
+            // reports the answers cached for the state of key again, returning false if none are cached
+            bool reportCachedResult(const CSPGraph& graph, const TranspositionCache::Key& key);
+            // caches the answers found below the state of key since solution_count was solutions_before &
+            // recorded_values held recorded_from values, unless the search below it was cut short
+            void cacheResult(const TranspositionCache::Key& key, size_t solutions_before, size_t recorded_from);
+            // removes values ruled out by the lex-leader constraints over interchangeable variables & values,
+            // adding the arcs to check again; returns whether any domain was reduced
+            bool propagateSymmetries(Frontier& frontier, CSPGraph& graph);
+            // removes revised_values from the domain of variable vv_id, which why explains in BackjumpingMode,
+            // adding the arcs to check again
+            void removeRevisedValues(Frontier& frontier, CSPGraph& graph, uint32_t vv_id, const LevelSet& why);
+            // whether answers are reported with the number of symmetric answers they stand for
+            bool weighsAnswers() const { return (symmetry_mode == CanonicalMode && !symmetries.empty()); };
+            // removes every value of the main variable of arc for which its constraint isn't met 
+            // given the other variables; returns whether the domain of the main variable was reduced
+            bool reviseArc(const ARC& arc);
+            // removes every value of the main variable of arc that no matching of the scope of its 
+            // global cardinality or alldifferent constraint gives it, or every value if there is no such matching
+            void reviseGlobalCardinality(const ARC& arc);
+            // removes every value of each variable of the global cardinality or alldifferent constraint cv_id that
+            // no matching of its scope gives it, adding the arcs to check again for each reduced variable
+            // the matching found last time for cv_id is repaired rather than built again from nothing
+            void reviseCardinalityScope(CSPGraph& graph, Frontier& frontier, uint32_t cv_id);
+            // whether removing removed_values from vv, whose domain is what remains, may have 
+            // removed a support of any value in the constraint cv, as used in ResidueMode
+            bool removalTouchesSupports(const GraphImplementation::ConstraintVertex* cv, 
+                                        const GraphImplementation::VariableVertex* vv, 
+                                        const std::vector<int>& removed_values) const;
+            // assigns the unassigned variable with minimum remaining values to each of its values in turn,
+            // forward checking then recursing; reports every answer found below the current assignment
+            void depthFirstSearch_recursive(CSPGraph& graph, std::vector<bool>& assigned);
+            // revises once every arc of the constraints touching the variable vv_id that was just assigned
+            // returns false if the domain of any variable was wiped out
+            bool forwardCheck(CSPGraph& graph, uint32_t vv_id);
+            // builds the arc with given id from the frozen view of graph
+            ARC makeArc(const CSPGraph& graph, uint32_t arc_id);
+            // drops anything left over by an earlier search, and starts reporting answers to search_visitor
+            void startSearch(CSPGraph& graph, SolutionVisitor& search_visitor);
+            // counts the empty & single valued domains of graph, for the trail to keep them up to date,
+            // and hashes every domain if the trail is hashing
+            void countDomains(const CSPGraph& graph);
+            // reports the answer held by graph, whose variables all have a single domain value, to the visitor
+            void reportSolution(const CSPGraph& graph);
+            // reports an answer given as the value of each variable of graph, numbered by id, to the visitor
+            void reportSolution(const CSPGraph& graph, const int* values);
+            // reports an answer standing for multiplicity answers, as reportSolution once it was weighed
+            void reportWeighedSolution(const CSPGraph& graph, const int* values, size_t multiplicity);
+            // searches each connected component of graph with a copy of this solver, then reports the 
+            // answers of graph as combinations of theirs; returns false, doing nothing, unless in 
+            // ComponentMode with two components or more
+            // frontier is copied for each component, hence should be empty
+            bool searchComponents(const Frontier& frontier, const CSPGraph& graph);
+            // number of answers after which the search stops, as set by the solve mode
+            size_t answersWanted() const;
 
         public:
-            CSPSolver();
+            CSPSolver(SearchMode search_mode=TrailMode);
             ~CSPSolver();
 
-            // save a created CSP graph
-            // *not implemented yet; have to find a way to serialize 
-            // constraints first, and I don't think we need that yet
-            void saveCspGraph(const CSPGraph& graph, std::string saveDir);
-            // load a CSP graph
-            // *not implemented yet; have to find a way to serialize 
-            // constraints first, and I don't think we need that yet
-            void loadCspGraph(std::string loadDir);
+            // getters & setters
+            SearchMode getSearchMode() const { return this->search_mode; };
+            void setSearchMode(SearchMode search_mode) { this->search_mode = search_mode; };
+            // number of threads used in ParallelMode, the calling thread included
+            size_t getThreadCount() const { return this->thread_count; };
+            void setThreadCount(size_t thread_count) { this->thread_count = thread_count; };
+            // branchings at this depth or deeper aren't split into tasks anymore in ParallelMode
+            size_t getSpawnCutoffDepth() const { return this->spawn_cutoff_depth; };
+            void setSpawnCutoffDepth(size_t spawn_cutoff_depth) { this->spawn_cutoff_depth = spawn_cutoff_depth; };
+            SolveMode getSolveMode() const { return this->solve_mode; };
+            void setSolveMode(SolveMode solve_mode) { this->solve_mode = solve_mode; };
+            PropagationMode getPropagationMode() const { return this->propagation_mode; };
+            void setPropagationMode(PropagationMode propagation_mode) { this->propagation_mode = propagation_mode; };
+            BranchingHeuristic getBranchingHeuristic() const { return this->branching_heuristic; };
+            void setBranchingHeuristic(BranchingHeuristic branching_heuristic) 
+            { this->branching_heuristic = branching_heuristic; };
+            BacktrackMode getBacktrackMode() const { return this->backtrack_mode; };
+            void setBacktrackMode(BacktrackMode backtrack_mode) { this->backtrack_mode = backtrack_mode; };
+            // maximum number of nogoods kept during a search in BackjumpingMode; 0 learns none
+            size_t getNogoodLimit() const { return this->nogoods.getCapacity(); };
+            void setNogoodLimit(size_t nogood_limit) { this->nogoods.setCapacity(nogood_limit); };
+            SymmetryMode getSymmetryMode() const { return this->symmetry_mode; };
+            void setSymmetryMode(SymmetryMode symmetry_mode) { this->symmetry_mode = symmetry_mode; };
+            DecompositionMode getDecompositionMode() const { return this->decomposition_mode; };
+            void setDecompositionMode(DecompositionMode decomposition_mode) 
+            { this->decomposition_mode = decomposition_mode; };
+            // number of answers after which a search stops in SolutionLimitMode
+            size_t getSolutionLimit() const { return this->solution_limit; };
+            void setSolutionLimit(size_t solution_limit) { this->solution_limit = solution_limit; };
+            // maximum number of propagated states arc consistency keeps the answers found below of, so that
+            // reaching one again reports them without searching; 0, the default, keeps none
+            // the cache is shared by every copy of this solver, e.g. the searches of a CSPSession or the
+            // workspaces of a BatchSolver, & is used for any graph without symmetries broken nor custom predicates,
+            // what those check being unknown
+            size_t getTranspositionCacheSize() const { return this->transpositions->getCapacity(); };
+            void setTranspositionCacheSize(size_t cache_size) { this->transpositions->setCapacity(cache_size); };
+            // forgets every cached state & resets the counters below
+            void clearTranspositionCache() { this->transpositions->clear(); };
+            // number of states found in the cache / not found in it, & of states forgotten to make room, 
+            // since the cache was created or last cleared
+            size_t getCacheHitCount() const { return this->transpositions->getHitCount(); };
+            size_t getCacheMissCount() const { return this->transpositions->getMissCount(); };
+            size_t getCacheEvictionCount() const { return this->transpositions->getEvictionCount(); };
+            // number of arc revisions made by the last call to arcConsistency / depthFirstSearchWithPruning
+            size_t getRevisionCount() const { return this->revision_count; };
+            // number of answers found by the last call to arcConsistency / depthFirstSearchWithPruning
+            size_t getSolutionCount() const { return this->solution_count; };
+            // number of answers those answers stand for, symmetric answers left out in CanonicalMode included;
+            // the same as getSolutionCount in any other mode
+            size_t getExpandedSolutionCount() const { return this->expanded_solution_count; };
+            // number of answers each answer returned by the last vector returning arcConsistency stands for,
+            // in the same order; all 1 unless in CanonicalMode
+            const std::vector<size_t>& getMultiplicities() const { return this->multiplicities; };
+            // number of branches the last call to arcConsistency skipped by backjumping over them
+            size_t getSkippedNodeCount() const { return this->skipped_node_count; };
+            // number of nogoods learned by the last call to arcConsistency, including those forgotten since
+            size_t getLearnedNogoodCount() const { return this->learned_nogood_count; };
+            // number of connected components the last call to arcConsistency searched one at a time;
+            // 1 when it searched the graph as a whole
+            size_t getComponentCount() const { return this->component_count; };
+
+            // save a created CSP graph to a binary file at savePath; see CSPGraphSerializer
+            // returns false if the graph holds custom predicates or global cardinality constraints, which can't be saved
+            bool saveCspGraph(const CSPGraph& graph, std::string savePath);
+            // load a CSP graph saved with saveCspGraph, which comes out frozen
+            // returns an empty graph if the file is missing or malformed
+            CSPGraph loadCspGraph(std::string loadPath);
 
-            // run arc consistency and return all possible answers
-            std::vector<std::vector<GraphImplementation::VariableVertex>> arcConsistency(CSPGraph graph);
+            // run arc consistency and return all possible answers, or as many as the solve mode asks for
+            // the frontier mode & heuristic set the order in which arcs are checked
+            std::vector<std::vector<GraphImplementation::VariableVertex>> arcConsistency(
+                CSPGraph graph, 
+                Frontier::FrontierMode mode=Frontier::QueueMode, 
+                Frontier::ArcHeuristic heuristic=Frontier::SmallestDomainFirst);
+            // run arc consistency using the given empty frontier, e.g. one created with a custom comparator
+            std::vector<std::vector<GraphImplementation::VariableVertex>> arcConsistency(CSPGraph graph, Frontier frontier);
+            // run arc consistency, handing each answer to visitor as soon as it is found instead of 
+            // collecting them; the search ends early once visitor returns StopSearching
+            // returns the number of answers found
+            size_t arcConsistency(
+                CSPGraph graph, 
+                SolutionVisitor visitor,
+                Frontier::FrontierMode mode=Frontier::QueueMode, 
+                Frontier::ArcHeuristic heuristic=Frontier::SmallestDomainFirst);
+            size_t arcConsistency(CSPGraph graph, Frontier frontier, SolutionVisitor visitor);
             
-            // run DFS with pruning and return all possible answers
+            // run DFS with pruning and return all possible answers, in the same format as arcConsistency
+            // variables are assigned one at a time by minimum remaining values, forward checking only 
+            // the constraints touching the assigned variable; backtracking always goes through the trail
             std::vector<std::vector<GraphImplementation::VariableVertex>> depthFirstSearchWithPruning(CSPGraph graph);
+            // run DFS with pruning, handing each answer to visitor as soon as it is found
+            // the search ends early once visitor returns StopSearching; returns the number of answers found
+            size_t depthFirstSearchWithPruning(CSPGraph graph, SolutionVisitor visitor);
 
             // creates and returns a CSPGraph
             static CSPGraph createCspGraph();
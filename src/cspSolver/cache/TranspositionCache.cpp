@@ -0,0 +1,115 @@
+// Author: Akira Kudo
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "src/cspSolver/cache/TranspositionCache.h"
+
+CSPSolverImplementation::TranspositionCache::TranspositionCache(size_t capacity)
+    : capacity(capacity), hit_count(0), miss_count(0), eviction_count(0)
+{
+
+};
+
+CSPSolverImplementation::TranspositionCache::~TranspositionCache()
+{
+
+};
+
+// the result kept for key, which becomes the state used most recently, or nullptr if there is none
+std::shared_ptr<const CSPSolverImplementation::TranspositionCache::Result>
+CSPSolverImplementation::TranspositionCache::find(const Key& key)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = index.find(key);
+    if (found == index.end())
+    {
+        miss_count++;
+        return nullptr;
+    }
+    hit_count++;
+    entries.splice(entries.begin(), entries, found->second);
+    return found->second->second;
+};
+
+// keeps result for key, forgetting the state used least recently if capacity states are kept already
+// nothing is kept when capacity is 0
+void CSPSolverImplementation::TranspositionCache::insert(const Key& key, Result result)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (capacity == 0) return;
+    auto found = index.find(key);
+    // another thread may have searched the same state meanwhile, finding the same answers
+    if (found != index.end())
+    {
+        entries.splice(entries.begin(), entries, found->second);
+        return;
+    }
+    entries.emplace_front(key, std::make_shared<const Result>(std::move(result)));
+    index.emplace(key, entries.begin());
+    evictToCapacity();
+};
+
+// forgets every state & resets every counter
+void CSPSolverImplementation::TranspositionCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    index.clear();
+    hit_count = 0;
+    miss_count = 0;
+    eviction_count = 0;
+};
+
+size_t CSPSolverImplementation::TranspositionCache::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+};
+
+size_t CSPSolverImplementation::TranspositionCache::getCapacity() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return capacity;
+};
+
+// maximum number of states kept; lowering it forgets the states used least recently
+void CSPSolverImplementation::TranspositionCache::setCapacity(size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    this->capacity = capacity;
+    evictToCapacity();
+};
+
+size_t CSPSolverImplementation::TranspositionCache::getHitCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return hit_count;
+};
+
+size_t CSPSolverImplementation::TranspositionCache::getMissCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return miss_count;
+};
+
+size_t CSPSolverImplementation::TranspositionCache::getEvictionCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return eviction_count;
+};
+
+// ####################
+// PRIVATE FUNCTIONS
+// forgets the states used least recently until at most capacity are left
+void CSPSolverImplementation::TranspositionCache::evictToCapacity()
+{
+    while (entries.size() > capacity)
+    {
+        index.erase(entries.back().first);
+        entries.pop_back();
+        eviction_count++;
+    }
+};
@@ -0,0 +1,95 @@
+// Author: Akira Kudo
+// Description: Implements a bounded cache of what searching below a propagated state gave.
+//  A state is keyed by a fingerprint of the constraints of the graph searched & by two
+//  independent hashes of every domain, kept up to date by the trail on each removal; the
+//  result is the answers found below that state, or only their number when counting.
+//  Within one search, branching on distinct values never reaches the same state twice, but
+//  searching again after a new fact, or the next problem of a batch sharing its constraints,
+//  often does; copies of a solver hence share its cache, which is safe to use from several
+//  threads at once. Once full, the cache forgets the state used least recently.
+
+#ifndef TRANSPOSITIONCACHE_H
+#define TRANSPOSITIONCACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace CSPSolverImplementation
+{
+    class TranspositionCache
+    {
+    public:
+        // identifies a propagated state of a graph
+        struct Key
+        {
+            uint64_t graph_fingerprint;
+            uint64_t domain_hash;
+            uint64_t check_hash;
+            // whether only the number of answers is kept
+            bool counted;
+
+            bool operator==(const Key& other) const
+            {
+                return graph_fingerprint == other.graph_fingerprint && domain_hash == other.domain_hash &&
+                       check_hash == other.check_hash && counted == other.counted;
+            };
+        };
+        // what searching below a state gave
+        struct Result
+        {
+            size_t solution_count;
+            // the value of every variable, by id, for each answer one after the other; empty if counted
+            std::vector<int> values;
+        };
+
+        TranspositionCache(size_t capacity=0);
+        ~TranspositionCache();
+
+        // the result kept for key, which becomes the state used most recently, or nullptr if there is none
+        std::shared_ptr<const Result> find(const Key& key);
+        // keeps result for key, forgetting the state used least recently if capacity states are kept already
+        // nothing is kept when capacity is 0
+        void insert(const Key& key, Result result);
+        // forgets every state & resets every counter
+        void clear();
+
+        // getters & setters
+        size_t size() const;
+        // maximum number of states kept; lowering it forgets the states used least recently
+        size_t getCapacity() const;
+        void setCapacity(size_t capacity);
+        // number of calls to find that found / didn't find a result, & of states forgotten to make room,
+        // since the cache was created or last cleared
+        size_t getHitCount() const;
+        size_t getMissCount() const;
+        size_t getEvictionCount() const;
+
+    private:
+        struct KeyHash
+        {
+            size_t operator()(const Key& key) const { return (size_t) (key.domain_hash ^ key.graph_fingerprint); };
+        };
+        using Entry = std::pair<Key, std::shared_ptr<const Result>>;
+
+        mutable std::mutex mutex;
+        // states from the one used most recently to the one used least recently
+        std::list<Entry> entries;
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+        size_t capacity;
+        size_t hit_count;
+        size_t miss_count;
+        size_t eviction_count;
+
+        // forgets the states used least recently until at most capacity are left
+        // REQUIRES that mutex is held
+        void evictToCapacity();
+    };
+}
+
+#endif
@@ -1,16 +1,43 @@
 // Author: Akira Kudo
 
+#include <algorithm>
+#include <cstdint>
 #include <queue>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "src/cspSolver/ARC.h"
 #include "src/cspSolver/frontier/Frontier.h"
 
-CSPSolverImplementation::Frontier::Frontier(CSPSolverImplementation::Frontier::FrontierMode mode)
+CSPSolverImplementation::Frontier::Frontier(CSPSolverImplementation::Frontier::FrontierMode mode, 
+                                            CSPSolverImplementation::Frontier::ArcHeuristic heuristic)
 {
     this->mode = mode;
+    this->heuristic = heuristic;
+    this->comparator = nullptr;
     this->unaryFrontier = std::queue<CSPSolverImplementation::ARC>();
     this->nonUnaryFrontier = std::queue<CSPSolverImplementation::ARC>();
-    this->arc_is_in_frontier = std::unordered_map<std::string, bool>();
+    this->priorityFrontier = std::vector<PrioritizedArc>();
+    this->stale_entry_count = 0;
+    this->next_stamp = 0;
+    this->arc_id_stamp = std::vector<uint64_t>();
+    this->arc_id_is_in_frontier = std::vector<bool>();
+    this->unnumbered_arcs_in_frontier = std::unordered_set<std::string>();
+    // a custom heuristic needs a comparator - fall back to a default one without it
+    if (this->heuristic == CustomHeuristic) this->heuristic = SmallestDomainFirst;
+};
+
+// creates a frontier in PriorityQueueMode, ordering non-unary arcs with comparator
+CSPSolverImplementation::Frontier::Frontier(CSPSolverImplementation::Frontier::ArcComparator comparator)
+    : Frontier(PriorityQueueMode, SmallestDomainFirst)
+{
+    if (comparator != nullptr)
+    {
+        this->heuristic = CustomHeuristic;
+        this->comparator = comparator;
+    }
 };
 
 CSPSolverImplementation::Frontier::~Frontier()
@@ -19,44 +46,43 @@ CSPSolverImplementation::Frontier::~Frontier()
 };
 
 // push an arc that is an ARC struct to frontier
+// when reordersOnPush(), pushing an arc with id that is already in the frontier
+// updates its priority (e.g. its main variable was tightened since)
 void CSPSolverImplementation::Frontier::push(CSPSolverImplementation::ARC arc) 
 {
-    // first check whether we need to insert
-
-    // get the unique name of the arc 
-    // TODO: generate_unique_string is O(n) OR MORE, UNSURE OF EFFICIENCY
-    std::string arc_name = arc.generate_unique_string();
-    // if arc_name is not in map, add a 'true' entry to map 
-    if (arc_is_in_frontier.find(arc_name) == arc_is_in_frontier.end())
-    {
-        arc_is_in_frontier.insert({arc_name, true});
-    }
-    // if arc_name is in there and indicates false (arc not in frontier),
-    // set existence to true
-    else if (!arc_is_in_frontier.at(arc_name))
+    // first check whether we need to insert - skip if arc is already in frontier
+    if (!markAsInFrontier(arc)) 
     {
-        arc_is_in_frontier.emplace(arc_name, true);
-    // otherwise arc is already in map - skip
+        // unless a newer entry of a non-unary arc can take its place in the heap
+        if (!reordersOnPush() || arc.arc_id == ARC::NO_ARC_ID || arc.other_var_list.empty()) return;
+        stale_entry_count++;
+        pushPrioritized(std::move(arc));
+        return;
     }
-    else return;
-
 
     // then deal with insertion
+    // check the size of variable list in arc
+    // if it is none, we have a unary constraint, checked first in every mode
+    if (arc.other_var_list.empty())
+    {
+        unaryFrontier.push(std::move(arc));
+        return;
+    }
+    // otherwise, we have a non-unary constraint
     switch (this->mode) {
         // if mode is QueueMode
         case QueueMode:
         {
-            // check the size of variable list in arc
-            // if it is none, we have a unary constraint
-            if (arc.other_var_list.empty())
-                unaryFrontier.push(arc);
-            // otherwise, we have a non-unary constraint
-            else 
-                nonUnaryFrontier.push(arc);
+            nonUnaryFrontier.push(std::move(arc));
+            break;
+        }
+        // if mode is PriorityQueueMode
+        case PriorityQueueMode:
+        {
+            pushPrioritized(std::move(arc));
             break;
         }
     }
-    // might implement PriorityQueueMode as well
 };
 
 // pop an arc that is an ARC struct from the frontier
@@ -64,29 +90,125 @@ void CSPSolverImplementation::Frontier::push(CSPSolverImplementation::ARC arc)
 CSPSolverImplementation::ARC CSPSolverImplementation::Frontier::pop() 
 {
     ARC returned;
-    switch (this->mode) {
-        // if mode is QueueMode
-        case QueueMode:
-        {
-            // if we still have unary constraints, return that first
-            if (!unaryFrontier.empty()) {
-                returned = unaryFrontier.front();
-                unaryFrontier.pop();
-            // otherwise, we return a non-unary constraint
-            } else {
-                returned = nonUnaryFrontier.front();
+    // if we still have unary constraints, return that first
+    if (!unaryFrontier.empty()) {
+        returned = std::move(unaryFrontier.front());
+        unaryFrontier.pop();
+    } 
+    // otherwise, we return a non-unary constraint
+    else 
+    {
+        switch (this->mode) {
+            // if mode is QueueMode
+            case QueueMode:
+            {
+                returned = std::move(nonUnaryFrontier.front());
                 nonUnaryFrontier.pop();
+                break;
             }
-            break;
+            // if mode is PriorityQueueMode
+            case PriorityQueueMode:
+            {
+                returned = popPrioritized();
+                break;
+            }
+            default:
+                return returned;
         }
-        default:
-            return returned;
     }
 
-    // finally track the fact that we just removed 'returned' from arc_is_in_frontier
-    std::string removed_arc_name = returned.generate_unique_string();
-    arc_is_in_frontier.erase(removed_arc_name);
-    arc_is_in_frontier.emplace(removed_arc_name, false);
+    // finally track the fact that we just removed 'returned' from the frontier
+    unmarkAsInFrontier(returned);
     return returned;
-    // might implement PriorityQueueMode as well
-};
\ No newline at end of file
+};
+
+// ####################
+// PRIVATE FUNCTIONS
+// marks the arc as in frontier; returns false if it already was
+bool CSPSolverImplementation::Frontier::markAsInFrontier(CSPSolverImplementation::ARC& arc)
+{
+    // arcs with an id are a flag lookup, with no allocation once the array is grown
+    if (arc.arc_id != ARC::NO_ARC_ID)
+    {
+        if (arc.arc_id >= arc_id_is_in_frontier.size()) arc_id_is_in_frontier.resize(arc.arc_id + 1, false);
+        if (arc_id_is_in_frontier[arc.arc_id]) return false;
+        arc_id_is_in_frontier[arc.arc_id] = true;
+        return true;
+    }
+    // others fall back to their unique string
+    return unnumbered_arcs_in_frontier.insert(arc.generate_unique_string()).second;
+};
+
+// marks the arc as no longer in frontier
+void CSPSolverImplementation::Frontier::unmarkAsInFrontier(CSPSolverImplementation::ARC& arc)
+{
+    if (arc.arc_id != ARC::NO_ARC_ID)
+        arc_id_is_in_frontier[arc.arc_id] = false;
+    else
+        unnumbered_arcs_in_frontier.erase(arc.generate_unique_string());
+};
+
+// adds a non-unary arc to priorityFrontier
+void CSPSolverImplementation::Frontier::pushPrioritized(CSPSolverImplementation::ARC arc)
+{
+    size_t key = 0;
+    switch (this->heuristic) {
+        case SmallestDomainFirst:
+            key = arc.main_var->getDomainSize();
+            break;
+        case LowestArityFirst:
+            key = arc.other_var_list.size() + 1;
+            break;
+        // ordered by stamp / by the comparator alone
+        case MostRecentlyTightenedFirst:
+        case CustomHeuristic:
+            break;
+    }
+    uint64_t stamp = next_stamp++;
+    if (arc.arc_id != ARC::NO_ARC_ID)
+    {
+        if (arc.arc_id >= arc_id_stamp.size()) arc_id_stamp.resize(arc.arc_id + 1, 0);
+        arc_id_stamp[arc.arc_id] = stamp;
+    }
+
+    priorityFrontier.push_back(PrioritizedArc { std::move(arc), key, stamp });
+    std::push_heap(priorityFrontier.begin(), priorityFrontier.end(), 
+        [this] (const PrioritizedArc& entry1, const PrioritizedArc& entry2) { return goesAfter(entry1, entry2); });
+};
+
+// removes the top entry of priorityFrontier which isn't stale
+CSPSolverImplementation::ARC CSPSolverImplementation::Frontier::popPrioritized()
+{
+    auto goes_after = [this] (const PrioritizedArc& entry1, const PrioritizedArc& entry2) 
+    { 
+        return goesAfter(entry1, entry2); 
+    };
+    while (true)
+    {
+        std::pop_heap(priorityFrontier.begin(), priorityFrontier.end(), goes_after);
+        PrioritizedArc top = std::move(priorityFrontier.back());
+        priorityFrontier.pop_back();
+        // an entry superseded by a later push of the same arc is dropped
+        if (top.arc.arc_id != ARC::NO_ARC_ID && arc_id_stamp[top.arc.arc_id] != top.stamp)
+        {
+            stale_entry_count--;
+            continue;
+        }
+        return std::move(top.arc);
+    }
+};
+
+// returns true if entry1 should be checked after entry2; orders the heap
+bool CSPSolverImplementation::Frontier::goesAfter(const PrioritizedArc& entry1, const PrioritizedArc& entry2) const
+{
+    if (heuristic == CustomHeuristic)
+    {
+        if (comparator(entry2.arc, entry1.arc)) return true;
+        if (comparator(entry1.arc, entry2.arc)) return false;
+    }
+    else if (entry1.key != entry2.key) return (entry1.key > entry2.key);
+
+    // ties: latest first under MostRecentlyTightenedFirst, otherwise first come first served
+    if (heuristic == MostRecentlyTightenedFirst) return (entry1.stamp < entry2.stamp);
+    return (entry1.stamp > entry2.stamp);
+};
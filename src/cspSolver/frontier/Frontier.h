@@ -1,11 +1,19 @@
 // Author: Akira Kudo
 // Description: Implements a frontier object acting as container for 
 //  arc consistency to control the order in which arcs are checked.
+//  Arcs are never held twice: arcs with an id are tracked in a flag array
+//  indexed by that id, others by their unique string.
+//  In every mode, unary arcs are checked first. Non-unary arcs are then checked
+//  in order of insertion in QueueMode, or by an ArcHeuristic in PriorityQueueMode.
 
 #ifndef FRONTIER_H
 #define FRONTIER_H
 
+#include <cstdint>
+#include <functional>
 #include <queue>
+#include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "src/graphImplementation/vertices/ConstraintVertex.h"
@@ -19,29 +27,90 @@ namespace CSPSolverImplementation
     class Frontier 
     {
     public:
-        enum FrontierMode { QueueMode }; // could add PriorityQueueMode
+        enum FrontierMode { QueueMode, PriorityQueueMode };
+        // order of non-unary arcs in PriorityQueueMode:
+        // - SmallestDomainFirst: smallest main variable domain first
+        // - LowestArityFirst: constraints over the fewest variables first
+        // - MostRecentlyTightenedFirst: last pushed first, as arcs get pushed when a neighbor is tightened
+        // - CustomHeuristic: as given by a comparator
+        // Arcs of equal priority are checked in order of insertion, except under MostRecentlyTightenedFirst.
+        enum ArcHeuristic { SmallestDomainFirst, LowestArityFirst, MostRecentlyTightenedFirst, CustomHeuristic };
+        // returns true if the first arc should be checked before the second
+        using ArcComparator = std::function<bool(const CSPSolverImplementation::ARC&, const CSPSolverImplementation::ARC&)>;
 
-        Frontier(FrontierMode mode);
+        Frontier(FrontierMode mode, ArcHeuristic heuristic=SmallestDomainFirst);
+        // creates a frontier in PriorityQueueMode, ordering non-unary arcs with comparator
+        Frontier(ArcComparator comparator);
         ~Frontier();
         // push an arc that is an ARC struct to frontier
+        // when reordersOnPush(), pushing an arc with id that is already in the frontier
+        // updates its priority (e.g. its main variable was tightened since)
         void push(CSPSolverImplementation::ARC arc);
         // pop an arc that is an ARC struct from the frontier
         // REQUIRES that this frontier isn't empty - or does undefined behavior!
         CSPSolverImplementation::ARC pop();
+        // returns whether the arc with given id is currently in the frontier - O(1)
+        bool contains(uint32_t arc_id) const 
+        { 
+            return (arc_id < this->arc_id_is_in_frontier.size() && this->arc_id_is_in_frontier[arc_id]); 
+        }
+        // returns whether pushing an arc already in the frontier can still change the order of arcs
+        // (the arity of an arc never changes, hence LowestArityFirst doesn't reorder)
+        bool reordersOnPush() const { return (this->mode == PriorityQueueMode && this->heuristic != LowestArityFirst); }
         // mostly simple getter
-        size_t size() const { return (this->unaryFrontier.size() + this->nonUnaryFrontier.size()); }
-        bool empty() const { return (this->unaryFrontier.empty() && this->nonUnaryFrontier.empty()); }
+        size_t size() const 
+        { 
+            return (this->unaryFrontier.size() + this->nonUnaryFrontier.size() + 
+                    this->priorityFrontier.size() - this->stale_entry_count); 
+        }
+        bool empty() const { return (this->size() == 0); }
         FrontierMode getMode() const { return this->mode; }
+        ArcHeuristic getHeuristic() const { return this->heuristic; }
     
     private:
+        // an arc held in PriorityQueueMode, along with what it is ordered by
+        struct PrioritizedArc
+        {
+            CSPSolverImplementation::ARC arc;
+            // heuristic value computed when pushed; smaller goes first
+            size_t key;
+            // order of insertion, breaking ties & telling entries of the same arc apart
+            uint64_t stamp;
+        };
+
         FrontierMode mode;
+        ArcHeuristic heuristic;
+        ArcComparator comparator;
         // stores all unary constraints
         std::queue<CSPSolverImplementation::ARC> unaryFrontier;
-        // stores all non-unary constraints
+        // stores all non-unary constraints in QueueMode
         std::queue<CSPSolverImplementation::ARC> nonUnaryFrontier;
-        // this map tracks if an arc is already in frontier or not
-        std::unordered_map<std::string, bool> arc_is_in_frontier;
+        // stores all non-unary constraints in PriorityQueueMode, as a heap
+        std::vector<PrioritizedArc> priorityFrontier;
+        // entries of priorityFrontier superseded by a later push of the same arc,
+        // dropped once they reach the top of the heap
+        size_t stale_entry_count;
+        // stamp given to the next arc pushed
+        uint64_t next_stamp;
+        // stamp of the latest entry of each arc with an id in priorityFrontier
+        std::vector<uint64_t> arc_id_stamp;
+        // tracks which arcs with an id are in frontier, indexed by arc id
+        std::vector<bool> arc_id_is_in_frontier;
+        // tracks arcs without id (e.g. built by hand) by their unique string,
+        // only while they are in frontier
+        std::unordered_set<std::string> unnumbered_arcs_in_frontier;
+
+        // marks the arc as in frontier; returns false if it already was
+        bool markAsInFrontier(CSPSolverImplementation::ARC& arc);
+        // marks the arc as no longer in frontier
+        void unmarkAsInFrontier(CSPSolverImplementation::ARC& arc);
+        // adds a non-unary arc to priorityFrontier
+        void pushPrioritized(CSPSolverImplementation::ARC arc);
+        // removes the top entry of priorityFrontier which isn't stale
+        CSPSolverImplementation::ARC popPrioritized();
+        // returns true if entry1 should be checked after entry2; orders the heap
+        bool goesAfter(const PrioritizedArc& entry1, const PrioritizedArc& entry2) const;
     };
 }
 
-#endif
\ No newline at end of file
+#endif
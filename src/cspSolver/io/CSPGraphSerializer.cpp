@@ -0,0 +1,234 @@
+// Author: Akira Kudo
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "src/cspSolver/CSPGraph.h"
+#include "src/cspSolver/io/CSPGraphSerializer.h"
+#include "src/graphImplementation/domains/Domain.h"
+#include "src/graphImplementation/vertices/ConstraintKernel.h"
+#include "src/graphImplementation/vertices/ConstraintVertex.h"
+#include "src/graphImplementation/vertices/VariableVertex.h"
+
+using GraphImplementation::ConstraintKernel, GraphImplementation::ConstraintVertex, 
+      GraphImplementation::Domain, GraphImplementation::VariableVertex;
+
+// writes graph to the file at save_path, overwriting it
+// returns false, writing nothing, if any constraint is a custom predicate or a global cardinality
+// constraint, or if the file can't be written
+bool CSPSolverImplementation::CSPGraphSerializer::save(const CSPGraph& graph, const std::string& save_path)
+{
+    // the file holds the frozen view, so freeze a copy if needed
+    CSPGraph frozen_copy;
+    const CSPGraph* frozen_graph = &graph;
+    if (!graph.is_frozen())
+    {
+        frozen_copy = graph;
+        frozen_copy.freeze();
+        frozen_graph = &frozen_copy;
+    }
+    const CSPGraph& g = *frozen_graph;
+
+    Header header {};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.domain_mode = (uint32_t) g.get_domain_mode();
+    header.num_variables = g.num_variables();
+    header.num_constraints = g.num_constraints();
+    header.num_arcs = g.num_arcs();
+
+    // names of variables, then names of constraints, then descriptions of constraints
+    std::vector<uint32_t> string_offsets(1, 0);
+    std::string names;
+    auto add_string = [&string_offsets, &names] (const std::string& str)
+    {
+        names += str;
+        string_offsets.push_back((uint32_t) names.size());
+    };
+    std::vector<uint32_t> domain_offsets(1, 0);
+    std::vector<int32_t> domain_values;
+    for (uint32_t vv_id = 0; vv_id < g.num_variables(); vv_id++)
+    {
+        VariableVertex* vv = g.variable_at(vv_id);
+        add_string(vv->getNameReference());
+        for (int val : vv->getDomainStore()) domain_values.push_back(val);
+        domain_offsets.push_back((uint32_t) domain_values.size());
+    }
+    std::vector<int32_t> kernels;
+    for (uint32_t cv_id = 0; cv_id < g.num_constraints(); cv_id++)
+    {
+        const ConstraintKernel& kernel = g.constraint_at(cv_id)->getKernel();
+        // a std::function can't be written to a file, nor the bounds of a global cardinality constraint
+        if (kernel.getType() == ConstraintKernel::CustomPredicate || 
+            kernel.getType() == ConstraintKernel::GlobalCardinality) return false;
+        kernels.insert(kernels.end(), {(int32_t) kernel.getType(), kernel.getCheckedValue(), kernel.getN()});
+        add_string(g.constraint_at(cv_id)->getNameReference());
+    }
+    for (uint32_t cv_id = 0; cv_id < g.num_constraints(); cv_id++) add_string(g.constraint_at(cv_id)->getDescription());
+    header.num_domain_values = (uint32_t) domain_values.size();
+    header.num_name_bytes = (uint32_t) names.size();
+
+    std::ofstream file(save_path, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    auto write = [&file] (const void* data, size_t bytes) { file.write((const char*) data, bytes); };
+    write(&header, sizeof(Header));
+    write(string_offsets.data(), string_offsets.size() * sizeof(uint32_t));
+    write(domain_offsets.data(), domain_offsets.size() * sizeof(uint32_t));
+    write(domain_values.data(), domain_values.size() * sizeof(int32_t));
+    write(kernels.data(), kernels.size() * sizeof(int32_t));
+    // adjacency in both directions, as held by the frozen view
+    std::vector<uint32_t> var_constraint_offsets(1, 0), var_constraint_ids, scope_offsets(1, 0), scope_var_ids;
+    for (uint32_t vv_id = 0; vv_id < g.num_variables(); vv_id++)
+    {
+        IdSpan span = g.constraint_neighbor_ids(vv_id);
+        var_constraint_ids.insert(var_constraint_ids.end(), span.begin(), span.end());
+        var_constraint_offsets.push_back((uint32_t) var_constraint_ids.size());
+    }
+    for (uint32_t cv_id = 0; cv_id < g.num_constraints(); cv_id++)
+    {
+        IdSpan span = g.variable_neighbor_ids(cv_id);
+        scope_var_ids.insert(scope_var_ids.end(), span.begin(), span.end());
+        scope_offsets.push_back((uint32_t) scope_var_ids.size());
+    }
+    write(var_constraint_offsets.data(), var_constraint_offsets.size() * sizeof(uint32_t));
+    write(var_constraint_ids.data(), var_constraint_ids.size() * sizeof(uint32_t));
+    write(scope_offsets.data(), scope_offsets.size() * sizeof(uint32_t));
+    write(scope_var_ids.data(), scope_var_ids.size() * sizeof(uint32_t));
+    write(names.data(), names.size());
+    return (bool) file;
+};
+
+// reads the graph saved at load_path into graph, which comes out frozen
+// returns false, leaving graph untouched, if the file is missing or malformed
+bool CSPSolverImplementation::CSPGraphSerializer::load(const std::string& load_path, CSPGraph& graph)
+{
+#if !defined(_WIN32)
+    int fd = open(load_path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size < (off_t) sizeof(Header)) 
+    { 
+        close(fd); 
+        return false; 
+    }
+    void* mapped = mmap(nullptr, (size_t) file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping stays valid once the descriptor is closed
+    close(fd);
+    if (mapped == MAP_FAILED) return false;
+    bool loaded = loadFromMemory((const char*) mapped, (uint64_t) file_stat.st_size, graph);
+    munmap(mapped, (size_t) file_stat.st_size);
+    return loaded;
+#else
+    // no mmap here, read the whole file at once instead
+    std::ifstream file(load_path, std::ios::binary);
+    if (!file) return false;
+    std::vector<char> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return loadFromMemory(contents.data(), contents.size(), graph);
+#endif
+};
+
+// ####################
+// PRIVATE FUNCTIONS
+// number of bytes a file with given header has to hold
+uint64_t CSPSolverImplementation::CSPGraphSerializer::expectedFileSize(const Header& header)
+{
+    uint64_t nv = header.num_variables, nc = header.num_constraints, na = header.num_arcs;
+    uint64_t num_words = (nv + 2 * nc + 1)                  // string offsets
+                       + (nv + 1) + header.num_domain_values // domains
+                       + 3 * nc                              // kernels
+                       + (nv + 1) + na + (nc + 1) + na;      // adjacency
+    return sizeof(Header) + num_words * sizeof(uint32_t) + header.num_name_bytes;
+};
+
+// builds the graph from the contents of a file, which are size bytes at data
+bool CSPSolverImplementation::CSPGraphSerializer::loadFromMemory(const char* data, uint64_t size, CSPGraph& graph)
+{
+    if (size < sizeof(Header)) return false;
+    Header header;
+    std::memcpy(&header, data, sizeof(Header));
+    if (header.magic != MAGIC || header.version != VERSION || 
+        header.domain_mode > (uint32_t) Domain::SetMode || size != expectedFileSize(header)) 
+        return false;
+
+    uint32_t nv = header.num_variables, nc = header.num_constraints, na = header.num_arcs;
+    // arrays are copied out of the file as is, which also takes care of alignment
+    const char* cursor = data + sizeof(Header);
+    auto take = [&cursor] (size_t count)
+    {
+        std::vector<uint32_t> words(count);
+        std::memcpy(words.data(), cursor, count * sizeof(uint32_t));
+        cursor += count * sizeof(uint32_t);
+        return words;
+    };
+    std::vector<uint32_t> string_offsets = take(nv + 2 * (size_t) nc + 1);
+    std::vector<uint32_t> domain_offsets = take(nv + (size_t) 1);
+    std::vector<uint32_t> domain_values = take(header.num_domain_values);
+    std::vector<uint32_t> kernels = take(3 * (size_t) nc);
+    std::vector<uint32_t> var_constraint_offsets = take(nv + (size_t) 1);
+    std::vector<uint32_t> var_constraint_ids = take(na);
+    std::vector<uint32_t> scope_offsets = take(nc + (size_t) 1);
+    std::vector<uint32_t> scope_var_ids = take(na);
+    const char* names = cursor;
+
+    // offsets into names & domain values have to be increasing and in range
+    auto offsets_are_valid = [] (const std::vector<uint32_t>& offsets, uint32_t bound)
+    {
+        if (offsets.front() != 0 || offsets.back() != bound) return false;
+        for (size_t i = 0; i + 1 < offsets.size(); i++) if (offsets[i] > offsets[i + 1]) return false;
+        return true;
+    };
+    if (!offsets_are_valid(string_offsets, header.num_name_bytes) || 
+        !offsets_are_valid(domain_offsets, header.num_domain_values))
+        return false;
+    auto string_at = [&string_offsets, names] (size_t i)
+    {
+        return std::string(names + string_offsets[i], string_offsets[i + 1] - string_offsets[i]);
+    };
+
+    Domain::DomainMode domain_mode = (Domain::DomainMode) header.domain_mode;
+    std::vector<VariableVertex> variables;
+    variables.reserve(nv);
+    for (uint32_t vv_id = 0; vv_id < nv; vv_id++)
+    {
+        Domain domain = Domain(domain_mode);
+        for (uint32_t i = domain_offsets[vv_id]; i < domain_offsets[vv_id + 1]; i++) domain.insert((int32_t) domain_values[i]);
+        variables.emplace_back(string_at(vv_id), std::move(domain));
+    }
+    std::vector<ConstraintVertex> constraints;
+    constraints.reserve(nc);
+    for (uint32_t cv_id = 0; cv_id < nc; cv_id++)
+    {
+        int checked_value = (int32_t) kernels[3 * cv_id + 1], n = (int32_t) kernels[3 * cv_id + 2];
+        ConstraintKernel::KernelType type = (ConstraintKernel::KernelType) kernels[3 * cv_id];
+        std::string name = string_at(nv + cv_id), description = string_at(nv + nc + cv_id);
+        if (type == ConstraintKernel::LesserOrEqualToN) 
+            constraints.emplace_back(name, ConstraintKernel::lesserOrEqualToN(checked_value, n), description);
+        else if (type == ConstraintKernel::GreaterOrEqualToN) 
+            constraints.emplace_back(name, ConstraintKernel::greaterOrEqualToN(checked_value, n), description);
+        else if (type == ConstraintKernel::ExactlyN) 
+            constraints.emplace_back(name, ConstraintKernel::exactlyN(checked_value, n), description);
+        else if (type == ConstraintKernel::AllDifferent) 
+            constraints.emplace_back(name, ConstraintKernel::allDifferent(), description);
+        else return false;
+    }
+
+    CSPGraph loaded = CSPGraph(domain_mode);
+    if (!loaded.build_frozen(std::move(variables), std::move(constraints), 
+                             std::move(var_constraint_offsets), std::move(var_constraint_ids),
+                             std::move(scope_offsets), std::move(scope_var_ids)))
+        return false;
+    graph = std::move(loaded);
+    return true;
+};
@@ -0,0 +1,56 @@
+// Author: Akira Kudo
+// Description: Implements saving & loading a CSPGraph to & from a compact binary file.
+//  The file holds the frozen view of the graph as flat arrays of 32 bit integers:
+//  domains, constraint parameters, both directions of the adjacency, followed by names.
+//  Loading maps the file in memory and copies those arrays straight into the graph,
+//  hence neither parsing nor name lookups happen per edge.
+//  Only typed constraints (exactlyN & friends) can be saved; custom predicates can't, nor can
+//  global cardinality constraints, which are meant to be fused after loading instead.
+
+#ifndef CSPGRAPHSERIALIZER_H
+#define CSPGRAPHSERIALIZER_H
+
+#include <cstdint>
+#include <string>
+
+#include "src/cspSolver/CSPGraph.h"
+
+namespace CSPSolverImplementation
+{
+    class CSPGraphSerializer
+    {
+    public:
+        // first bytes of every file, "GCSP" read as a little-endian integer
+        static const uint32_t MAGIC = 0x50534347;
+        static const uint32_t VERSION = 1;
+
+        // writes graph to the file at save_path, overwriting it
+        // returns false, writing nothing, if any constraint is a custom predicate or a global cardinality
+        // constraint, or if the file can't be written
+        static bool save(const CSPGraph& graph, const std::string& save_path);
+        // reads the graph saved at load_path into graph, which comes out frozen
+        // returns false, leaving graph untouched, if the file is missing or malformed
+        static bool load(const std::string& load_path, CSPGraph& graph);
+
+    private:
+        // fixed-size header at the start of every file
+        struct Header
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t domain_mode;
+            uint32_t num_variables;
+            uint32_t num_constraints;
+            uint32_t num_arcs;
+            uint32_t num_domain_values;
+            uint32_t num_name_bytes;
+        };
+
+        // number of bytes a file with given header has to hold
+        static uint64_t expectedFileSize(const Header& header);
+        // builds the graph from the contents of a file, which are size bytes at data
+        static bool loadFromMemory(const char* data, uint64_t size, CSPGraph& graph);
+    };
+}
+
+#endif
@@ -0,0 +1,242 @@
+// Author: Akira Kudo
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "src/cspSolver/CSPGraph.h"
+#include "src/cspSolver/io/CSPProblemLoader.h"
+#include "src/graphImplementation/domains/Domain.h"
+#include "src/graphImplementation/vertices/ConstraintKernel.h"
+
+using GraphImplementation::ConstraintKernel, GraphImplementation::Domain;
+
+namespace
+{
+    // splits line into tokens separated by spaces or tabs, dropping any comment
+    void tokenize(std::string_view line, std::vector<std::string_view>& tokens)
+    {
+        tokens.clear();
+        size_t comment = line.find('#');
+        if (comment != std::string_view::npos) line = line.substr(0, comment);
+        size_t i = 0;
+        while (i < line.size())
+        {
+            while (i < line.size() && (line[i] == ' ' || line[i] == '\t' || line[i] == '\r')) i++;
+            size_t start = i;
+            while (i < line.size() && line[i] != ' ' && line[i] != '\t' && line[i] != '\r') i++;
+            if (i > start) tokens.push_back(line.substr(start, i - start));
+        }
+    };
+
+    bool parseInt(std::string_view token, int& value)
+    {
+        auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+        return (result.ec == std::errc() && result.ptr == token.data() + token.size());
+    };
+
+    // reads "first..last" into first & last
+    bool parseRange(std::string_view token, int& first, int& last)
+    {
+        size_t dots = token.find("..");
+        if (dots == std::string_view::npos) return false;
+        return parseInt(token.substr(0, dots), first) && parseInt(token.substr(dots + 2), last) && first <= last;
+    };
+
+    // ranges spanning more values than this are rejected, as each value is stored
+    const int64_t MAX_RANGE_WIDTH = Domain::MAX_BITSET_RANGE;
+
+    // whether token is a well-formed range "first..last" spanning more than MAX_RANGE_WIDTH values
+    bool isTooWide(std::string_view token)
+    {
+        int first, last;
+        return parseRange(token, first, last) && (int64_t) last - first + 1 > MAX_RANGE_WIDTH;
+    };
+
+    // reads either a range "1..9" or a list "1,2,5" into domain
+    bool parseDomain(std::string_view token, Domain& domain)
+    {
+        int first, last;
+        if (token.find("..") != std::string_view::npos)
+        {
+            if (!parseRange(token, first, last) || isTooWide(token)) return false;
+            // a wider counter, as last may be the largest int
+            for (int64_t val = first; val <= last; val++) domain.insert((int) val);
+            return true;
+        }
+        // every element has to be a value, including the one following the last comma
+        while (true)
+        {
+            size_t comma = token.find(',');
+            int val;
+            if (!parseInt(token.substr(0, comma), val)) return false;
+            domain.insert(val);
+            if (comma == std::string_view::npos) return true;
+            token = token.substr(comma + 1);
+        }
+    };
+
+    // builds the kernel of given kind; returns false if kind isn't known
+    bool makeKernel(std::string_view kind, int value, int n, ConstraintKernel& kernel)
+    {
+        if (kind == "exactly" || kind == "=") kernel = ConstraintKernel::exactlyN(value, n);
+        else if (kind == "atmost" || kind == "<=") kernel = ConstraintKernel::lesserOrEqualToN(value, n);
+        else if (kind == "atleast" || kind == ">=") kernel = ConstraintKernel::greaterOrEqualToN(value, n);
+        else return false;
+        return true;
+    };
+}
+
+// builds graph from the problem given as text
+// returns false, leaving graph untouched, if the text is malformed; 
+// error is then set to the line number and reason, if given
+bool CSPSolverImplementation::CSPProblemLoader::parse(std::string_view text, CSPGraph& graph, std::string* error)
+{
+    CSPGraph built = CSPGraph(graph.get_domain_mode());
+    // each name written takes 2 characters or more, so that the text itself bounds the room worth reserving
+    // (families may add more constraints, the graph then simply growing)
+    size_t max_reserved = text.size() / 2;
+    std::vector<std::string_view> tokens;
+    size_t line_number = 0;
+
+    auto fail = [&error, &line_number] (const std::string& reason)
+    {
+        if (error != nullptr) *error = "line " + std::to_string(line_number) + ": " + reason;
+        return false;
+    };
+    // reason given for a range spanning more than MAX_RANGE_WIDTH values
+    auto tooWide = [] (std::string_view token)
+    {
+        return "range '" + std::string(token) + "' spans more than " + std::to_string(MAX_RANGE_WIDTH) + " values";
+    };
+    // links the variables following ':' from token index first on, to constraint cv_name
+    auto link_scope = [&built, &tokens] (size_t first, const std::string& cv_name) -> std::string_view
+    {
+        for (size_t i = first; i < tokens.size(); i++)
+        {
+            std::string vv_name(tokens[i]);
+            if (built.get_variable(vv_name) == nullptr) return tokens[i];
+            built.add_edge(vv_name, cv_name);
+        }
+        return std::string_view();
+    };
+
+    while (!text.empty())
+    {
+        line_number++;
+        size_t newline = text.find('\n');
+        std::string_view line = text.substr(0, newline);
+        text = (newline == std::string_view::npos) ? std::string_view() : text.substr(newline + 1);
+        tokenize(line, tokens);
+        if (tokens.empty()) continue;
+        std::string_view keyword = tokens[0];
+
+        if (keyword == "csp")
+        {
+            int num_variables, num_constraints;
+            if (tokens.size() != 3 || !parseInt(tokens[1], num_variables) || !parseInt(tokens[2], num_constraints) ||
+                num_variables < 0 || num_constraints < 0)
+                return fail("expected 'csp <number of variables> <number of constraints>'");
+            // only a hint, which a huge count mustn't turn into a failed allocation
+            built.reserve(std::min((size_t) num_variables, max_reserved), std::min((size_t) num_constraints, max_reserved));
+        }
+        else if (keyword == "var")
+        {
+            Domain domain = Domain(graph.get_domain_mode());
+            if (tokens.size() == 3 && isTooWide(tokens[2])) return fail(tooWide(tokens[2]));
+            if (tokens.size() != 3 || !parseDomain(tokens[2], domain)) return fail("expected 'var <name> <domain>'");
+            std::string vv_name(tokens[1]);
+            if (built.contains_vertex(vv_name)) return fail("name '" + vv_name + "' is already used");
+            built.add_variable(std::move(vv_name), domain);
+        }
+        else if (keyword == "vars")
+        {
+            Domain domain = Domain(graph.get_domain_mode());
+            if (tokens.size() >= 3 && isTooWide(tokens[1])) return fail(tooWide(tokens[1]));
+            if (tokens.size() < 3 || tokens[2] != ":" || !parseDomain(tokens[1], domain)) 
+                return fail("expected 'vars <domain> : <name> ...'");
+            for (size_t i = 3; i < tokens.size(); i++)
+            {
+                std::string vv_name(tokens[i]);
+                if (built.contains_vertex(vv_name)) return fail("name '" + vv_name + "' is already used");
+                built.add_variable(std::move(vv_name), domain);
+            }
+        }
+        else if (keyword == "con" || keyword == "family")
+        {
+            // both share the layout: keyword name kind value(s) n [: scope...]
+            int first, last, n;
+            bool is_family = (keyword == "family");
+            if (is_family && tokens.size() > 3 && isTooWide(tokens[3])) return fail(tooWide(tokens[3]));
+            bool values_are_valid = is_family ? parseRange(tokens.size() > 3 ? tokens[3] : "", first, last) 
+                                              : parseInt(tokens.size() > 3 ? tokens[3] : "", first);
+            if (!is_family) last = first;
+            ConstraintKernel kernel = ConstraintKernel::exactlyN(0, 0);
+            if (tokens.size() < 5 || !values_are_valid || !parseInt(tokens[4], n) || 
+                !makeKernel(tokens[2], first, n, kernel) || (tokens.size() > 5 && tokens[5] != ":"))
+                return fail(is_family ? "expected 'family <name> <kind> <first value>..<last value> <n> [: <variable> ...]'"
+                                      : "expected 'con <name> <kind> <value> <n> [: <variable> ...]'");
+
+            std::string name_pattern(tokens[1]);
+            size_t placeholder = name_pattern.find("{}");
+            for (int64_t wide_value = first; wide_value <= last; wide_value++)
+            {
+                int value = (int) wide_value;
+                std::string cv_name = name_pattern;
+                if (is_family && placeholder != std::string::npos) cv_name.replace(placeholder, 2, std::to_string(value));
+                else if (is_family) cv_name += std::to_string(value);
+                if (built.contains_vertex(cv_name)) return fail("name '" + cv_name + "' is already used");
+
+                makeKernel(tokens[2], value, n, kernel);
+                built.add_constraint(cv_name, kernel);
+                std::string_view unknown = link_scope(6, cv_name);
+                if (!unknown.empty()) return fail("unknown variable '" + std::string(unknown) + "'");
+            }
+        }
+        else if (keyword == "alldiff" || keyword == "alldifferent")
+        {
+            if (tokens.size() < 2 || (tokens.size() > 2 && tokens[2] != ":")) 
+                return fail("expected 'alldiff <name> [: <variable> ...]'");
+            std::string cv_name(tokens[1]);
+            if (built.contains_vertex(cv_name)) return fail("name '" + cv_name + "' is already used");
+            built.add_constraint(cv_name, ConstraintKernel::allDifferent());
+            std::string_view unknown = link_scope(3, cv_name);
+            if (!unknown.empty()) return fail("unknown variable '" + std::string(unknown) + "'");
+        }
+        else if (keyword == "edge")
+        {
+            if (tokens.size() < 3) return fail("expected 'edge <variable> <constraint> ...'");
+            std::string vv_name(tokens[1]);
+            if (built.get_variable(vv_name) == nullptr) return fail("unknown variable '" + vv_name + "'");
+            for (size_t i = 2; i < tokens.size(); i++)
+            {
+                std::string cv_name(tokens[i]);
+                if (built.get_constraint(cv_name) == nullptr) return fail("unknown constraint '" + cv_name + "'");
+                built.add_edge(vv_name, cv_name);
+            }
+        }
+        else return fail("unknown statement '" + std::string(keyword) + "'");
+    }
+
+    graph = std::move(built);
+    return true;
+};
+
+// reads the whole problem file at load_path, then parses it
+bool CSPSolverImplementation::CSPProblemLoader::load(const std::string& load_path, CSPGraph& graph, std::string* error)
+{
+    std::ifstream file(load_path, std::ios::binary);
+    if (!file)
+    {
+        if (error != nullptr) *error = "cannot open " + load_path;
+        return false;
+    }
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return parse(text, graph, error);
+};
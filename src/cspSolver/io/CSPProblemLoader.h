@@ -0,0 +1,42 @@
+// Author: Akira Kudo
+// Description: Implements a non-interactive loader building a CSPGraph from a text problem file,
+//  for headless runs over many generated instances. The whole text is parsed in a single pass,
+//  feeding the graph directly & never printing it. One statement per line, tokens being 
+//  separated by spaces; '#' starts a comment. Statements are:
+//   csp <number of variables> <number of constraints>   (optional hint, reserving room in the graph)
+//   var <name> <domain>
+//   vars <domain> : <name> <name> ...
+//   con <name> <kind> <value> <n> [: <variable> <variable> ...]
+//   family <name> <kind> <first value>..<last value> <n> [: <variable> <variable> ...]
+//   alldiff <name> [: <variable> <variable> ...]   (or alldifferent)
+//   edge <variable> <constraint> <constraint> ...
+//  where a domain is either a range "1..9" (spanning at most 65536 values, as do family
+//  ranges) or a list "1,2,5", a kind is one of
+//  exactly / atmost / atleast (or = / <= / >=), and the variables following ':' are 
+//  linked to the constraint. A family adds one constraint per value, the value replacing
+//  "{}" in the name (or being appended to it), e.g. "family OnlyOne{}-row-1 exactly 1..9 1".
+//  An alldiff constraint requires its variables to all take different values.
+
+#ifndef CSPPROBLEMLOADER_H
+#define CSPPROBLEMLOADER_H
+
+#include <string>
+#include <string_view>
+
+#include "src/cspSolver/CSPGraph.h"
+
+namespace CSPSolverImplementation
+{
+    class CSPProblemLoader
+    {
+    public:
+        // builds graph from the problem given as text
+        // returns false, leaving graph untouched, if the text is malformed; 
+        // error is then set to the line number and reason, if given
+        static bool parse(std::string_view text, CSPGraph& graph, std::string* error=nullptr);
+        // reads the whole problem file at load_path, then parses it
+        static bool load(const std::string& load_path, CSPGraph& graph, std::string* error=nullptr);
+    };
+}
+
+#endif
@@ -0,0 +1,136 @@
+// Author: Akira Kudo
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "src/cspSolver/nogood/ConflictExplainer.h"
+#include "src/graphImplementation/vertices/VariableVertex.h"
+
+using GraphImplementation::VariableVertex;
+
+bool CSPSolverImplementation::LevelSet::contains(size_t level) const
+{
+    size_t word = level / 64;
+    return word < words.size() && ((words[word] >> (level % 64)) & 1);
+};
+
+bool CSPSolverImplementation::LevelSet::empty() const
+{
+    for (uint64_t word : words) if (word != 0) return false;
+    return true;
+};
+
+void CSPSolverImplementation::LevelSet::insert(size_t level)
+{
+    size_t word = level / 64;
+    if (word >= words.size()) words.resize(word + 1, 0);
+    words[word] |= (uint64_t) 1 << (level % 64);
+};
+
+void CSPSolverImplementation::LevelSet::erase(size_t level)
+{
+    size_t word = level / 64;
+    if (word < words.size()) words[word] &= ~((uint64_t) 1 << (level % 64));
+};
+
+// adds every level of other
+void CSPSolverImplementation::LevelSet::merge(const LevelSet& other)
+{
+    if (other.words.size() > words.size()) words.resize(other.words.size(), 0);
+    for (size_t word = 0; word < other.words.size(); word++) words[word] |= other.words[word];
+};
+
+// every level held, in increasing order
+std::vector<size_t> CSPSolverImplementation::LevelSet::levels() const
+{
+    std::vector<size_t> returned;
+    for (size_t word = 0; word < words.size(); word++)
+        for (size_t bit = 0; bit < 64; bit++)
+            if ((words[word] >> bit) & 1) returned.push_back(word * 64 + bit);
+    return returned;
+};
+
+CSPSolverImplementation::ConflictExplainer::ConflictExplainer()
+{
+
+};
+
+CSPSolverImplementation::ConflictExplainer::~ConflictExplainer()
+{
+
+};
+
+// forgets every decision & explanation, for a search over variables numbered from 0 to num_variables - 1
+void CSPSolverImplementation::ConflictExplainer::reset(size_t num_variables)
+{
+    explanations.assign(num_variables, LevelSet());
+    saved_levels.assign(num_variables, 0);
+    saved.clear();
+    level_starts.clear();
+    decisions.clear();
+};
+
+// opens the next decision level, at which variable vv_id is restricted to val
+void CSPSolverImplementation::ConflictExplainer::decide(uint32_t vv_id, int val)
+{
+    level_starts.push_back(saved.size());
+    decisions.push_back(Decision { vv_id, val });
+    if (vv_id >= explanations.size()) return;
+    // every other value of vv_id is removed by this decision
+    save(vv_id);
+    explanations[vv_id].insert(level());
+};
+
+// restores every explanation changed since the last decision, then closes its level
+// does nothing if no decision is open
+void CSPSolverImplementation::ConflictExplainer::undoLastDecision()
+{
+    if (decisions.empty()) return;
+    size_t restore_to = level_starts.back();
+    level_starts.pop_back();
+    decisions.pop_back();
+    // restore in reverse order of saving
+    while (saved.size() > restore_to)
+    {
+        SavedExplanation& last = saved.back();
+        explanations[last.vv_id] = std::move(last.explanation);
+        saved_levels[last.vv_id] = last.saved_level;
+        saved.pop_back();
+    }
+};
+
+// removals from vv are now also explained by whatever explains removals from the variables of scope
+// variables the explainer wasn't reset for are ignored
+void CSPSolverImplementation::ConflictExplainer::explainBy(const VariableVertex* vv, const std::vector<VariableVertex*>& scope)
+{
+    uint32_t vv_id = vv->getId();
+    if (vv_id >= explanations.size()) return;
+    // nothing explains removals made before any decision
+    if (decisions.empty()) return;
+    save(vv_id);
+    for (const VariableVertex* other : scope)
+    {
+        uint32_t other_id = other->getId();
+        if (other_id != vv_id && other_id < explanations.size()) explanations[vv_id].merge(explanations[other_id]);
+    }
+};
+
+// removals from variable vv_id are now also explained by the decisions at levels
+void CSPSolverImplementation::ConflictExplainer::explainBy(uint32_t vv_id, const LevelSet& levels)
+{
+    if (vv_id >= explanations.size() || decisions.empty()) return;
+    save(vv_id);
+    explanations[vv_id].merge(levels);
+};
+
+// ####################
+// PRIVATE FUNCTIONS
+// saves the explanation of vv_id if it wasn't saved at the current level yet
+void CSPSolverImplementation::ConflictExplainer::save(uint32_t vv_id)
+{
+    if (saved_levels[vv_id] == level()) return;
+    saved.push_back(SavedExplanation { vv_id, explanations[vv_id], saved_levels[vv_id] });
+    saved_levels[vv_id] = level();
+};
@@ -0,0 +1,98 @@
+// Author: Akira Kudo
+// Description: Implements the explanations used by conflict-directed backjumping.
+//  Each branching of the search opens a decision level, restricting a variable to a value.
+//  Every variable keeps the set of decision levels whose decisions led to values being
+//  removed from its domain; a revision removing values from a variable adds to its set
+//  those of the other variables of the revised constraint. Once a domain is wiped out,
+//  its set tells which decisions caused the failure - any decision left out of it can be
+//  changed without the failure going away, so the search may jump back past it.
+//  Explanations changed at a level are restored once that level is closed again.
+
+#ifndef CONFLICTEXPLAINER_H
+#define CONFLICTEXPLAINER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "src/graphImplementation/vertices/VariableVertex.h"
+
+namespace CSPSolverImplementation
+{
+    // set of decision levels, numbered from 1; level l is bit l of the words held
+    class LevelSet
+    {
+    public:
+        bool contains(size_t level) const;
+        bool empty() const;
+        void insert(size_t level);
+        void erase(size_t level);
+        // adds every level of other
+        void merge(const LevelSet& other);
+        void clear() { this->words.clear(); };
+        // every level held, in increasing order
+        std::vector<size_t> levels() const;
+
+    private:
+        std::vector<uint64_t> words;
+    };
+
+    class ConflictExplainer
+    {
+    public:
+        // a variable restricted to a single value when branching
+        struct Decision
+        {
+            uint32_t vv_id;
+            int val;
+        };
+
+        ConflictExplainer();
+        ~ConflictExplainer();
+
+        // forgets every decision & explanation, for a search over variables numbered from 0 to num_variables - 1
+        void reset(size_t num_variables);
+        // opens the next decision level, at which variable vv_id is restricted to val
+        void decide(uint32_t vv_id, int val);
+        // restores every explanation changed since the last decision, then closes its level
+        // does nothing if no decision is open
+        void undoLastDecision();
+        // removals from vv are now also explained by whatever explains removals from the variables of scope
+        // variables the explainer wasn't reset for are ignored
+        void explainBy(const GraphImplementation::VariableVertex* vv,
+                       const std::vector<GraphImplementation::VariableVertex*>& scope);
+        // removals from variable vv_id are now also explained by the decisions at levels
+        void explainBy(uint32_t vv_id, const LevelSet& levels);
+
+        // getters
+        // number of decisions currently open, the last one being at that level
+        size_t level() const { return this->decisions.size(); };
+        // levels of the decisions explaining every removal from variable vv_id
+        const LevelSet& explanationOf(uint32_t vv_id) const { return this->explanations[vv_id]; };
+        // the decision made at level, from 1 to level()
+        const Decision& decisionAt(size_t level) const { return this->decisions[level - 1]; };
+
+    private:
+        // explanation of a variable as it was before being changed at some level
+        struct SavedExplanation
+        {
+            uint32_t vv_id;
+            LevelSet explanation;
+            size_t saved_level;
+        };
+
+        std::vector<LevelSet> explanations;
+        // level at which the explanation of each variable was last saved, so that
+        // it is saved at most once per level
+        std::vector<size_t> saved_levels;
+        std::vector<SavedExplanation> saved;
+        // size of saved when each open level was opened
+        std::vector<size_t> level_starts;
+        std::vector<Decision> decisions;
+
+        // saves the explanation of vv_id if it wasn't saved at the current level yet
+        void save(uint32_t vv_id);
+    };
+}
+
+#endif
@@ -0,0 +1,47 @@
+// Author: Akira Kudo
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "src/cspSolver/nogood/NogoodStore.h"
+
+CSPSolverImplementation::NogoodStore::NogoodStore(size_t capacity)
+    : capacity(capacity), oldest(0)
+{
+
+};
+
+CSPSolverImplementation::NogoodStore::~NogoodStore()
+{
+
+};
+
+// keeps nogood, forgetting the nogood learned first if capacity nogoods are kept already
+// an empty nogood, or any nogood when capacity is 0, isn't kept
+void CSPSolverImplementation::NogoodStore::add(Nogood nogood)
+{
+    if (nogood.empty() || capacity == 0) return;
+    if (nogoods.size() < capacity)
+    {
+        nogoods.push_back(std::move(nogood));
+        return;
+    }
+    // full: nogoods are replaced in a ring, in the order they were learned
+    nogoods[oldest] = std::move(nogood);
+    oldest = (oldest + 1) % capacity;
+};
+
+// forgets every nogood, keeping the capacity
+void CSPSolverImplementation::NogoodStore::clear()
+{
+    nogoods.clear();
+    oldest = 0;
+};
+
+// maximum number of nogoods kept; changing it forgets every nogood
+void CSPSolverImplementation::NogoodStore::setCapacity(size_t capacity)
+{
+    if (capacity != this->capacity) clear();
+    this->capacity = capacity;
+};
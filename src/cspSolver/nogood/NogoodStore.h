@@ -0,0 +1,50 @@
+// Author: Akira Kudo
+// Description: Implements a bounded database of nogoods learned during search.
+//  A nogood lists decisions that can't all hold in any answer, as found once every value
+//  of a split variable failed for reasons tied to those decisions alone. Keeping it lets
+//  the search rule out the same combination of decisions in other branches right away,
+//  instead of deriving the same contradiction again. Once full, the store forgets the
+//  nogood learned first, so that memory & the time spent checking nogoods stay bounded.
+
+#ifndef NOGOODSTORE_H
+#define NOGOODSTORE_H
+
+#include <cstddef>
+#include <vector>
+
+#include "src/cspSolver/nogood/ConflictExplainer.h"
+
+namespace CSPSolverImplementation
+{
+    class NogoodStore
+    {
+    public:
+        // decisions that can't all hold together, each being a variable id & the value it was restricted to
+        using Nogood = std::vector<ConflictExplainer::Decision>;
+
+        NogoodStore(size_t capacity=256);
+        ~NogoodStore();
+
+        // keeps nogood, forgetting the nogood learned first if capacity nogoods are kept already
+        // an empty nogood, or any nogood when capacity is 0, isn't kept
+        void add(Nogood nogood);
+        // forgets every nogood, keeping the capacity
+        void clear();
+
+        // getters & setters
+        // number of nogoods kept; at(i) for i from 0 to size() - 1 gives each, in no particular order
+        size_t size() const { return this->nogoods.size(); };
+        const Nogood& at(size_t i) const { return this->nogoods[i]; };
+        // maximum number of nogoods kept; changing it forgets every nogood
+        size_t getCapacity() const { return this->capacity; };
+        void setCapacity(size_t capacity);
+
+    private:
+        std::vector<Nogood> nogoods;
+        size_t capacity;
+        // index of the nogood to replace next once full, the one learned first
+        size_t oldest;
+    };
+}
+
+#endif
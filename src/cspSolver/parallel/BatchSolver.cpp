@@ -0,0 +1,182 @@
+// Author: Akira Kudo
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "src/cspSolver/CSPGraph.h"
+#include "src/cspSolver/CSPSolver.h"
+#include "src/cspSolver/io/CSPGraphSerializer.h"
+#include "src/cspSolver/io/CSPProblemLoader.h"
+#include "src/cspSolver/parallel/BatchSolver.h"
+#include "src/cspSolver/parallel/ThreadPool.h"
+
+namespace
+{
+    // whether the file at path starts like the files saved by CSPGraphSerializer
+    bool isSavedGraph(const std::string& path)
+    {
+        uint32_t magic = 0;
+        std::ifstream file(path, std::ios::binary);
+        file.read((char*) &magic, sizeof(magic));
+        return (file && magic == CSPSolverImplementation::CSPGraphSerializer::MAGIC);
+    };
+}
+
+// every workspace is a copy of settings, which sets the modes & heuristics used;
+// as the batch already keeps every thread busy, ParallelMode is run as TrailMode
+// thread_count counts the calling thread as well; 0 is treated as 1
+CSPSolverImplementation::BatchSolver::BatchSolver(size_t thread_count, const CSPSolver& settings, SearchEngine engine)
+    : pool(thread_count), engine(engine)
+{
+    workspaces.assign(pool.getThreadCount(), settings);
+    for (CSPSolver& solver : workspaces)
+        if (solver.getSearchMode() == CSPSolver::ParallelMode) solver.setSearchMode(CSPSolver::TrailMode);
+};
+
+CSPSolverImplementation::BatchSolver::~BatchSolver()
+{
+
+};
+
+// solves every graph, returning results in the same order
+// rethrows the first exception thrown while solving, e.g. by a custom predicate
+std::vector<CSPSolverImplementation::BatchSolver::Result>
+CSPSolverImplementation::BatchSolver::solve(std::vector<CSPGraph> graphs)
+{
+    std::vector<Result> results(graphs.size(), Result { true, "", {}, 0, 0 });
+    // every graph is ready from the start
+    Progress progress;
+    progress.loaded = graphs.size();
+    progress.claimed = 0;
+    progress.cancelled = false;
+    solveAll(graphs, results, progress);
+    return results;
+};
+
+// loads & solves every file, either saved by CSPSolver::saveCspGraph or a text problem
+// file read by CSPProblemLoader; returns results in the same order as the paths
+// rethrows the first exception thrown while solving, the loader being stopped first
+std::vector<CSPSolverImplementation::BatchSolver::Result>
+CSPSolverImplementation::BatchSolver::solveFiles(const std::vector<std::string>& paths)
+{
+    std::vector<CSPGraph> graphs(paths.size());
+    std::vector<Result> results(paths.size(), Result { false, "", {}, 0, 0 });
+    Progress progress;
+    progress.loaded = 0;
+    progress.claimed = 0;
+    progress.cancelled = false;
+
+    // files are parsed in order while earlier ones are being solved
+    std::thread loader([this, &paths, &graphs, &results, &progress]
+    {
+        for (size_t i = 0; i < paths.size(); i++)
+        {
+            {
+                // stay at most one file per solving thread ahead of them
+                std::unique_lock<std::mutex> lock(progress.mutex);
+                progress.changed.wait(lock, [this, &progress, i] 
+                { 
+                    return (progress.cancelled || i < progress.claimed + workspaces.size()); 
+                });
+                if (progress.cancelled) return;
+            }
+            CSPGraph loaded_graph;
+            std::string error;
+            bool loaded = false;
+            // an exception escaping this thread would terminate the process, so it fails the file instead
+            try
+            {
+                // a saved graph failing to load is reported as such, rather than as a malformed text
+                if (isSavedGraph(paths[i]))
+                {
+                    loaded = CSPGraphSerializer::load(paths[i], loaded_graph);
+                    if (!loaded) error = "malformed graph file, saved by an incompatible version or corrupted";
+                }
+                else loaded = CSPProblemLoader::load(paths[i], loaded_graph, &error);
+            }
+            catch (const std::exception& exception)
+            {
+                error = exception.what();
+            }
+            catch (...)
+            {
+                error = "unknown exception while loading";
+            }
+            {
+                std::lock_guard<std::mutex> lock(progress.mutex);
+                graphs[i] = std::move(loaded_graph);
+                results[i].loaded = loaded;
+                results[i].error = loaded ? "" : paths[i] + ": " + error;
+                progress.loaded = i + 1;
+            }
+            progress.changed.notify_all();
+        }
+    });
+    try
+    {
+        solveAll(graphs, results, progress);
+    }
+    catch (...)
+    {
+        // the loader may wait on solving threads that are gone, hence is stopped before being joined
+        {
+            std::lock_guard<std::mutex> lock(progress.mutex);
+            progress.cancelled = true;
+        }
+        progress.changed.notify_all();
+        loader.join();
+        throw;
+    }
+    loader.join();
+    return results;
+};
+
+// ####################
+// PRIVATE FUNCTIONS
+// solves graphs with every workspace until each problem was claimed
+void CSPSolverImplementation::BatchSolver::solveAll(std::vector<CSPGraph>& graphs, std::vector<Result>& results,
+                                                    Progress& progress)
+{
+    ThreadPool::TaskGroup group;
+    for (CSPSolver& solver : workspaces)
+    {
+        pool.submit(group, [this, &solver, &graphs, &results, &progress]
+        {
+            runWorkspace(solver, graphs, results, progress);
+        });
+    }
+    // we solve problems ourselves while waiting
+    pool.wait(group);
+};
+
+// claims & solves problems one after the other using the given workspace
+void CSPSolverImplementation::BatchSolver::runWorkspace(CSPSolver& solver, std::vector<CSPGraph>& graphs,
+                                                        std::vector<Result>& results, Progress& progress)
+{
+    while (true)
+    {
+        size_t i;
+        {
+            std::unique_lock<std::mutex> lock(progress.mutex);
+            if (progress.claimed >= graphs.size()) return;
+            i = progress.claimed++;
+            // the loader may go on with the next file
+            progress.changed.notify_all();
+            progress.changed.wait(lock, [&progress, i] { return progress.loaded > i; });
+        }
+        if (!results[i].loaded) continue;
+
+        // the graph isn't needed anymore once solved, hence it is moved rather than copied
+        if (engine == DepthFirstSearchEngine) results[i].answers = solver.depthFirstSearchWithPruning(std::move(graphs[i]));
+        else results[i].answers = solver.arcConsistency(std::move(graphs[i]));
+        results[i].solution_count = solver.getSolutionCount();
+        results[i].revision_count = solver.getRevisionCount();
+    }
+};
@@ -0,0 +1,89 @@
+// Author: Akira Kudo
+// Description: Implements a solver for batches of independent CSP problems, e.g. one Gnosia
+//  game state per loop & day, spread over a fixed thread pool.
+//  Each thread of the pool keeps one CSPSolver as its workspace, reused from one problem
+//  to the next so that its trail & scratch buffers keep their capacity; a thread claims
+//  the next unsolved problem whenever it is done with one. Graphs are moved into the
+//  solver instead of being copied. When solving files, a loader thread parses them in
+//  order, staying up to one file per thread ahead of the solving threads.
+//  Results come back in the order the problems were given.
+
+#ifndef BATCHSOLVER_H
+#define BATCHSOLVER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "src/cspSolver/CSPGraph.h"
+#include "src/cspSolver/CSPSolver.h"
+#include "src/cspSolver/parallel/ThreadPool.h"
+#include "src/graphImplementation/vertices/VariableVertex.h"
+
+namespace CSPSolverImplementation
+{
+    class BatchSolver
+    {
+    public:
+        // which search of CSPSolver is run on each problem
+        enum SearchEngine { ArcConsistencyEngine, DepthFirstSearchEngine };
+
+        // outcome of solving one problem of the batch
+        struct Result
+        {
+            // false if the problem file couldn't be loaded, error then telling why
+            bool loaded;
+            std::string error;
+            // answers as returned by the search, e.g. empty in CountOnlyMode
+            std::vector<std::vector<GraphImplementation::VariableVertex>> answers;
+            size_t solution_count;
+            size_t revision_count;
+        };
+
+        // every workspace is a copy of settings, which sets the modes & heuristics used;
+        // as the batch already keeps every thread busy, ParallelMode is run as TrailMode
+        // thread_count counts the calling thread as well; 0 is treated as 1
+        BatchSolver(size_t thread_count, const CSPSolver& settings=CSPSolver(),
+                    SearchEngine engine=ArcConsistencyEngine);
+        ~BatchSolver();
+
+        // solves every graph, returning results in the same order
+        // rethrows the first exception thrown while solving, e.g. by a custom predicate
+        std::vector<Result> solve(std::vector<CSPGraph> graphs);
+        // loads & solves every file, either saved by CSPSolver::saveCspGraph or a text problem
+        // file read by CSPProblemLoader; returns results in the same order as the paths
+        // rethrows the first exception thrown while solving, the loader being stopped first
+        std::vector<Result> solveFiles(const std::vector<std::string>& paths);
+
+        // getters
+        size_t getThreadCount() const { return this->pool.getThreadCount(); };
+
+    private:
+        // hands out problems to solving threads, in order
+        struct Progress
+        {
+            std::mutex mutex;
+            std::condition_variable changed;
+            // number of problems ready to be solved, all of those coming first
+            size_t loaded;
+            // number of problems claimed by a solving thread
+            size_t claimed;
+            // set when solving stopped on an exception, so that the loader stops as well
+            bool cancelled;
+        };
+
+        ThreadPool pool;
+        std::vector<CSPSolver> workspaces;
+        SearchEngine engine;
+
+        // solves graphs with every workspace until each problem was claimed
+        void solveAll(std::vector<CSPGraph>& graphs, std::vector<Result>& results, Progress& progress);
+        // claims & solves problems one after the other using the given workspace
+        void runWorkspace(CSPSolver& solver, std::vector<CSPGraph>& graphs,
+                          std::vector<Result>& results, Progress& progress);
+    };
+}
+
+#endif
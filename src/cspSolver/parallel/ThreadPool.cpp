@@ -0,0 +1,151 @@
+// Author: Akira Kudo
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "src/cspSolver/parallel/ThreadPool.h"
+
+thread_local CSPSolverImplementation::ThreadPool* CSPSolverImplementation::ThreadPool::current_pool = nullptr;
+thread_local size_t CSPSolverImplementation::ThreadPool::current_queue_index = 0;
+
+// thread_count counts the threads waiting on groups as well, so
+// (thread_count - 1) background workers are started; 0 is treated as 1
+CSPSolverImplementation::ThreadPool::ThreadPool(size_t thread_count)
+    : queued_count(0), stopping(false)
+{
+    size_t worker_count = (thread_count > 1) ? thread_count - 1 : 0;
+    // one queue per worker, plus the shared one for other threads
+    for (size_t i = 0; i <= worker_count; i++) queues.push_back(std::make_unique<TaskQueue>());
+    for (size_t i = 0; i < worker_count; i++) workers.emplace_back(&ThreadPool::workerLoop, this, i);
+};
+
+CSPSolverImplementation::ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        stopping = true;
+    }
+    wake_up.notify_all();
+    for (std::thread& worker : workers) worker.join();
+};
+
+// queues a task as part of group
+void CSPSolverImplementation::ThreadPool::submit(TaskGroup& group, std::function<void()> task)
+{
+    group.pending++;
+    TaskQueue& queue = *queues[ownQueueIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(Task { std::move(task), &group });
+    }
+    {
+        // taking the lock makes sure a worker about to sleep sees the new count
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        queued_count++;
+    }
+    wake_up.notify_one();
+};
+
+// runs queued tasks until every task in group is finished, then rethrows
+// the first exception thrown by a task of group, if any
+void CSPSolverImplementation::ThreadPool::wait(TaskGroup& group)
+{
+    size_t own_index = ownQueueIndex();
+    while (!group.finished())
+    {
+        // help out instead of blocking; the tasks we wait on might be the ones we run
+        if (tryRunOneTask(own_index)) continue;
+        // sleep until either group finishes or some task is queued
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        wake_up.wait(lock, [this, &group] { return (group.finished() || queued_count.load() > 0); });
+    }
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(group.error_mutex);
+        std::swap(error, group.error);
+    }
+    if (error) std::rethrow_exception(error);
+};
+
+// ####################
+// PRIVATE FUNCTIONS
+// index of the queue owned by the calling thread
+size_t CSPSolverImplementation::ThreadPool::ownQueueIndex() const
+{
+    if (current_pool == this) return current_queue_index;
+    return workers.size();
+};
+
+// takes one task from our own queue, or steals one from another; returns false if none
+bool CSPSolverImplementation::ThreadPool::tryRunOneTask(size_t own_index)
+{
+    Task task;
+    bool found = false;
+    // newest task of our own queue first
+    {
+        TaskQueue& own_queue = *queues[own_index];
+        std::lock_guard<std::mutex> lock(own_queue.mutex);
+        if (!own_queue.tasks.empty())
+        {
+            task = std::move(own_queue.tasks.back());
+            own_queue.tasks.pop_back();
+            found = true;
+        }
+    }
+    // otherwise steal the oldest task of another queue
+    for (size_t offset = 1; !found && offset < queues.size(); offset++)
+    {
+        TaskQueue& other_queue = *queues[(own_index + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(other_queue.mutex);
+        if (!other_queue.tasks.empty())
+        {
+            task = std::move(other_queue.tasks.front());
+            other_queue.tasks.pop_front();
+            found = true;
+        }
+    }
+    if (!found) return false;
+
+    queued_count--;
+    try
+    {
+        task.function();
+    }
+    catch (...)
+    {
+        // kept for whoever waits on the group, which must be finished regardless
+        std::lock_guard<std::mutex> lock(task.group->error_mutex);
+        if (!task.group->error) task.group->error = std::current_exception();
+    }
+    // the group may be destroyed as soon as it is finished, so it isn't touched afterwards;
+    // taking the lock makes sure a thread about to wait on it sees the new count
+    if (task.group->pending.fetch_sub(1) == 1)
+    {
+        { std::lock_guard<std::mutex> lock(sleep_mutex); }
+        wake_up.notify_all();
+    }
+    return true;
+};
+
+// loop run by each background worker
+void CSPSolverImplementation::ThreadPool::workerLoop(size_t index)
+{
+    current_pool = this;
+    current_queue_index = index;
+    while (!stopping)
+    {
+        if (tryRunOneTask(index)) continue;
+        // sleep until some task is queued; the timeout only bounds the cost of a missed wake up
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        wake_up.wait_for(lock, std::chrono::milliseconds(10), 
+                         [this] { return (stopping || queued_count.load() > 0); });
+    }
+};
@@ -0,0 +1,93 @@
+// Author: Akira Kudo
+// Description: Implements a work-stealing thread pool used to explore independent
+//  branches of the search in parallel.
+//  Each worker keeps its own task deque: it runs its latest task first (depth-first),
+//  while idle workers steal the oldest tasks of others (closest to the root, hence
+//  likely the largest). Tasks are grouped into TaskGroups that a thread can wait on;
+//  a waiting thread keeps running tasks meanwhile, so tasks may spawn & wait on subtasks,
+//  and only sleeps once none is left to run.
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace CSPSolverImplementation
+{
+    class ThreadPool
+    {
+    public:
+        // counts the tasks of one fork-join group that aren't finished yet,
+        // keeping the first exception thrown by any of them
+        class TaskGroup
+        {
+        public:
+            TaskGroup() : pending(0) {};
+            bool finished() const { return (this->pending.load() == 0); };
+        private:
+            std::atomic<size_t> pending;
+            std::mutex error_mutex;
+            std::exception_ptr error;
+            friend class ThreadPool;
+        };
+
+        // thread_count counts the threads waiting on groups as well, so
+        // (thread_count - 1) background workers are started; 0 is treated as 1
+        ThreadPool(size_t thread_count);
+        ~ThreadPool();
+
+        // queues a task as part of group
+        void submit(TaskGroup& group, std::function<void()> task);
+        // runs queued tasks until every task in group is finished, then rethrows
+        // the first exception thrown by a task of group, if any
+        void wait(TaskGroup& group);
+
+        // getters
+        size_t getThreadCount() const { return this->workers.size() + 1; };
+
+    private:
+        struct Task
+        {
+            std::function<void()> function;
+            TaskGroup* group;
+        };
+        struct TaskQueue
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        // one queue per background worker, followed by one shared by every other thread
+        std::vector<std::unique_ptr<TaskQueue>> queues;
+        std::vector<std::thread> workers;
+        // number of tasks queued but not yet taken by any thread
+        std::atomic<size_t> queued_count;
+        std::atomic<bool> stopping;
+        // idle workers sleep here until a task is submitted, as do threads waiting on a group
+        // until either a task is submitted or a group finishes
+        std::mutex sleep_mutex;
+        std::condition_variable wake_up;
+
+        // pool & queue index of the calling thread, if it is one of our workers
+        static thread_local ThreadPool* current_pool;
+        static thread_local size_t current_queue_index;
+
+        // index of the queue owned by the calling thread
+        size_t ownQueueIndex() const;
+        // takes one task from our own queue, or steals one from another; returns false if none
+        bool tryRunOneTask(size_t own_index);
+        // loop run by each background worker
+        void workerLoop(size_t index);
+    };
+}
+
+#endif
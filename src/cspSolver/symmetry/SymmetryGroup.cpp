@@ -0,0 +1,237 @@
+// Author: Akira Kudo
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "src/cspSolver/CSPGraph.h"
+#include "src/cspSolver/symmetry/SymmetryGroup.h"
+#include "src/graphImplementation/vertices/ConstraintKernel.h"
+
+using GraphImplementation::ConstraintKernel;
+
+namespace
+{
+    // a * b, or SIZE_MAX if that doesn't fit
+    size_t saturatingProduct(size_t a, size_t b)
+    {
+        if (a != 0 && b > SIZE_MAX / a) return SIZE_MAX;
+        return a * b;
+    };
+
+    // number of ways to split n items into groups of the sizes given by runs, saturating at SIZE_MAX
+    size_t multinomial(size_t n, const std::vector<size_t>& runs)
+    {
+        size_t returned = 1;
+        for (size_t run : runs)
+        {
+            // n choose run, built up so that every division is exact
+            size_t binomial = 1;
+            for (size_t k = 1; k <= run; k++) binomial = saturatingProduct(binomial, n - run + k) / k;
+            returned = saturatingProduct(returned, binomial);
+            n -= run;
+        }
+        return returned;
+    };
+
+    // lengths of the runs of equal elements of sorted
+    template <typename T>
+    std::vector<size_t> runLengths(const std::vector<T>& sorted)
+    {
+        std::vector<size_t> returned;
+        for (size_t i = 0; i < sorted.size(); i++)
+        {
+            if (i == 0 || !(sorted[i] == sorted[i - 1])) returned.push_back(0);
+            returned.back()++;
+        }
+        return returned;
+    };
+}
+
+CSPSolverImplementation::SymmetryGroup::SymmetryGroup()
+{
+
+};
+
+CSPSolverImplementation::SymmetryGroup::~SymmetryGroup()
+{
+
+};
+
+// finds the interchangeable variables & values of graph given its current domains,
+// forgetting any found before
+void CSPSolverImplementation::SymmetryGroup::detect(const CSPGraph& graph)
+{
+    clear();
+    uint32_t num_variables = graph.num_variables();
+    // what a custom predicate checks is unknown, so variables in its scope & their values are never swapped
+    std::vector<bool> in_custom_scope(num_variables, false);
+    for (uint32_t cv_id = 0; cv_id < graph.num_constraints(); cv_id++)
+        if (graph.constraint_at(cv_id)->getKernel().getType() == ConstraintKernel::CustomPredicate)
+            for (uint32_t vv_id : graph.variable_neighbor_ids(cv_id)) in_custom_scope[vv_id] = true;
+
+    // variables are told apart by the constraints they touch & the domain they hold
+    std::map<std::vector<int>, std::vector<uint32_t>> variables_by_signature;
+    for (uint32_t vv_id = 0; vv_id < num_variables; vv_id++)
+    {
+        if (in_custom_scope[vv_id]) continue;
+        IdSpan constraint_ids = graph.constraint_neighbor_ids(vv_id);
+        std::vector<int> signature(constraint_ids.begin(), constraint_ids.end());
+        std::sort(signature.begin(), signature.end());
+        signature.insert(signature.begin(), (int) constraint_ids.size());
+        for (int val : graph.variable_at(vv_id)->getDomainStore()) signature.push_back(val);
+        variables_by_signature[signature].push_back(vv_id);
+    }
+    for (auto& [signature, variable_class] : variables_by_signature)
+        if (variable_class.size() >= 2) variable_classes.push_back(variable_class);
+    std::sort(variable_classes.begin(), variable_classes.end());
+    variable_class_of.assign(num_variables, 0);
+    uint32_t next_class = (uint32_t) variable_classes.size();
+    for (uint32_t vv_id = 0; vv_id < num_variables; vv_id++) variable_class_of[vv_id] = next_class++;
+    for (uint32_t i = 0; i < variable_classes.size(); i++)
+        for (uint32_t vv_id : variable_classes[i]) variable_class_of[vv_id] = i;
+
+    // values are told apart by the variables holding them...
+    std::map<int, std::vector<int>> value_signatures;
+    std::set<int> in_custom_values;
+    for (uint32_t vv_id = 0; vv_id < num_variables; vv_id++)
+        for (int val : graph.variable_at(vv_id)->getDomainStore())
+        {
+            value_signatures[val].push_back((int) vv_id);
+            if (in_custom_scope[vv_id]) in_custom_values.insert(val);
+        }
+    // ...& by the constraints counting them, cardinality constraints over the same variables being twins
+    std::map<int, std::vector<std::vector<int>>> counted_by;
+    std::map<std::vector<uint32_t>, int> scope_keys;
+    for (uint32_t cv_id = 0; cv_id < graph.num_constraints(); cv_id++)
+    {
+        const ConstraintKernel& kernel = graph.constraint_at(cv_id)->getKernel();
+        switch (kernel.getType())
+        {
+            case ConstraintKernel::LesserOrEqualToN:
+            case ConstraintKernel::GreaterOrEqualToN:
+            case ConstraintKernel::ExactlyN:
+            {
+                IdSpan scope_ids = graph.variable_neighbor_ids(cv_id);
+                std::vector<uint32_t> scope(scope_ids.begin(), scope_ids.end());
+                std::sort(scope.begin(), scope.end());
+                int scope_key = scope_keys.emplace(scope, (int) scope_keys.size()).first->second;
+                counted_by[kernel.getCheckedValue()].push_back({ 0, scope_key, (int) kernel.getType(), kernel.getN() });
+                break;
+            }
+            case ConstraintKernel::GlobalCardinality:
+                for (const ConstraintKernel::CardinalityBound& bound : kernel.getBounds())
+                    counted_by[bound.value].push_back({ 1, (int) cv_id, bound.min, bound.max });
+                break;
+            // every value is alike to an all different constraint, & custom predicates were dealt with above
+            default: break;
+        }
+    }
+    std::map<std::vector<int>, std::vector<int>> values_by_signature;
+    for (auto& [val, signature] : value_signatures)
+    {
+        if (in_custom_values.count(val) > 0) continue;
+        // holders of val are followed by what counts it, with a separator no variable id takes
+        signature.push_back(-1);
+        std::vector<std::vector<int>>& counts = counted_by[val];
+        std::sort(counts.begin(), counts.end());
+        for (const std::vector<int>& count : counts) signature.insert(signature.end(), count.begin(), count.end());
+        values_by_signature[signature].push_back(val);
+    }
+    for (auto& [signature, value_class] : values_by_signature)
+        if (value_class.size() >= 2) value_classes.push_back(value_class);
+    std::sort(value_classes.begin(), value_classes.end());
+    for (uint32_t i = 0; i < value_classes.size(); i++)
+    {
+        for (int val : value_classes[i]) value_class_of[val] = i;
+        const std::vector<int>& holders = value_signatures[value_classes[i].front()];
+        value_holders.emplace_back(holders.begin(), std::find(holders.begin(), holders.end(), -1));
+    }
+};
+
+// forgets every class found
+void CSPSolverImplementation::SymmetryGroup::clear()
+{
+    variable_classes.clear();
+    value_classes.clear();
+    value_holders.clear();
+    variable_class_of.clear();
+    value_class_of.clear();
+};
+
+// number of answers symmetric to the answer giving values[vv_id] to each variable, itself included;
+// saturates at SIZE_MAX
+size_t CSPSolverImplementation::SymmetryGroup::orbitSize(const int* values) const
+{
+    size_t returned = 1;
+    // interchangeable variables taking the same value give the same answer once swapped
+    for (const std::vector<uint32_t>& variable_class : variable_classes)
+    {
+        std::vector<int> taken;
+        for (uint32_t vv_id : variable_class) taken.push_back(values[vv_id]);
+        std::sort(taken.begin(), taken.end());
+        returned = saturatingProduct(returned, multinomial(taken.size(), runLengths(taken)));
+    }
+    // so do interchangeable values taken by as many variables of each class, e.g. values taken by none
+    for (size_t i = 0; i < value_classes.size(); i++)
+        returned = saturatingProduct(returned, multinomial(value_classes[i].size(), runLengths(valueColumns(values, i))));
+    return returned;
+};
+
+// key shared by the answers symmetric to the answer given by values, & by them only
+std::vector<int> CSPSolverImplementation::SymmetryGroup::orbitKey(const int* values) const
+{
+    std::vector<int> returned;
+    // each value is written as (0, value), or as (1, index of its class) if interchangeable with others
+    auto key_of = [this, values](uint32_t vv_id) -> std::pair<int, int>
+    {
+        auto found = value_class_of.find(values[vv_id]);
+        if (found == value_class_of.end()) return { 0, values[vv_id] };
+        return { 1, (int) found->second };
+    };
+    // the values taken within each variable class, whatever their order...
+    for (const std::vector<uint32_t>& variable_class : variable_classes)
+    {
+        std::vector<std::pair<int, int>> taken;
+        for (uint32_t vv_id : variable_class) taken.push_back(key_of(vv_id));
+        std::sort(taken.begin(), taken.end());
+        for (auto& [is_class, val] : taken) returned.insert(returned.end(), { is_class, val });
+    }
+    for (uint32_t vv_id = 0; vv_id < variable_class_of.size(); vv_id++)
+    {
+        if (variable_class_of[vv_id] < variable_classes.size()) continue;
+        auto [is_class, val] = key_of(vv_id);
+        returned.insert(returned.end(), { is_class, val });
+    }
+    // ...& where each interchangeable value is taken, whatever value it is
+    for (size_t i = 0; i < value_classes.size(); i++)
+        for (const std::vector<uint32_t>& column : valueColumns(values, i))
+        {
+            returned.push_back((int) column.size());
+            returned.insert(returned.end(), column.begin(), column.end());
+        }
+    return returned;
+};
+
+// ####################
+// PRIVATE FUNCTIONS
+// where each value of the i-th value class is taken, as the variable class of every variable
+// taking it, in increasing order; values taken by no variable come first, each as an empty list
+std::vector<std::vector<uint32_t>> CSPSolverImplementation::SymmetryGroup::valueColumns(const int* values, size_t i) const
+{
+    const std::vector<int>& value_class = value_classes[i];
+    std::vector<std::vector<uint32_t>> returned(value_class.size());
+    for (uint32_t vv_id : value_holders[i])
+    {
+        auto position = std::lower_bound(value_class.begin(), value_class.end(), values[vv_id]);
+        if (position == value_class.end() || *position != values[vv_id]) continue;
+        returned[position - value_class.begin()].push_back(variable_class_of[vv_id]);
+    }
+    for (std::vector<uint32_t>& column : returned) std::sort(column.begin(), column.end());
+    std::sort(returned.begin(), returned.end());
+    return returned;
+};
@@ -0,0 +1,68 @@
+// Author: Akira Kudo
+// Description: Implements the detection of interchangeable variables & values of a CSPGraph.
+//  Two variables are interchangeable when they touch the very same constraints, none of which
+//  is a custom predicate, and hold the same domain: every constraint we know of the scope of
+//  is blind to the order of its variables, so swapping their values in an answer gives another.
+//  Two values are interchangeable when the same variables hold them and the constraints counting
+//  one have a twin counting the other over the same variables, with the same bound; swapping
+//  them in an answer gives another as well. The group also tells how many answers are symmetric
+//  to a given one, and keys identifying each set of symmetric answers.
+
+#ifndef SYMMETRYGROUP_H
+#define SYMMETRYGROUP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "src/cspSolver/CSPGraph.h"
+
+namespace CSPSolverImplementation
+{
+    class SymmetryGroup
+    {
+    public:
+        SymmetryGroup();
+        ~SymmetryGroup();
+
+        // finds the interchangeable variables & values of graph given its current domains,
+        // forgetting any found before
+        // REQUIRES that graph is frozen
+        void detect(const CSPGraph& graph);
+        // forgets every class found
+        void clear();
+
+        // getters
+        // whether no two variables nor values are interchangeable
+        bool empty() const { return this->variable_classes.empty() && this->value_classes.empty(); };
+        // classes of two or more interchangeable variables, each sorted by id
+        const std::vector<std::vector<uint32_t>>& getVariableClasses() const { return this->variable_classes; };
+        // classes of two or more interchangeable values, each sorted in increasing order
+        const std::vector<std::vector<int>>& getValueClasses() const { return this->value_classes; };
+        // ids of the variables holding the values of the i-th value class, sorted by id
+        const std::vector<uint32_t>& getValueHolders(size_t i) const { return this->value_holders[i]; };
+
+        // number of answers symmetric to the answer giving values[vv_id] to each variable, itself included;
+        // saturates at SIZE_MAX
+        size_t orbitSize(const int* values) const;
+        // key shared by the answers symmetric to the answer given by values, & by them only
+        std::vector<int> orbitKey(const int* values) const;
+
+    private:
+        std::vector<std::vector<uint32_t>> variable_classes;
+        std::vector<std::vector<int>> value_classes;
+        std::vector<std::vector<uint32_t>> value_holders;
+        // index of the variable class of each variable, by id; variables without any other
+        // interchangeable one get a class of their own, numbered after the others
+        std::vector<uint32_t> variable_class_of;
+        // index of the value class of each value interchangeable with others
+        std::unordered_map<int, uint32_t> value_class_of;
+
+        // where each value of the i-th value class is taken, as the variable class of every variable
+        // taking it, in increasing order; values taken by no variable come first, each as an empty list
+        std::vector<std::vector<uint32_t>> valueColumns(const int* values, size_t i) const;
+    };
+}
+
+#endif
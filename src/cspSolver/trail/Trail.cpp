@@ -0,0 +1,129 @@
+// Author: Akira Kudo
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "src/cspSolver/trail/Trail.h"
+#include "src/graphImplementation/vertices/VariableVertex.h"
+
+using GraphImplementation::VariableVertex;
+
+CSPSolverImplementation::Trail::Trail()
+    : empty_domains(0), single_domains(0), hashing(false), domain_hash(0), check_hash(0)
+{
+
+};
+
+CSPSolverImplementation::Trail::~Trail()
+{
+
+};
+
+// removes val from the domain of vv, recording the removal if a choice point is open
+// returns whether val was removed
+bool CSPSolverImplementation::Trail::removeFromDomain(VariableVertex* vv, int val)
+{
+    if (!vv->removeFromDomain(val)) return false;
+    // the domain just went from 2 values to 1, or from 1 to none
+    size_t new_size = vv->getDomainSize();
+    if (new_size == 1) single_domains++;
+    else if (new_size == 0) 
+    {
+        single_domains--;
+        empty_domains++;
+    }
+    if (hashing) toggleHashes(vv, val);
+    // outside of any choice point, there is nothing to restore to
+    if (!choice_points.empty()) removals.push_back(Removal { vv, val });
+    return true;
+};
+
+// removes every value but val from the domain of vv, recording removals if a choice point is open
+// returns whether the domain changed
+bool CSPSolverImplementation::Trail::restrictDomainTo(VariableVertex* vv, int val)
+{
+    bool changed = false;
+    // iterating the domain store stays valid while we remove the value we are on
+    for (int dom_val : vv->getDomainStore())
+    {
+        if (dom_val != val) changed = removeFromDomain(vv, dom_val) || changed;
+    }
+    return changed;
+};
+
+// opens a choice point; changes made from here on are undone by undoToLastChoicePoint
+void CSPSolverImplementation::Trail::markChoicePoint()
+{
+    choice_points.push_back(removals.size());
+};
+
+// restores every removal made since the last choice point, then closes it
+// does nothing if no choice point is open
+void CSPSolverImplementation::Trail::undoToLastChoicePoint()
+{
+    if (choice_points.empty()) return;
+    size_t restore_to = choice_points.back();
+    choice_points.pop_back();
+    // restore in reverse order of removal
+    while (removals.size() > restore_to)
+    {
+        VariableVertex* vv = removals.back().vv;
+        // the domain is about to go from none to 1 value, or from 1 to 2
+        size_t old_size = vv->getDomainSize();
+        if (old_size == 0)
+        {
+            empty_domains--;
+            single_domains++;
+        }
+        else if (old_size == 1) single_domains--;
+        vv->addToDomain(removals.back().val);
+        if (hashing) toggleHashes(vv, removals.back().val);
+        removals.pop_back();
+    }
+};
+
+// forgets every recorded removal and choice point without restoring anything,
+// also resetting the domain counts
+void CSPSolverImplementation::Trail::clear()
+{
+    removals.clear();
+    choice_points.clear();
+    empty_domains = 0;
+    single_domains = 0;
+    domain_hash = 0;
+    check_hash = 0;
+};
+
+// sets the domain counts for the variables changes will be made to from here on
+void CSPSolverImplementation::Trail::setDomainCounts(size_t empty_domains, size_t single_domains)
+{
+    this->empty_domains = empty_domains;
+    this->single_domains = single_domains;
+};
+
+// sets the domain hashes for the variables changes will be made to from here on
+void CSPSolverImplementation::Trail::setDomainHashes(uint64_t domain_hash, uint64_t check_hash)
+{
+    this->domain_hash = domain_hash;
+    this->check_hash = check_hash;
+};
+
+// key of value val held by variable vv_id, in the domain hash for seed 0 & in the check hash for seed 1
+uint64_t CSPSolverImplementation::Trail::valueKey(uint32_t vv_id, int val, uint64_t seed)
+{
+    // splitmix64 finalizer, spreading each bit of the pair over the whole key
+    uint64_t key = (((uint64_t) vv_id << 32) | (uint32_t) val) + (seed + 1) * 0x9e3779b97f4a7c15ULL;
+    key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+    return key ^ (key >> 31);
+};
+
+// ####################
+// PRIVATE FUNCTIONS
+// updates the domain hashes for val being added to / removed from the domain of vv
+void CSPSolverImplementation::Trail::toggleHashes(const VariableVertex* vv, int val)
+{
+    domain_hash ^= valueKey(vv->getId(), val, 0);
+    check_hash ^= valueKey(vv->getId(), val, 1);
+};
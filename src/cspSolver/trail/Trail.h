@@ -0,0 +1,89 @@
+// Author: Akira Kudo
+// Description: Implements an undo trail recording domain removals made during search.
+//  Opening a choice point before trying a branch, then undoing back to it afterwards,
+//  lets a single CSPGraph be reused for every branch instead of copying it per branch;
+//  memory then grows with the search depth rather than with the number of open branches.
+//  The trail also keeps count of the empty & single valued domains, updated on every change
+//  made or undone through it, so that the solver can tell in O(1) whether a branch failed
+//  or every variable got a value. When asked to, it also keeps two hashes of every domain up to
+//  date the same way, each being the xor of a key per value held by each variable, so that the 
+//  solver can tell a state it searched before in O(1); see TranspositionCache.
+
+#ifndef TRAIL_H
+#define TRAIL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "src/graphImplementation/vertices/VariableVertex.h"
+
+namespace CSPSolverImplementation
+{
+    class Trail
+    {
+    public:
+        Trail();
+        ~Trail();
+
+        // removes val from the domain of vv, recording the removal if a choice point is open
+        // returns whether val was removed
+        bool removeFromDomain(GraphImplementation::VariableVertex* vv, int val);
+        // removes every value but val from the domain of vv, recording removals if a choice point is open
+        // returns whether the domain changed
+        bool restrictDomainTo(GraphImplementation::VariableVertex* vv, int val);
+        // opens a choice point; changes made from here on are undone by undoToLastChoicePoint
+        void markChoicePoint();
+        // restores every removal made since the last choice point, then closes it
+        // does nothing if no choice point is open
+        void undoToLastChoicePoint();
+        // forgets every recorded removal and choice point without restoring anything,
+        // also resetting the domain counts
+        void clear();
+        // sets the domain counts for the variables changes will be made to from here on
+        void setDomainCounts(size_t empty_domains, size_t single_domains);
+        // turns keeping the domain hashes up to date on or off
+        void setHashing(bool hashing) { this->hashing = hashing; };
+        // sets the domain hashes for the variables changes will be made to from here on
+        void setDomainHashes(uint64_t domain_hash, uint64_t check_hash);
+        // key of value val held by variable vv_id, in the domain hash for seed 0 & in the check hash for seed 1
+        static uint64_t valueKey(uint32_t vv_id, int val, uint64_t seed);
+
+        // getters
+        // number of removals currently recorded
+        size_t size() const { return this->removals.size(); };
+        // number of choice points currently open
+        size_t depth() const { return this->choice_points.size(); };
+        // number of empty / single valued domains, as last set by setDomainCounts 
+        // and updated by changes made through the trail since then
+        size_t emptyDomainCount() const { return this->empty_domains; };
+        size_t singleDomainCount() const { return this->single_domains; };
+        // hashes of every domain, as last set by setDomainHashes and updated by changes made
+        // through the trail since then while hashing
+        bool isHashing() const { return this->hashing; };
+        uint64_t domainHash() const { return this->domain_hash; };
+        uint64_t checkHash() const { return this->check_hash; };
+
+    private:
+        // a single value removed from the domain of a variable
+        struct Removal
+        {
+            GraphImplementation::VariableVertex* vv;
+            int val;
+        };
+
+        std::vector<Removal> removals;
+        // size of removals when each open choice point was marked
+        std::vector<size_t> choice_points;
+        size_t empty_domains;
+        size_t single_domains;
+        bool hashing;
+        uint64_t domain_hash;
+        uint64_t check_hash;
+
+        // updates the domain hashes for val being added to / removed from the domain of vv
+        void toggleHashes(const GraphImplementation::VariableVertex* vv, int val);
+    };
+}
+
+#endif
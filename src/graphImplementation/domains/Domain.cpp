@@ -0,0 +1,294 @@
+// Author: Akira Kudo
+
+#include <cstdint>
+#include <initializer_list>
+#include <set>
+#include <vector>
+
+#include "src/graphImplementation/domains/Domain.h"
+
+using GraphImplementation::Domain;
+
+GraphImplementation::Domain::Domain(DomainMode mode)
+    : mode(mode), count(0), base(0), first_word(0)
+{
+
+};
+
+GraphImplementation::Domain::Domain(std::initializer_list<int> values, DomainMode mode)
+    : Domain(mode)
+{
+    for (int val : values) insert(val);
+};
+
+GraphImplementation::Domain::Domain(const std::set<int>& values, DomainMode mode)
+    : Domain(mode)
+{
+    // a std::set is sorted, so sizing the bitset for the whole range first avoids regrowing
+    if (!values.empty() && this->mode == BitsetMode)
+    {
+        int64_t range = (int64_t) *values.rbegin() - *values.begin() + 1;
+        if (range > MAX_BITSET_RANGE) 
+        {
+            switchToSetMode();
+        }
+        else
+        {
+            this->base = *values.begin();
+            this->extra_words.assign((size_t) ((range + 63) / 64) - 1, 0);
+        }
+    }
+    for (int val : values) insert(val);
+};
+
+GraphImplementation::Domain::~Domain()
+{
+
+};
+
+// returns whether val is in the domain - O(1) in BitsetMode
+bool GraphImplementation::Domain::contains(int val) const
+{
+    if (mode == SetMode) return (values.find(val) != values.end());
+
+    int64_t offset = (int64_t) val - base;
+    if (offset < 0 || offset >= (int64_t) (numWords() * 64)) return false;
+    return ((word(offset >> 6) >> (offset & 63)) & 1ULL);
+};
+
+// inserts val if not there; returns whether the domain changed
+bool GraphImplementation::Domain::insert(int val)
+{
+    if (mode == BitsetMode) makeRoomFor(val);
+    // makeRoomFor might have switched us to SetMode
+    if (mode == SetMode)
+    {
+        bool inserted = values.insert(val).second;
+        if (inserted) count++;
+        return inserted;
+    }
+
+    int64_t offset = (int64_t) val - base;
+    uint64_t& w = word(offset >> 6);
+    uint64_t mask = 1ULL << (offset & 63);
+    if (w & mask) return false;
+    w |= mask;
+    count++;
+    return true;
+};
+
+// removes val if there; returns whether the domain changed - O(1) in BitsetMode
+bool GraphImplementation::Domain::erase(int val)
+{
+    if (mode == SetMode)
+    {
+        bool erased = (values.erase(val) != 0);
+        if (erased) count--;
+        return erased;
+    }
+
+    int64_t offset = (int64_t) val - base;
+    if (offset < 0 || offset >= (int64_t) (numWords() * 64)) return false;
+    uint64_t& w = word(offset >> 6);
+    uint64_t mask = 1ULL << (offset & 63);
+    if (!(w & mask)) return false;
+    w &= ~mask;
+    count--;
+    return true;
+};
+
+// removes every value but val; returns whether the domain changed
+bool GraphImplementation::Domain::keepOnly(int val)
+{
+    bool had_val = contains(val);
+    // nothing changes if val is the only value already
+    if (had_val && count == 1) return false;
+    // if val isn't there, keeping only val empties the domain
+    if (!had_val)
+    {
+        bool was_empty = empty();
+        clear();
+        return !was_empty;
+    }
+
+    if (mode == SetMode)
+    {
+        values.clear();
+        values.insert(val);
+    }
+    else
+    {
+        int64_t offset = (int64_t) val - base;
+        first_word = 0;
+        for (uint64_t& w : extra_words) w = 0;
+        word(offset >> 6) = 1ULL << (offset & 63);
+    }
+    count = 1;
+    return true;
+};
+
+// removes every value not found in other; returns whether the domain changed
+bool GraphImplementation::Domain::intersectWith(const Domain& other)
+{
+    size_t old_count = count;
+
+    if (mode == BitsetMode && other.mode == BitsetMode && base == other.base)
+    {
+        // fast path: word-wise and, followed by a popcount
+        for (size_t i = 0; i < numWords(); i++)
+            word(i) &= (i < other.numWords()) ? other.word(i) : 0;
+        recount();
+    }
+    else
+    {
+        // generic path: erase values one by one
+        for (int val : *this)
+            if (!other.contains(val)) erase(val);
+    }
+    return (count != old_count);
+};
+
+// removes every value
+void GraphImplementation::Domain::clear()
+{
+    values.clear();
+    first_word = 0;
+    for (uint64_t& w : extra_words) w = 0;
+    count = 0;
+};
+
+// smallest value in the domain
+// REQUIRES that the domain isn't empty - or does undefined behavior!
+int GraphImplementation::Domain::min() const
+{
+    if (mode == SetMode) return *values.begin();
+    for (size_t i = 0; i < numWords(); i++)
+    {
+        uint64_t w = word(i);
+        if (w) return base + (int) (i * 64) + __builtin_ctzll(w);
+    }
+    return base;
+};
+
+// largest value in the domain
+// REQUIRES that the domain isn't empty - or does undefined behavior!
+int GraphImplementation::Domain::max() const
+{
+    if (mode == SetMode) return *values.rbegin();
+    for (size_t i = numWords(); i > 0; i--)
+    {
+        uint64_t w = word(i - 1);
+        if (w) return base + (int) ((i - 1) * 64) + 63 - __builtin_clzll(w);
+    }
+    return base;
+};
+
+// finds the smallest value strictly greater than after, storing it in found;
+// returns false if there is no such value
+bool GraphImplementation::Domain::nextValue(int after, int& found) const
+{
+    if (mode == SetMode)
+    {
+        auto position = values.upper_bound(after);
+        if (position == values.end()) return false;
+        found = *position;
+        return true;
+    }
+
+    int64_t offset = (int64_t) after - base + 1;
+    if (offset < 0) offset = 0;
+    int64_t num_bits = (int64_t) numWords() * 64;
+    if (offset >= num_bits) return false;
+
+    size_t i = offset >> 6;
+    // mask away bits below offset in the first word we look at
+    uint64_t w = word(i) & (~0ULL << (offset & 63));
+    while (true)
+    {
+        if (w)
+        {
+            found = base + (int) (i * 64) + __builtin_ctzll(w);
+            return true;
+        }
+        if (++i >= numWords()) return false;
+        w = word(i);
+    }
+};
+
+std::set<int> GraphImplementation::Domain::toSet() const
+{
+    if (mode == SetMode) return values;
+    std::set<int> returned;
+    for (int val : *this) returned.insert(returned.end(), val);
+    return returned;
+};
+
+Domain::const_iterator GraphImplementation::Domain::begin() const
+{
+    if (empty()) return end();
+    return const_iterator(this, false, min());
+};
+
+// two domains are equal if they hold the same values, regardless of mode
+bool GraphImplementation::Domain::operator==(const Domain& other) const
+{
+    if (count != other.count) return false;
+    for (int val : *this)
+        if (!other.contains(val)) return false;
+    return true;
+};
+
+// ####################
+// PRIVATE FUNCTIONS
+// recomputes count from the bitset using popcount
+void GraphImplementation::Domain::recount()
+{
+    count = 0;
+    for (size_t i = 0; i < numWords(); i++) count += __builtin_popcountll(word(i));
+};
+
+// grows the bitset so that it can hold val, or switches to SetMode if too wide
+void GraphImplementation::Domain::makeRoomFor(int val)
+{
+    int64_t num_bits = (int64_t) numWords() * 64;
+    int64_t offset = (int64_t) val - base;
+    if (offset >= 0 && offset < num_bits) return;
+
+    // an empty domain can simply be re-based on val
+    if (count == 0)
+    {
+        base = val;
+        first_word = 0;
+        extra_words.clear();
+        return;
+    }
+
+    int64_t new_base = (offset < 0) ? (int64_t) val : (int64_t) base;
+    int64_t new_top = (offset < 0) ? (int64_t) base + num_bits : (int64_t) val + 1;
+    if (new_top - new_base > MAX_BITSET_RANGE)
+    {
+        switchToSetMode();
+        return;
+    }
+
+    // copy old values into a bitset wide enough for [new_base, new_top)
+    size_t new_num_words = (size_t) ((new_top - new_base + 63) / 64);
+    std::vector<uint64_t> new_words(new_num_words, 0);
+    for (int old_val : *this)
+    {
+        int64_t new_offset = (int64_t) old_val - new_base;
+        new_words[new_offset >> 6] |= 1ULL << (new_offset & 63);
+    }
+    base = (int) new_base;
+    first_word = new_words[0];
+    extra_words.assign(new_words.begin() + 1, new_words.end());
+};
+
+// converts a bitset domain to SetMode
+void GraphImplementation::Domain::switchToSetMode()
+{
+    values = toSet();
+    mode = SetMode;
+    first_word = 0;
+    extra_words.clear();
+};
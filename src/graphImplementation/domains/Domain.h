@@ -0,0 +1,139 @@
+// Author: Akira Kudo
+// Description: Implements the domain store held by each VariableVertex.
+//  By default, domain values are kept as a bitset relative to the smallest value
+//  ever inserted, so that size, membership and removal are all O(1); 8 Gnosia roles
+//  or 9 sudoku values fit in a single machine word without any heap allocation.
+//  A std::set backed mode is kept selectable for sparse domains with huge ranges.
+
+#ifndef GRAPHIMPLEMENTATION_DOMAINS_DOMAIN_H
+#define GRAPHIMPLEMENTATION_DOMAINS_DOMAIN_H
+
+#include <cstdint>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <set>
+#include <vector>
+
+namespace GraphImplementation
+{
+    class Domain
+    {
+    public:
+        enum DomainMode { BitsetMode, SetMode };
+
+        // bitsets spanning more values than this fall back to SetMode automatically
+        static const int MAX_BITSET_RANGE = 1 << 16;
+
+        // iterates over domain values in ascending order; stays valid when the
+        // value it currently points to is removed from the domain
+        class const_iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = int;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const int*;
+            using reference = const int&;
+
+            const_iterator(const Domain* domain, bool at_end, int value)
+                : domain(domain), at_end(at_end), value(value) {};
+
+            const int& operator*() const { return value; };
+            const_iterator& operator++()
+            {
+                at_end = !domain->nextValue(value, value);
+                return *this;
+            };
+            const_iterator operator++(int)
+            {
+                const_iterator returned = *this;
+                ++(*this);
+                return returned;
+            };
+            bool operator==(const const_iterator& other) const
+            {
+                if (at_end || other.at_end) return (at_end == other.at_end);
+                return (value == other.value);
+            };
+            bool operator!=(const const_iterator& other) const { return !(*this == other); };
+
+        private:
+            const Domain* domain;
+            bool at_end;
+            int value;
+        };
+
+        Domain(DomainMode mode=BitsetMode);
+        Domain(std::initializer_list<int> values, DomainMode mode=BitsetMode);
+        Domain(const std::set<int>& values, DomainMode mode=BitsetMode);
+        ~Domain();
+
+        // returns whether val is in the domain - O(1) in BitsetMode
+        bool contains(int val) const;
+        // inserts val if not there; returns whether the domain changed
+        bool insert(int val);
+        // removes val if there; returns whether the domain changed - O(1) in BitsetMode
+        bool erase(int val);
+        // removes every value but val; returns whether the domain changed
+        bool keepOnly(int val);
+        // removes every value not found in other; returns whether the domain changed
+        bool intersectWith(const Domain& other);
+        // removes every value
+        void clear();
+
+        // smallest / largest value in the domain
+        // REQUIRES that the domain isn't empty - or does undefined behavior!
+        int min() const;
+        int max() const;
+        // finds the smallest value strictly greater than after, storing it in found;
+        // returns false if there is no such value
+        bool nextValue(int after, int& found) const;
+
+        // getters
+        size_t size() const { return this->count; };
+        bool empty() const { return (this->count == 0); };
+        DomainMode getMode() const { return this->mode; };
+        std::set<int> toSet() const;
+
+        const_iterator begin() const;
+        const_iterator end() const { return const_iterator(this, true, 0); };
+
+        // two domains are equal if they hold the same values, regardless of mode
+        bool operator==(const Domain& other) const;
+        bool operator!=(const Domain& other) const { return !(*this == other); };
+
+        // overload << operator
+        friend std::ostream& operator<<(std::ostream& os, const Domain& d) {
+            os << "{ ";
+            for (int val : d) os << val << " ";
+            os << "}";
+            return os;
+        };
+
+    private:
+        DomainMode mode;
+        // number of values held, kept up to date on every change
+        size_t count;
+        // BitsetMode storage: bit i of the bitset stands for the value (base + i)
+        int base;
+        // the first word is kept inline so that small domains never allocate
+        uint64_t first_word;
+        std::vector<uint64_t> extra_words;
+        // SetMode storage
+        std::set<int> values;
+
+        // number of 64 bit words spanned by the bitset
+        size_t numWords() const { return 1 + this->extra_words.size(); };
+        uint64_t word(size_t i) const { return (i == 0) ? first_word : extra_words[i - 1]; };
+        uint64_t& word(size_t i) { return (i == 0) ? first_word : extra_words[i - 1]; };
+        // recomputes count from the bitset using popcount
+        void recount();
+        // grows the bitset so that it can hold val, or switches to SetMode if too wide
+        void makeRoomFor(int val);
+        // converts a bitset domain to SetMode
+        void switchToSetMode();
+    };
+}
+
+#endif
@@ -0,0 +1,392 @@
+// Author: Akira Kudo
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "src/graphImplementation/vertices/ConstraintKernel.h"
+#include "src/graphImplementation/vertices/VariableVertex.h"
+
+using std::vector, GraphImplementation::ConstraintKernel, GraphImplementation::Domain, GraphImplementation::VariableVertex;
+
+namespace
+{
+    // matching of the variables of a scope to the values of their domains, in which each value is
+    // matched to between lower & upper variables, as checked by GlobalCardinality & AllDifferent kernels
+    // (the flow network of Regin's filtering, with variables on one side & values on the other)
+    class CardinalityMatching
+    {
+    public:
+        static constexpr uint32_t NONE = UINT32_MAX;
+
+        // domains[x] lists the values variable x may take; values without a bound may be
+        // matched to up to unbounded_max variables
+        CardinalityMatching(const vector<vector<int>>& domains, const vector<ConstraintKernel::CardinalityBound>& bounds,
+                            int unbounded_max)
+            : num_vars((uint32_t) domains.size())
+        {
+            for (const vector<int>& domain : domains) values.insert(values.end(), domain.begin(), domain.end());
+            for (const ConstraintKernel::CardinalityBound& bound : bounds) values.push_back(bound.value);
+            std::sort(values.begin(), values.end());
+            values.erase(std::unique(values.begin(), values.end()), values.end());
+            lower.assign(values.size(), 0);
+            upper.assign(values.size(), unbounded_max);
+            for (const ConstraintKernel::CardinalityBound& bound : bounds)
+            {
+                uint32_t v = valueId(bound.value);
+                lower[v] = bound.min;
+                upper[v] = bound.max;
+            }
+            value_ids.resize(num_vars);
+            for (uint32_t x = 0; x < num_vars; x++)
+                for (int val : domains[x]) value_ids[x].push_back(valueId(val));
+        };
+
+        // matches every variable to one of its values within the bounds; returns false if impossible
+        // hint, if given, holds a value per variable from an earlier matching, kept wherever still possible
+        bool solve(const vector<int>* hint=nullptr)
+        {
+            assigned.assign(num_vars, NONE);
+            load.assign(values.size(), 0);
+            for (uint32_t v = 0; v < values.size(); v++) if (lower[v] > upper[v]) return false;
+            bool hinted = (hint != nullptr && hint->size() == num_vars);
+            for (uint32_t x = 0; hinted && x < num_vars; x++)
+            {
+                uint32_t v = valueId((*hint)[x]);
+                if (v < values.size() && values[v] == (*hint)[x] && load[v] < upper[v] &&
+                    std::find(value_ids[x].begin(), value_ids[x].end(), v) != value_ids[x].end()) 
+                    match(x, v);
+            }
+            // first meet every lower bound, then match the remaining variables within the upper bounds;
+            // an augmenting path never lowers the number of variables matched to a value along it
+            for (uint32_t x = 0; x < num_vars; x++)
+            {
+                visited.assign(values.size(), false);
+                augment(x, lower);
+            }
+            // a hinted matching may leave no free variable to meet a lower bound with; start over then
+            for (uint32_t v = 0; v < values.size(); v++) if (load[v] < lower[v]) return hinted ? solve() : false;
+            for (uint32_t x = 0; x < num_vars; x++)
+            {
+                if (assigned[x] != NONE) continue;
+                visited.assign(values.size(), false);
+                if (!augment(x, upper)) return false;
+            }
+            return true;
+        };
+
+        // REQUIRES that solve() returned true
+        // numbers the strongly connected components of the residual graph, over which a variable 
+        // may be moved to a value it isn't matched to iff both lie in the same component
+        void findComponents()
+        {
+            uint32_t num_nodes = num_vars + (uint32_t) values.size() + 1;
+            component.assign(num_nodes, NONE);
+            index.assign(num_nodes, NONE);
+            low_link.assign(num_nodes, 0);
+            on_stack.assign(num_nodes, false);
+            stack.clear();
+            next_index = 0;
+            next_component = 0;
+            for (uint32_t node = 0; node < num_nodes; node++) if (index[node] == NONE) strongConnect(node);
+        };
+
+        // REQUIRES that solve() returned true
+        int valueOf(uint32_t x) const { return this->values[this->assigned[x]]; };
+
+        // REQUIRES that findComponents() was called
+        // whether some matching meeting the bounds matches variable x to the position-th value of its domain
+        bool supports(uint32_t x, uint32_t position) const
+        {
+            uint32_t v = value_ids[x][position];
+            return (v == assigned[x] || component[x] == component[num_vars + v]);
+        };
+
+    private:
+        uint32_t num_vars;
+        // every value of any domain or bound, sorted, numbered by position
+        vector<int> values;
+        vector<int> lower;
+        vector<int> upper;
+        // ids of the values each variable may take, in the order of its domain
+        vector<vector<uint32_t>> value_ids;
+        // value each variable is matched to, and number of variables matched to each value
+        vector<uint32_t> assigned;
+        vector<int> load;
+        vector<bool> visited;
+        // Tarjan's algorithm over variables, then values, then the sink at the end
+        vector<uint32_t> component;
+        vector<uint32_t> index;
+        vector<uint32_t> low_link;
+        vector<bool> on_stack;
+        vector<uint32_t> stack;
+        uint32_t next_index;
+        uint32_t next_component;
+
+        uint32_t valueId(int val) const
+        {
+            return (uint32_t) (std::lower_bound(values.begin(), values.end(), val) - values.begin());
+        };
+
+        void match(uint32_t x, uint32_t v)
+        {
+            if (assigned[x] != NONE) load[assigned[x]]--;
+            assigned[x] = v;
+            load[v]++;
+        };
+
+        // matches x to a value with room left under capacity, possibly moving other variables along the way
+        bool augment(uint32_t x, const vector<int>& capacity)
+        {
+            for (uint32_t v : value_ids[x])
+            {
+                if (!visited[v] && v != assigned[x] && load[v] < capacity[v])
+                {
+                    match(x, v);
+                    return true;
+                }
+            }
+            // every value of x is full: make room by moving a variable matched to one of them elsewhere
+            for (uint32_t v : value_ids[x])
+            {
+                if (visited[v] || v == assigned[x]) continue;
+                visited[v] = true;
+                for (uint32_t y = 0; y < num_vars; y++)
+                {
+                    if (y != x && assigned[y] == v && augment(y, capacity))
+                    {
+                        match(x, v);
+                        return true;
+                    }
+                }
+            }
+            return false;
+        };
+
+        // residual graph: a variable leads to the values it isn't matched to, a value to the variables 
+        // matched to it & to the sink if below its upper bound, the sink to values above their lower bound
+        template <typename Visit>
+        void forEachSuccessor(uint32_t node, Visit visit) const
+        {
+            uint32_t sink = num_vars + (uint32_t) values.size();
+            if (node < num_vars)
+            {
+                for (uint32_t v : value_ids[node]) if (v != assigned[node]) visit(num_vars + v);
+            }
+            else if (node < sink)
+            {
+                uint32_t v = node - num_vars;
+                for (uint32_t y = 0; y < num_vars; y++) if (assigned[y] == v) visit(y);
+                if (load[v] < upper[v]) visit(sink);
+            }
+            else
+            {
+                for (uint32_t v = 0; v < values.size(); v++) if (load[v] > lower[v]) visit(num_vars + v);
+            }
+        };
+
+        void strongConnect(uint32_t node)
+        {
+            index[node] = low_link[node] = next_index++;
+            stack.push_back(node);
+            on_stack[node] = true;
+            forEachSuccessor(node, [this, node](uint32_t next)
+            {
+                if (index[next] == NONE)
+                {
+                    strongConnect(next);
+                    low_link[node] = std::min(low_link[node], low_link[next]);
+                }
+                else if (on_stack[next]) low_link[node] = std::min(low_link[node], index[next]);
+            });
+            if (low_link[node] != index[node]) return;
+            uint32_t member;
+            do
+            {
+                member = stack.back();
+                stack.pop_back();
+                on_stack[member] = false;
+                component[member] = next_component;
+            } while (member != node);
+            next_component++;
+        };
+    };
+}
+
+GraphImplementation::ConstraintKernel::ConstraintKernel(KernelType type, int checked_value, int n)
+    : type(type), checked_value(checked_value), n(n)
+{
+
+};
+
+GraphImplementation::ConstraintKernel::~ConstraintKernel()
+{
+
+};
+
+// checks if given domains allow the existence of n or less of the checkedDomain value
+ConstraintKernel GraphImplementation::ConstraintKernel::lesserOrEqualToN(int checkedDomain, int n)
+{
+    return ConstraintKernel(LesserOrEqualToN, checkedDomain, n);
+};
+
+// checks if given domains allow the existence of n or more of the checkedDomain value
+ConstraintKernel GraphImplementation::ConstraintKernel::greaterOrEqualToN(int checkedDomain, int n)
+{
+    return ConstraintKernel(GreaterOrEqualToN, checkedDomain, n);
+};
+
+// checks if given domains allow the existence of exactly n of the checkedDomain value
+ConstraintKernel GraphImplementation::ConstraintKernel::exactlyN(int checkedDomain, int n)
+{
+    return ConstraintKernel(ExactlyN, checkedDomain, n);
+};
+
+// checks if given domains allow each value of bounds to be taken by between its min & max variables;
+// values without a bound may be taken by any number of variables
+// bounds given twice for the same value are intersected
+ConstraintKernel GraphImplementation::ConstraintKernel::globalCardinality(vector<CardinalityBound> bounds)
+{
+    std::sort(bounds.begin(), bounds.end(), 
+              [](const CardinalityBound& a, const CardinalityBound& b) { return a.value < b.value; });
+    ConstraintKernel kernel = ConstraintKernel(GlobalCardinality, 0, 0);
+    for (const CardinalityBound& bound : bounds)
+    {
+        if (!kernel.bounds.empty() && kernel.bounds.back().value == bound.value)
+        {
+            kernel.bounds.back().min = std::max(kernel.bounds.back().min, bound.min);
+            kernel.bounds.back().max = std::min(kernel.bounds.back().max, bound.max);
+        }
+        else kernel.bounds.push_back(bound);
+    }
+    return kernel;
+};
+
+// checks if given domains allow every variable to take a value no other variable takes
+ConstraintKernel GraphImplementation::ConstraintKernel::allDifferent()
+{
+    return ConstraintKernel(AllDifferent, 0, 0);
+};
+
+// for a kernel using a matching, finds the values of each variable of scope that some assignment
+// meeting the constraint gives it; unsupported[i] is then set to the other values of scope[i]
+// matching, if given, holds the value of each variable in an assignment found by an earlier call
+// on the same scope; the parts still valid are reused, and it is then set to the assignment found
+// returns false if no such assignment exists, leaving unsupported as is
+bool GraphImplementation::ConstraintKernel::matchingSupports(const vector<VariableVertex*>& scope, 
+                                                             vector<vector<int>>& unsupported,
+                                                             vector<int>* matching) const
+{
+    vector<vector<int>> domains(scope.size());
+    for (size_t x = 0; x < scope.size(); x++) 
+        domains[x].assign(scope[x]->getDomainStore().begin(), scope[x]->getDomainStore().end());
+    CardinalityMatching network = CardinalityMatching(domains, bounds, (type == AllDifferent) ? 1 : (int) scope.size());
+    if (!network.solve(matching)) return false;
+    network.findComponents();
+    if (matching != nullptr)
+    {
+        matching->resize(scope.size());
+        for (size_t x = 0; x < scope.size(); x++) (*matching)[x] = network.valueOf((uint32_t) x);
+    }
+
+    unsupported.resize(scope.size());
+    for (size_t x = 0; x < scope.size(); x++)
+    {
+        unsupported[x].clear();
+        for (uint32_t position = 0; position < domains[x].size(); position++)
+            if (!network.supports((uint32_t) x, position)) unsupported[x].push_back(domains[x][position]);
+    }
+    return true;
+};
+
+// ####################
+// PRIVATE FUNCTIONS
+// e.g. checked_value = werewolf, n = 3: returns false if there has to be more than 
+//      3 werewolves in the mix, true otherwise
+bool GraphImplementation::ConstraintKernel::lesserOrEqualToNIsMet(int mainVal, const vector<VariableVertex*>& varList) const
+{
+    // keep count of the number of variables which value has to be checked_value
+    int hasToBeCheckedDomain = 0;
+
+    // if mainVal is checked_value, increment hasToBeCheckedDomain
+    if (mainVal == checked_value) hasToBeCheckedDomain++;
+    
+    // otherwise, for every variable which domain is limited to checked_value, increment
+    for (VariableVertex* var : varList) {
+        const Domain& vDomain = var->getDomainStore();
+        // if domain size is 1 and checked_value is in domain, that variable has to be checked_value
+        if (vDomain.size() == 1 && vDomain.contains(checked_value))
+            hasToBeCheckedDomain++;
+        // if hastToBeCheckedDomain > n, there cannot n or less checked_value
+        if (hasToBeCheckedDomain > n) return false;
+    }
+    // if we've reached this point, the count is smaller or equal to n
+    return (hasToBeCheckedDomain <= n);
+};
+
+// e.g. checked_value = werewolf, n = 3: returns false if there has to be less than 
+//      3 werewolves in the mix, true otherwise
+bool GraphImplementation::ConstraintKernel::greaterOrEqualToNIsMet(int mainVal, const vector<VariableVertex*>& varList) const
+{
+    // keep count of the number of variables which value can be checked_value
+    int canBeCheckedDomain = 0;
+
+    // if mainVal is checked_value, increment canBeCheckedDomain
+    if (mainVal == checked_value) canBeCheckedDomain++;
+    
+    // otherwise, for every variable which domain includes checked_value, increment
+    for (VariableVertex* var : varList) {
+        // if checked_value is in vDomain, increment canBeCheckedDomain
+        if (var->domainContains(checked_value))
+            canBeCheckedDomain++;
+        // if canBeCheckedDomain >= n, we don't have to check further - return true
+        if (canBeCheckedDomain >= n) return true;
+    }
+    // if we've reached this point, the count is smaller than n, to which we return false
+    return (canBeCheckedDomain >= n);
+};
+
+bool GraphImplementation::ConstraintKernel::exactlyNIsMet(int mainVal, const vector<VariableVertex*>& varList) const
+{
+    // count both the number of variables which value 'can be' / 'have to be' checked_value.
+    int canBeCheckedDomain = 0;
+    int hasToBeCheckedDomain = 0;
+
+    // if mainVal is checked_value, increment both canBeCheckedDomain and hasToBeCheckedDomain
+    if (mainVal == checked_value) {
+        canBeCheckedDomain++;
+        hasToBeCheckedDomain++;
+    }
+
+    // otherwise: 
+    // - for every variable which domain includes checked_value, increment canBeCheckedDomain
+    // - for every variable which domain is limited to checked_value, increment hasToBeCheckedDomain
+    for (VariableVertex* var : varList) {
+        const Domain& vDomain = var->getDomainStore();
+        // includes checked_value
+        if (vDomain.contains(checked_value)) {
+            canBeCheckedDomain++;
+            // on top of that, also has domain limited to be checked_value
+            if (vDomain.size() == 1) hasToBeCheckedDomain++;
+        }
+
+        // after increment, if we have to have more than n of checked_value
+        // (= hasToBeCheckedDomain > n), we cannot have exactly N
+        if (hasToBeCheckedDomain > n) return false;
+    }
+    // finally return if we could have at least n checked_value
+    return (hasToBeCheckedDomain <= n && canBeCheckedDomain >= n);
+};
+
+// e.g. bounds 1..1 on each of 1, 2 & 3: returns false if mainVal & the variables of varList 
+//      can't take each of those values exactly once, e.g. when two of them can only be 1 or 2;
+//      an AllDifferent kernel bounds every value to at most once
+bool GraphImplementation::ConstraintKernel::matchingIsMet(int mainVal, const vector<VariableVertex*>& varList) const
+{
+    vector<vector<int>> domains(varList.size() + 1);
+    domains[0].push_back(mainVal);
+    for (size_t x = 0; x < varList.size(); x++) 
+        domains[x + 1].assign(varList[x]->getDomainStore().begin(), varList[x]->getDomainStore().end());
+    return CardinalityMatching(domains, bounds, (type == AllDifferent) ? 1 : (int) domains.size()).solve();
+};
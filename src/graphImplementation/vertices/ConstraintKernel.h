@@ -0,0 +1,108 @@
+// Author: Akira Kudo
+// Description: Implements the check run by a constraint vertex on the domains of its variables.
+//  The cardinality constraints we use the most (<= n, >= n, exactly n of a value) are kept 
+//  as plain data - which value is counted and n - and checked through a switch on their type, 
+//  so that no indirect call nor copy of the scope is needed. Any other predicate given by 
+//  the user is stored as a std::function and called as before.
+//  A global cardinality kernel bounds how many variables of the scope take each of several values
+//  at once, and an all different kernel has every variable of the scope take a distinct value;
+//  both are checked through a matching of variables to values, which also finds every value
+//  left without support in one go, catching pigeonhole deductions no single cardinality kernel sees.
+
+#ifndef GRAPHIMPLEMENTATION_VERTICES_CONSTRAINTKERNEL_H
+#define GRAPHIMPLEMENTATION_VERTICES_CONSTRAINTKERNEL_H
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "src/graphImplementation/vertices/VariableVertex.h"
+
+namespace GraphImplementation
+{
+    class ConstraintKernel
+    {
+    public:
+        enum KernelType { LesserOrEqualToN, GreaterOrEqualToN, ExactlyN, GlobalCardinality, AllDifferent, CustomPredicate };
+        using Predicate = std::function<bool(int, std::vector<VariableVertex*>)>;
+        // between min & max variables of the scope take value, in a GlobalCardinality kernel
+        struct CardinalityBound
+        {
+            int value;
+            int min;
+            int max;
+        };
+
+        // any callable taking (int, std::vector<VariableVertex*>) becomes a CustomPredicate kernel,
+        // so that user-defined predicates can be passed wherever a kernel is expected
+        template <typename Pred, 
+                  typename = std::enable_if_t<std::is_invocable_r_v<bool, Pred&, int, std::vector<VariableVertex*>>>>
+        ConstraintKernel(Pred pred) 
+            : type(CustomPredicate), checked_value(0), n(0), pred(std::move(pred)) {};
+        ~ConstraintKernel();
+
+        // checks if given domains allow the existence of n or less of the checkedDomain value
+        static ConstraintKernel lesserOrEqualToN(int checkedDomain, int n);
+        // checks if given domains allow the existence of n or more of the checkedDomain value
+        static ConstraintKernel greaterOrEqualToN(int checkedDomain, int n);
+        // checks if given domains allow the existence of exactly n of the checkedDomain value
+        static ConstraintKernel exactlyN(int checkedDomain, int n);
+        // checks if given domains allow each value of bounds to be taken by between its min & max variables;
+        // values without a bound may be taken by any number of variables
+        // bounds given twice for the same value are intersected
+        static ConstraintKernel globalCardinality(std::vector<CardinalityBound> bounds);
+        // checks if given domains allow every variable to take a value no other variable takes
+        static ConstraintKernel allDifferent();
+
+        // checks whether the constraint is met for mainVal given varList
+        bool isMet(int mainVal, const std::vector<VariableVertex*>& varList) const
+        {
+            switch (this->type)
+            {
+                case LesserOrEqualToN: return lesserOrEqualToNIsMet(mainVal, varList);
+                case GreaterOrEqualToN: return greaterOrEqualToNIsMet(mainVal, varList);
+                case ExactlyN: return exactlyNIsMet(mainVal, varList);
+                case GlobalCardinality: 
+                case AllDifferent: return matchingIsMet(mainVal, varList);
+                default: return this->pred(mainVal, varList);
+            }
+        };
+
+        // getters
+        KernelType getType() const { return this->type; };
+        // the counted value & n of cardinality kernels; both are 0 for a CustomPredicate
+        int getCheckedValue() const { return this->checked_value; };
+        int getN() const { return this->n; };
+        // the bounds of a GlobalCardinality kernel sorted by value, empty for any other kernel
+        const std::vector<CardinalityBound>& getBounds() const { return this->bounds; };
+        // whether this kernel is checked through a matching, see matchingSupports
+        bool usesMatching() const { return (this->type == GlobalCardinality || this->type == AllDifferent); };
+
+        // for a kernel using a matching, finds the values of each variable of scope that some assignment
+        // meeting the constraint gives it; unsupported[i] is then set to the other values of scope[i]
+        // matching, if given, holds the value of each variable in an assignment found by an earlier call
+        // on the same scope; the parts still valid are reused, and it is then set to the assignment found
+        // returns false if no such assignment exists, leaving unsupported as is
+        bool matchingSupports(const std::vector<VariableVertex*>& scope, std::vector<std::vector<int>>& unsupported,
+                              std::vector<int>* matching=nullptr) const;
+
+    private:
+        KernelType type;
+        int checked_value;
+        int n;
+        // only set for a CustomPredicate
+        Predicate pred;
+        // only set for a GlobalCardinality kernel, sorted by value
+        std::vector<CardinalityBound> bounds;
+
+        ConstraintKernel(KernelType type, int checked_value, int n);
+
+        bool lesserOrEqualToNIsMet(int mainVal, const std::vector<VariableVertex*>& varList) const;
+        bool greaterOrEqualToNIsMet(int mainVal, const std::vector<VariableVertex*>& varList) const;
+        bool exactlyNIsMet(int mainVal, const std::vector<VariableVertex*>& varList) const;
+        bool matchingIsMet(int mainVal, const std::vector<VariableVertex*>& varList) const;
+    };
+}
+
+#endif
@@ -10,6 +10,7 @@
 #include <string>
 #include <vector>
 
+#include "src/graphImplementation/vertices/ConstraintKernel.h"
 #include "src/graphImplementation/vertices/VariableVertex.h"
 #include "src/graphImplementation/vertices/Vertex.h"
 
@@ -18,7 +19,8 @@ namespace GraphImplementation
     class ConstraintVertex : public Vertex
     {
         private:
-            std::function<bool(int, std::vector<VariableVertex*>)> pred;
+            // the check run on domains; cardinality constraints are dispatched without type erasure
+            ConstraintKernel kernel;
             std::string name;
             // description aims to make printing of ConstraintVertex clearer;
             // instead of us taking pred apart, we expect you to specify info of what
@@ -26,23 +28,32 @@ namespace GraphImplementation
             std::string description;
 
         public:
+            // kernel is either one of the cardinality kernels below, or any predicate
+            // callable as bool(int, std::vector<VariableVertex*>)
             ConstraintVertex(std::string, 
-                             std::function<bool(int, std::vector<VariableVertex*>)> pred,
+                             ConstraintKernel kernel,
                              std::string description="This is the default description.");
             ~ConstraintVertex();
             // checks whether the constraint is met for mainVar given varList.
-            bool constraintIsMet(int mainVal, std::vector<VariableVertex*> varList) const;
+            bool constraintIsMet(int mainVal, const std::vector<VariableVertex*>& varList) const
+            { return this->kernel.isMet(mainVal, varList); };
 
             // getters
             using Vertex::getName;
+            const ConstraintKernel& getKernel() const { return this->kernel; };
+            const std::string& getDescription() const { return this->description; };
         
             // Example predicates that can be useful:
             // checks if given domains allow the existence of n or less of the checkedDomain value
-            static std::function<bool(int, std::vector<VariableVertex*>)> lesserOrEqualToN(int checkedDomain, int n);
+            static ConstraintKernel lesserOrEqualToN(int checkedDomain, int n);
             // checks if given domains allow the existence of n or more of the checkedDomain value
-            static std::function<bool(int, std::vector<VariableVertex*>)> greaterOrEqualToN(int checkedDomain, int n);
+            static ConstraintKernel greaterOrEqualToN(int checkedDomain, int n);
             // checks if given domains allow the existence of exactly n of the checkedDomain value
-            static std::function<bool(int, std::vector<VariableVertex*>)> exactlyN(int checkedDomain, int n);
+            static ConstraintKernel exactlyN(int checkedDomain, int n);
+            // checks if given domains allow each value of bounds to be taken by between its min & max variables
+            static ConstraintKernel globalCardinality(std::vector<ConstraintKernel::CardinalityBound> bounds);
+            // checks if given domains allow every variable to take a value no other variable takes
+            static ConstraintKernel allDifferent();
 
             // overwrite << operator
             friend std::ostream& operator<<(std::ostream& os, const ConstraintVertex& cv) {
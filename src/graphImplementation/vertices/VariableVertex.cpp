@@ -3,15 +3,22 @@
 #include <initializer_list>
 #include <string>
 #include <set>
+#include <utility>
 
 #include "src/graphImplementation/vertices/VariableVertex.h"
 
-GraphImplementation::VariableVertex::VariableVertex(std::string name, std::initializer_list<int> initialDomain) 
-    : Vertex(name), domain(std::set<int>(initialDomain)) 
+GraphImplementation::VariableVertex::VariableVertex(
+    std::string name, std::initializer_list<int> initialDomain, Domain::DomainMode mode) 
+    : Vertex(name), domain(Domain(initialDomain, mode)) 
 {};
 
-GraphImplementation::VariableVertex::VariableVertex(std::string name, std::set<int> initialDomain) 
-    : Vertex(name), domain(initialDomain) 
+GraphImplementation::VariableVertex::VariableVertex(
+    std::string name, std::set<int> initialDomain, Domain::DomainMode mode) 
+    : Vertex(name), domain(Domain(initialDomain, mode)) 
+{};
+
+GraphImplementation::VariableVertex::VariableVertex(std::string name, Domain initialDomain) 
+    : Vertex(name), domain(std::move(initialDomain)) 
 {};
 
 GraphImplementation::VariableVertex::~VariableVertex()
@@ -33,8 +40,8 @@ void GraphImplementation::VariableVertex::addToDomain(std::initializer_list<int>
 }
 
 // removes a value from this vertex's domain
-void GraphImplementation::VariableVertex::removeFromDomain(int val) {
-    this->domain.erase(val);
+bool GraphImplementation::VariableVertex::removeFromDomain(int val) {
+    return this->domain.erase(val);
 }
 
 void GraphImplementation::VariableVertex::removeFromDomain(std::set<int> values) {
@@ -43,4 +50,9 @@ void GraphImplementation::VariableVertex::removeFromDomain(std::set<int> values)
 
 void GraphImplementation::VariableVertex::removeFromDomain(std::initializer_list<int> values) {
     for (int val : values) this->domain.erase(val);
+}
+
+// removes every value but val from this vertex's domain
+bool GraphImplementation::VariableVertex::restrictDomainTo(int val) {
+    return this->domain.keepOnly(val);
 }
\ No newline at end of file
@@ -10,6 +10,7 @@
 #include <set>
 #include <string>
 
+#include "src/graphImplementation/domains/Domain.h"
 #include "src/graphImplementation/vertices/Vertex.h"
 
 namespace GraphImplementation
@@ -22,11 +23,14 @@ namespace GraphImplementation
         std::string name;
         // Domains of vertex: are integers, combined accordingly with
         // enumerations which are specific to a problem we are solving.
-        std::set<int> domain;
+        Domain domain;
 
     public:
-        VariableVertex(std::string name, std::initializer_list<int> initialDomain);
-        VariableVertex(std::string name, std::set<int> initialDomain);
+        VariableVertex(std::string name, std::initializer_list<int> initialDomain, 
+                       Domain::DomainMode mode=Domain::BitsetMode);
+        VariableVertex(std::string name, std::set<int> initialDomain,
+                       Domain::DomainMode mode=Domain::BitsetMode);
+        VariableVertex(std::string name, Domain initialDomain);
         ~VariableVertex();
         
         // Adds the value to the domain of the vertex, if not there already.
@@ -34,13 +38,21 @@ namespace GraphImplementation
         void addToDomain(std::initializer_list<int> values);
         void addToDomain(std::set<int> values);
         // Removes the value from the domain of the vertex, if there already.
-        void removeFromDomain(int val);
+        // The single value version returns whether the value was there.
+        bool removeFromDomain(int val);
         void removeFromDomain(std::initializer_list<int> values);
         void removeFromDomain(std::set<int> values);
+        // Removes every value but val from the domain; returns whether the domain changed.
+        bool restrictDomainTo(int val);
 
         // getters
         using Vertex::getName;
-        std::set<int> getDomain() const { return this->domain; };
+        // returns a copy of the domain as a set; prefer the getters below in hot paths
+        std::set<int> getDomain() const { return this->domain.toSet(); };
+        // returns the domain store itself without copying it
+        const Domain& getDomainStore() const { return this->domain; };
+        size_t getDomainSize() const { return this->domain.size(); };
+        bool domainContains(int val) const { return this->domain.contains(val); };
 
         // overloading == so that we can use those in Boost tests
         bool operator==(const VariableVertex& other) const
@@ -48,14 +60,7 @@ namespace GraphImplementation
             if (!this->Vertex::operator==(other)) return false;
             // otherwise, elementwise check if we have the same domain
             for (auto elem : this->domain) {
-                bool was_found_in_other = false;
-                for (auto elem_other : other.getDomain()) {
-                    if (elem == elem_other) {
-                        was_found_in_other = true;
-                        break;
-                    }
-                }
-                if (!was_found_in_other) return false;
+                if (!other.domainContains(elem)) return false;
             }
             return true;
         }
@@ -66,14 +71,7 @@ namespace GraphImplementation
             if (this->Vertex::operator!=(other)) return true;
             // otherwise, elementwise check if we have the same domain
             for (auto elem : this->domain) {
-                bool was_found_in_other = false;
-                for (auto elem_other : other.getDomain()) {
-                    if (elem == elem_other) {
-                        was_found_in_other = true;
-                        break;
-                    }
-                }
-                if (!was_found_in_other) return true;
+                if (!other.domainContains(elem)) return true;
             }
             return false;
         }
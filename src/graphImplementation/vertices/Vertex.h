@@ -8,6 +8,7 @@
 #ifndef GRAPHIMPLEMENTATION_VERTICES_VERTEX_H
 #define GRAPHIMPLEMENTATION_VERTICES_VERTEX_H
 
+#include <cstdint>
 #include <iostream>
 #include <string>
 
@@ -17,10 +18,19 @@ namespace GraphImplementation
     {
     protected:
         std::string name;
+        // dense index given by the graph holding this vertex, if it numbers its vertices
+        uint32_t id;
     public:
-        Vertex(std::string name) : name(name) {};
+        // id of a vertex that wasn't numbered by any graph
+        static const uint32_t NO_ID = UINT32_MAX;
+
+        Vertex(std::string name) : name(name), id(NO_ID) {};
         virtual ~Vertex() = 0; // declare pure virtual destructor
         std::string getName() const { return this->name; };
+        const std::string& getNameReference() const { return this->name; };
+        uint32_t getId() const { return this->id; };
+        // only meant to be called by the graph numbering this vertex
+        void setId(uint32_t id) { this->id = id; };
 
         // overloading ==
         bool operator==(const Vertex& other) const
@@ -0,0 +1,103 @@
+// Author: Akira Kudo
+// Description: Implements tests for the TranspositionCache class under CSPSolverImplementation.
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <vector>
+
+#include "src/cspSolver/cache/TranspositionCache.h"
+
+using CSPSolverImplementation::TranspositionCache;
+
+// define fixture
+struct TestTranspositionCache_Fixture
+{
+    TranspositionCache cache;
+    // three states of one graph, the answers below each being counted
+    TranspositionCache::Key first = { 7, 1, 11, true }, second = { 7, 2, 12, true }, third = { 7, 3, 13, true };
+
+    TestTranspositionCache_Fixture() : cache(TranspositionCache(2)) {};
+    ~TestTranspositionCache_Fixture() {};
+};
+
+BOOST_FIXTURE_TEST_SUITE(TranspositionCache_test_suite, TestTranspositionCache_Fixture, * boost::unit_test::label("TranspositionCache"));
+
+    // the result kept for key, which becomes the state used most recently, or nullptr if there is none
+    // std::shared_ptr<const Result> find(const Key& key);
+    BOOST_AUTO_TEST_SUITE(find);
+
+        BOOST_AUTO_TEST_CASE(finds_kept_results_and_counts_hits_and_misses) {
+            // setup: keep two answers of two variables for the first state
+            cache.insert(first, TranspositionCache::Result { 2, { 1, 2, 2, 1 } });
+
+            // test: only the very same key finds them, the key being told apart by whether it counts
+            std::shared_ptr<const TranspositionCache::Result> found = cache.find(first);
+            BOOST_REQUIRE(found != nullptr);
+            BOOST_CHECK_EQUAL(found->solution_count, 2);
+            BOOST_TEST(found->values == std::vector<int>({ 1, 2, 2, 1 }));
+            BOOST_TEST((cache.find(second) == nullptr));
+            BOOST_TEST((cache.find(TranspositionCache::Key { 7, 1, 11, false }) == nullptr));
+            BOOST_CHECK_EQUAL(cache.getHitCount(), 1);
+            BOOST_CHECK_EQUAL(cache.getMissCount(), 2);
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+    // keeps result for key, forgetting the state used least recently if capacity states are kept already
+    // void insert(const Key& key, Result result);
+    BOOST_AUTO_TEST_SUITE(insert);
+
+        BOOST_AUTO_TEST_CASE(forgets_the_state_used_least_recently) {
+            // setup: keep the first two states, then use the first one again
+            cache.insert(first, TranspositionCache::Result { 1, {} });
+            cache.insert(second, TranspositionCache::Result { 2, {} });
+            cache.find(first);
+            cache.insert(third, TranspositionCache::Result { 3, {} });
+
+            // test: the second state was forgotten to make room for the third
+            BOOST_CHECK_EQUAL(cache.size(), 2);
+            BOOST_CHECK_EQUAL(cache.getEvictionCount(), 1);
+            BOOST_TEST((cache.find(first) != nullptr));
+            BOOST_TEST((cache.find(second) == nullptr));
+            BOOST_TEST((cache.find(third) != nullptr));
+        }
+
+        BOOST_AUTO_TEST_CASE(keeps_nothing_without_capacity) {
+            // setup: remove the capacity of the cache
+            cache.setCapacity(0);
+            cache.insert(first, TranspositionCache::Result { 1, {} });
+
+            // test: nothing is kept nor forgotten
+            BOOST_CHECK_EQUAL(cache.size(), 0);
+            BOOST_CHECK_EQUAL(cache.getEvictionCount(), 0);
+            BOOST_TEST((cache.find(first) == nullptr));
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+    // maximum number of states kept; lowering it forgets the states used least recently
+    // void setCapacity(size_t capacity);
+    BOOST_AUTO_TEST_SUITE(setCapacity);
+
+        BOOST_AUTO_TEST_CASE(lowering_the_capacity_forgets_and_clearing_resets) {
+            // setup: keep two states, then lower the capacity to one
+            cache.insert(first, TranspositionCache::Result { 1, {} });
+            cache.insert(second, TranspositionCache::Result { 2, {} });
+            cache.setCapacity(1);
+
+            // test: the first state, used least recently, was forgotten
+            BOOST_CHECK_EQUAL(cache.size(), 1);
+            BOOST_CHECK_EQUAL(cache.getEvictionCount(), 1);
+            BOOST_TEST((cache.find(second) != nullptr));
+            // clearing forgets the rest & resets every counter
+            cache.clear();
+            BOOST_CHECK_EQUAL(cache.size(), 0);
+            BOOST_CHECK_EQUAL(cache.getHitCount(), 0);
+            BOOST_CHECK_EQUAL(cache.getEvictionCount(), 0);
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE_END();
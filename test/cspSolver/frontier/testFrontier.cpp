@@ -260,6 +260,123 @@ BOOST_FIXTURE_TEST_SUITE(Frontier_test_suite, TestFrontier_Fixture, * boost::uni
 
     BOOST_AUTO_TEST_SUITE_END();
 
+    // non-unary arcs are ordered by an ArcHeuristic, or a custom comparator
+    // Frontier(FrontierMode mode, ArcHeuristic heuristic); Frontier(ArcComparator comparator);
+    BOOST_AUTO_TEST_SUITE(PriorityQueueMode);
+
+        BOOST_AUTO_TEST_CASE(smallest_domain_first) {
+            // setup: shrink the main variable of non_unary2, then push both non-unary arcs
+            vv4.removeFromDomain(40);
+            vv4.removeFromDomain(41);
+            CSPSolverImplementation::Frontier f = CSPSolverImplementation::Frontier(
+                CSPSolverImplementation::Frontier::PriorityQueueMode, CSPSolverImplementation::Frontier::SmallestDomainFirst);
+            f.push(non_unary1);
+            f.push(non_unary2);
+            f.push(unary1);
+
+            // test: unary arcs still come first, then the smallest domain
+            BOOST_REQUIRE_EQUAL(f.size(), 3);
+            BOOST_CHECK_EQUAL(f.pop(), unary1);
+            BOOST_CHECK_EQUAL(f.pop(), non_unary2);
+            BOOST_CHECK_EQUAL(f.pop(), non_unary1);
+        };
+
+        BOOST_AUTO_TEST_CASE(lowest_arity_first) {
+            // setup: create an arc over more variables, pushed first
+            CSPSolverImplementation::ARC wide = non_unary1;
+            wide.other_var_list.push_back(&vv4);
+            CSPSolverImplementation::Frontier f = CSPSolverImplementation::Frontier(
+                CSPSolverImplementation::Frontier::PriorityQueueMode, CSPSolverImplementation::Frontier::LowestArityFirst);
+            f.push(wide);
+            f.push(non_unary2);
+
+            // test: the arc over fewer variables comes first
+            BOOST_CHECK_EQUAL(f.pop(), non_unary2);
+            BOOST_CHECK_EQUAL(f.pop().other_var_list.size(), 3);
+        };
+
+        BOOST_AUTO_TEST_CASE(most_recently_tightened_first_with_repush) {
+            // setup: push three arcs with ids, then push the first one again
+            unary1.arc_id = 0; 
+            non_unary1.arc_id = 1; 
+            non_unary2.arc_id = 2;
+            CSPSolverImplementation::ARC third = non_unary1;
+            third.main_var = &vv2; third.arc_id = 3;
+            CSPSolverImplementation::Frontier f = CSPSolverImplementation::Frontier(
+                CSPSolverImplementation::Frontier::PriorityQueueMode, CSPSolverImplementation::Frontier::MostRecentlyTightenedFirst);
+            f.push(non_unary1);
+            f.push(non_unary2);
+            f.push(third);
+            f.push(non_unary1);
+
+            // test: the re-pushed arc moves to the top without being duplicated
+            BOOST_REQUIRE_EQUAL(f.size(), 3);
+            BOOST_CHECK_EQUAL(f.pop(), non_unary1);
+            BOOST_CHECK_EQUAL(f.pop(), third);
+            BOOST_CHECK_EQUAL(f.pop(), non_unary2);
+            BOOST_TEST(f.empty());
+        };
+
+        BOOST_AUTO_TEST_CASE(custom_comparator) {
+            // setup: order arcs by the name of their constraint, in reverse
+            CSPSolverImplementation::Frontier f = CSPSolverImplementation::Frontier(
+                [] (const CSPSolverImplementation::ARC& arc1, const CSPSolverImplementation::ARC& arc2)
+                {
+                    return arc1.constraint->getName() > arc2.constraint->getName();
+                });
+            f.push(non_unary1);
+            f.push(non_unary2);
+
+            // test: check the comparator decided the order
+            BOOST_CHECK_EQUAL(f.getMode(), CSPSolverImplementation::Frontier::PriorityQueueMode);
+            BOOST_CHECK_EQUAL(f.getHeuristic(), CSPSolverImplementation::Frontier::CustomHeuristic);
+            BOOST_CHECK_EQUAL(f.pop(), non_unary2);
+            BOOST_CHECK_EQUAL(f.pop(), non_unary1);
+        };
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+    // returns whether the arc with given id is currently in the frontier - O(1)
+    // bool contains(uint32_t arc_id) const;
+    BOOST_AUTO_TEST_SUITE(contains);
+
+        BOOST_AUTO_TEST_CASE(arcs_with_id_are_tracked_by_id) {
+            // setup: give ids to two arcs and push them
+            unary1.arc_id = 3;
+            non_unary1.arc_id = 7;
+            frontier.push(unary1);
+            frontier.push(non_unary1);
+
+            // test: check pushed ids are in the frontier, others aren't
+            BOOST_TEST(frontier.contains(3));
+            BOOST_TEST(frontier.contains(7));
+            BOOST_TEST(!frontier.contains(0));
+            BOOST_TEST(!frontier.contains(100));
+            // pushing an arc with the same id again doesn't duplicate it
+            frontier.push(unary1);
+            BOOST_CHECK_EQUAL(frontier.size(), 2);
+            // popping clears the flag so that the arc can be pushed back
+            BOOST_CHECK_EQUAL(frontier.pop(), unary1);
+            BOOST_TEST(!frontier.contains(3));
+            frontier.push(unary1);
+            BOOST_TEST(frontier.contains(3));
+            BOOST_CHECK_EQUAL(frontier.size(), 2);
+        };
+
+        BOOST_AUTO_TEST_CASE(arcs_without_id_are_not_found_by_id) {
+            // setup: push arcs without ids
+            frontier.push(unary1);
+            frontier.push(non_unary1);
+
+            // test: no id is reported as in frontier, while dedup still works by name
+            BOOST_TEST(!frontier.contains(0));
+            BOOST_TEST(!frontier.contains(CSPSolverImplementation::ARC::NO_ARC_ID));
+            frontier.push(unary1);
+            BOOST_CHECK_EQUAL(frontier.size(), 2);
+        };
+
+    BOOST_AUTO_TEST_SUITE_END();
+
     // int size()
     BOOST_AUTO_TEST_SUITE(size);
         
@@ -0,0 +1,193 @@
+// Author: Akira Kudo
+// Description: Implements tests for the CSPGraphSerializer class in CSPSolver.
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "src/cspSolver/CSPGraph.h"
+#include "src/cspSolver/io/CSPGraphSerializer.h"
+#include "src/graphImplementation/vertices/ConstraintKernel.h"
+#include "src/graphImplementation/vertices/ConstraintVertex.h"
+#include "src/graphImplementation/vertices/VariableVertex.h"
+
+using CSPSolverImplementation::CSPGraph, CSPSolverImplementation::CSPGraphSerializer, CSPSolverImplementation::IdSpan;
+using GraphImplementation::ConstraintKernel, GraphImplementation::ConstraintVertex, GraphImplementation::VariableVertex;
+
+// fixture class for testCSPGraphSerializer
+struct TestCSPGraphSerializer_Fixture
+{
+    CSPGraph cspg;
+    std::string path;
+
+    // setup
+    TestCSPGraphSerializer_Fixture()
+    {
+        path = (std::filesystem::temp_directory_path() / "testCSPGraphSerializer.gcsp").string();
+        // three variables sharing two constraints, added in a non-alphabetical order
+        cspg.add_variable("C", {1, 2, 3});
+        cspg.add_variable("A", {-4, 2, 100});
+        cspg.add_variable("B", {2});
+        cspg.add_constraint("OnlyOne2", ConstraintVertex::exactlyN(2, 1), "We can have only one 2.");
+        cspg.add_constraint("AtLeastOne1", ConstraintVertex::greaterOrEqualToN(1, 1));
+        cspg.add_constraint("AtMostTwo3", ConstraintVertex::lesserOrEqualToN(3, 2));
+        for (std::string vv_name : {"B", "A", "C"}) cspg.add_edge(vv_name, "OnlyOne2");
+        cspg.add_edge("C", "AtLeastOne1");
+        cspg.add_edge("A", "AtMostTwo3");
+        cspg.add_edge("C", "AtMostTwo3");
+    };
+
+    // teardown
+    ~TestCSPGraphSerializer_Fixture() 
+    {
+        std::remove(path.c_str());
+    };
+};
+
+BOOST_FIXTURE_TEST_SUITE(CSPGraphSerializer_test_suite, TestCSPGraphSerializer_Fixture, 
+                         * boost::unit_test::label("CSPGraphSerializer"));
+
+    // writes graph to the file at save_path / reads the graph saved at load_path into graph
+    // static bool save(const CSPGraph& graph, const std::string& save_path);
+    // static bool load(const std::string& load_path, CSPGraph& graph);
+    BOOST_AUTO_TEST_SUITE(save_and_load);
+
+        BOOST_AUTO_TEST_CASE(round_trip_keeps_everything) {
+            // setup: save then load the graph
+            BOOST_REQUIRE(CSPGraphSerializer::save(cspg, path));
+            CSPGraph loaded;
+            BOOST_REQUIRE(CSPGraphSerializer::load(path, loaded));
+
+            // test: the loaded graph is frozen, with the same ids, domains, constraints & adjacency
+            cspg.freeze();
+            BOOST_REQUIRE(loaded.is_frozen());
+            BOOST_REQUIRE_EQUAL(loaded.num_variables(), cspg.num_variables());
+            BOOST_REQUIRE_EQUAL(loaded.num_constraints(), cspg.num_constraints());
+            BOOST_REQUIRE_EQUAL(loaded.num_arcs(), cspg.num_arcs());
+            for (uint32_t vv_id = 0; vv_id < cspg.num_variables(); vv_id++)
+            {
+                BOOST_CHECK_EQUAL(*loaded.variable_at(vv_id), *cspg.variable_at(vv_id));
+                BOOST_CHECK_EQUAL(loaded.variable_at(vv_id)->getDomainSize(), cspg.variable_at(vv_id)->getDomainSize());
+                IdSpan expected = cspg.constraint_neighbor_ids(vv_id), actual = loaded.constraint_neighbor_ids(vv_id);
+                BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), actual.begin(), actual.end());
+            }
+            for (uint32_t cv_id = 0; cv_id < cspg.num_constraints(); cv_id++)
+            {
+                const ConstraintVertex* expected_cv = cspg.constraint_at(cv_id);
+                const ConstraintVertex* actual_cv = loaded.constraint_at(cv_id);
+                BOOST_CHECK_EQUAL(actual_cv->getName(), expected_cv->getName());
+                BOOST_CHECK_EQUAL(actual_cv->getDescription(), expected_cv->getDescription());
+                BOOST_CHECK_EQUAL(actual_cv->getKernel().getType(), expected_cv->getKernel().getType());
+                BOOST_CHECK_EQUAL(actual_cv->getKernel().getCheckedValue(), expected_cv->getKernel().getCheckedValue());
+                BOOST_CHECK_EQUAL(actual_cv->getKernel().getN(), expected_cv->getKernel().getN());
+                IdSpan expected = cspg.variable_neighbor_ids(cv_id), actual = loaded.variable_neighbor_ids(cv_id);
+                BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), actual.begin(), actual.end());
+            }
+            // name-based functions still work on the loaded graph
+            std::vector<std::string> expected_names {"C", "A", "B"};
+            std::vector<std::string> actual_names = loaded.get_all_variable_names();
+            BOOST_CHECK_EQUAL_COLLECTIONS(expected_names.begin(), expected_names.end(), actual_names.begin(), actual_names.end());
+            BOOST_TEST(loaded.adjacent("A", "AtMostTwo3"));
+            BOOST_TEST(!loaded.adjacent("B", "AtMostTwo3"));
+            BOOST_CHECK_EQUAL(loaded.get_variable_neighbors("OnlyOne2").size(), 3);
+        }
+
+        BOOST_AUTO_TEST_CASE(custom_predicate_is_not_saved) {
+            // setup: add a constraint holding a lambda
+            cspg.add_constraint("Custom", [] (int val, std::vector<VariableVertex*> others) { return true; });
+
+            // test: saving fails without writing any file
+            BOOST_TEST(!CSPGraphSerializer::save(cspg, path));
+            BOOST_TEST(!std::filesystem::exists(path));
+        }
+
+        BOOST_AUTO_TEST_CASE(global_cardinality_is_not_saved) {
+            // setup: add a global cardinality constraint
+            cspg.add_constraint("Fused", ConstraintVertex::globalCardinality({ {1, 1, 1}, {2, 0, 1} }));
+
+            // test: saving fails without writing any file
+            BOOST_TEST(!CSPGraphSerializer::save(cspg, path));
+            BOOST_TEST(!std::filesystem::exists(path));
+        }
+
+        BOOST_AUTO_TEST_CASE(all_different_is_saved) {
+            // setup: add an alldifferent constraint over A & C, then save & load the graph
+            cspg.add_constraint("AllDifferent", ConstraintVertex::allDifferent());
+            cspg.add_edge("A", "AllDifferent");
+            cspg.add_edge("C", "AllDifferent");
+            BOOST_REQUIRE(CSPGraphSerializer::save(cspg, path));
+            CSPGraph loaded;
+            BOOST_REQUIRE(CSPGraphSerializer::load(path, loaded));
+
+            // test: the constraint comes back with its kernel & scope
+            BOOST_CHECK_EQUAL(loaded.get_constraint("AllDifferent")->getKernel().getType(), ConstraintKernel::AllDifferent);
+            BOOST_TEST(loaded.adjacent("A", "AllDifferent"));
+            BOOST_TEST(loaded.adjacent("C", "AllDifferent"));
+            BOOST_CHECK_EQUAL(loaded.get_variable_neighbors("AllDifferent").size(), 2);
+        }
+
+        BOOST_AUTO_TEST_CASE(missing_or_malformed_file_is_not_loaded) {
+            // setup: a graph to be left untouched
+            CSPGraph untouched;
+            untouched.add_variable("X", {1});
+
+            // test: a missing file isn't loaded
+            BOOST_TEST(!CSPGraphSerializer::load(path, untouched));
+            // neither is a truncated one
+            BOOST_REQUIRE(CSPGraphSerializer::save(cspg, path));
+            std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+            BOOST_TEST(!CSPGraphSerializer::load(path, untouched));
+            // nor a file that isn't ours
+            std::ofstream(path, std::ios::trunc) << "definitely not a graph, but long enough for a header";
+            BOOST_TEST(!CSPGraphSerializer::load(path, untouched));
+            BOOST_CHECK_EQUAL(untouched.get_all_variable_names().size(), 1);
+        }
+
+        BOOST_AUTO_TEST_CASE(adjacency_halves_not_mirroring_each_other_are_not_loaded) {
+            // setup: the saved bytes, and where the constraint ids of each variable start
+            BOOST_REQUIRE(CSPGraphSerializer::save(cspg, path));
+            std::string bytes(std::filesystem::file_size(path), '\0');
+            std::ifstream(path, std::ios::binary).read(bytes.data(), bytes.size());
+            auto word_at = [&bytes] (size_t index)
+            {
+                uint32_t word;
+                std::memcpy(&word, bytes.data() + index * sizeof(uint32_t), sizeof(uint32_t));
+                return word;
+            };
+            uint32_t nv = word_at(3), nc = word_at(4), num_domain_values = word_at(6);
+            size_t var_constraint_ids = 8 + (nv + 2 * nc + 1) + (nv + 1) + num_domain_values + 3 * nc + (nv + 1);
+            // writes the saved bytes into the file, with the word at index changed to value
+            auto save_with = [this, &bytes] (size_t index, uint32_t value)
+            {
+                std::string changed = bytes;
+                std::memcpy(changed.data() + index * sizeof(uint32_t), &value, sizeof(uint32_t));
+                std::ofstream(path, std::ios::binary | std::ios::trunc) << changed;
+            };
+            CSPGraph untouched;
+            untouched.add_variable("X", {1});
+
+            // test: C, A & B list [OnlyOne2 AtLeastOne1 AtMostTwo3], [OnlyOne2 AtMostTwo3] & [OnlyOne2]
+            BOOST_REQUIRE_EQUAL(word_at(var_constraint_ids + 5), 0);
+            // B listing AtLeastOne1 instead, whose scope doesn't hold B, isn't loaded
+            save_with(var_constraint_ids + 5, 1);
+            BOOST_TEST(!CSPGraphSerializer::load(path, untouched));
+            // neither is C listing OnlyOne2 twice
+            save_with(var_constraint_ids + 1, 0);
+            BOOST_TEST(!CSPGraphSerializer::load(path, untouched));
+            BOOST_CHECK_EQUAL(untouched.get_all_variable_names().size(), 1);
+            // while the file as saved is
+            save_with(var_constraint_ids + 5, 0);
+            BOOST_TEST(CSPGraphSerializer::load(path, untouched));
+            BOOST_CHECK_EQUAL(untouched.get_all_variable_names().size(), 3);
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE_END();
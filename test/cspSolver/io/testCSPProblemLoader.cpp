@@ -0,0 +1,163 @@
+// Author: Akira Kudo
+// Description: Implements tests for the CSPProblemLoader class in CSPSolver.
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+#include "src/cspSolver/CSPGraph.h"
+#include "src/cspSolver/CSPSolver.h"
+#include "src/cspSolver/io/CSPProblemLoader.h"
+#include "src/graphImplementation/vertices/ConstraintKernel.h"
+#include "src/graphImplementation/vertices/VariableVertex.h"
+
+using CSPSolverImplementation::CSPGraph, CSPSolverImplementation::CSPProblemLoader, CSPSolverImplementation::CSPSolver;
+using GraphImplementation::ConstraintKernel, GraphImplementation::VariableVertex;
+
+BOOST_AUTO_TEST_SUITE(CSPProblemLoader_test_suite, * boost::unit_test::label("CSPProblemLoader"));
+
+    // builds graph from the problem given as text
+    // static bool parse(std::string_view text, CSPGraph& graph, std::string* error=nullptr);
+    BOOST_AUTO_TEST_SUITE(parse);
+
+        BOOST_AUTO_TEST_CASE(every_statement) {
+            // setup: a permutation of 1, 2, 3 with B fixed to 1, using every statement
+            std::string text = 
+                "# permutations of 1..3\n"
+                "csp 3 4\n"
+                "vars 1..3 : A C\n"
+                "var B 1\n"
+                "family OnlyOne{} exactly 1..2 1 : A B C\n"
+                "con OnlyOne3 = 3 1 : A B\n"
+                "edge C OnlyOne3   # trailing comment\n"
+                "con AtMostTwo2 atmost 2 2\n"
+                "\n";
+            CSPGraph graph;
+            std::string error;
+            BOOST_REQUIRE_MESSAGE(CSPProblemLoader::parse(text, graph, &error), error);
+
+            // test: variables, constraints & edges are all there, in order
+            std::vector<std::string> expected_vv {"A", "C", "B"};
+            std::vector<std::string> actual_vv = graph.get_all_variable_names();
+            BOOST_CHECK_EQUAL_COLLECTIONS(expected_vv.begin(), expected_vv.end(), actual_vv.begin(), actual_vv.end());
+            std::vector<std::string> expected_cv {"OnlyOne1", "OnlyOne2", "OnlyOne3", "AtMostTwo2"};
+            std::vector<std::string> actual_cv = graph.get_all_constraint_names();
+            BOOST_CHECK_EQUAL_COLLECTIONS(expected_cv.begin(), expected_cv.end(), actual_cv.begin(), actual_cv.end());
+            BOOST_CHECK_EQUAL(*graph.get_variable("B"), VariableVertex("B", {1}));
+            BOOST_CHECK_EQUAL(graph.get_variable("A")->getDomainSize(), 3);
+            BOOST_CHECK_EQUAL(graph.get_constraint("OnlyOne2")->getKernel().getType(), ConstraintKernel::ExactlyN);
+            BOOST_CHECK_EQUAL(graph.get_constraint("OnlyOne2")->getKernel().getCheckedValue(), 2);
+            BOOST_CHECK_EQUAL(graph.get_constraint("AtMostTwo2")->getKernel().getType(), ConstraintKernel::LesserOrEqualToN);
+            BOOST_CHECK_EQUAL(graph.get_constraint("AtMostTwo2")->getKernel().getN(), 2);
+            BOOST_CHECK_EQUAL(graph.get_variable_neighbors("OnlyOne3").size(), 3);
+            BOOST_TEST(graph.get_variable_neighbors("AtMostTwo2").empty());
+
+            // and solving it gives the 2 permutations where B is 1
+            CSPSolver solver;
+            BOOST_CHECK_EQUAL(solver.arcConsistency(graph).size(), 2);
+        }
+
+        BOOST_AUTO_TEST_CASE(huge_counts_of_the_csp_header_are_only_a_hint) {
+            // setup: a header claiming far more than the text holds
+            CSPGraph graph;
+            std::string error;
+            BOOST_REQUIRE_MESSAGE(CSPProblemLoader::parse("csp 2000000000 2000000000\n"
+                                                          "vars 1..2 : A B\n"
+                                                          "con OnlyOne1 exactly 1 1 : A B\n", graph, &error), error);
+
+            // test: the graph holds what the text does, without trying to make room for the counts
+            BOOST_CHECK_EQUAL(graph.get_all_variable_names().size(), 2);
+            BOOST_CHECK_EQUAL(graph.get_all_constraint_names().size(), 1);
+            CSPSolver solver;
+            BOOST_CHECK_EQUAL(solver.arcConsistency(graph).size(), 2);
+        }
+
+        BOOST_AUTO_TEST_CASE(family_without_placeholder_appends_the_value) {
+            CSPGraph graph;
+            BOOST_REQUIRE(CSPProblemLoader::parse("family AtLeastOne atleast 4..5 1\n", graph));
+            std::vector<std::string> expected {"AtLeastOne4", "AtLeastOne5"};
+            std::vector<std::string> actual = graph.get_all_constraint_names();
+            BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), actual.begin(), actual.end());
+            BOOST_CHECK_EQUAL(graph.get_constraint("AtLeastOne5")->getKernel().getType(), ConstraintKernel::GreaterOrEqualToN);
+        }
+
+        BOOST_AUTO_TEST_CASE(alldiff_links_its_scope) {
+            // setup: three variables all different, one of them through an edge
+            CSPGraph graph;
+            std::string error;
+            BOOST_REQUIRE_MESSAGE(CSPProblemLoader::parse("vars 1..3 : A B C\n"
+                                                          "alldiff Row : A B\n"
+                                                          "alldifferent Empty\n"
+                                                          "edge C Row\n", graph, &error), error);
+
+            // test: the kernel & scope are as written, leaving the 6 permutations
+            BOOST_CHECK_EQUAL(graph.get_constraint("Row")->getKernel().getType(), ConstraintKernel::AllDifferent);
+            BOOST_CHECK_EQUAL(graph.get_variable_neighbors("Row").size(), 3);
+            BOOST_TEST(graph.get_variable_neighbors("Empty").empty());
+            CSPSolver solver;
+            BOOST_CHECK_EQUAL(solver.arcConsistency(graph).size(), 6);
+            BOOST_TEST(!CSPProblemLoader::parse("var A 1\nalldiff Row A\n", graph, &error));
+            BOOST_CHECK_EQUAL(error, "line 2: expected 'alldiff <name> [: <variable> ...]'");
+        }
+
+        BOOST_AUTO_TEST_CASE(malformed_text_leaves_graph_untouched) {
+            // setup: a graph holding one variable
+            CSPGraph graph;
+            graph.add_variable("X", {1});
+            std::string error;
+
+            // test: every mistake is reported with its line, and nothing is loaded
+            BOOST_TEST(!CSPProblemLoader::parse("var A 1..3\nvar A 1\n", graph, &error));
+            BOOST_CHECK_EQUAL(error, "line 2: name 'A' is already used");
+            BOOST_TEST(!CSPProblemLoader::parse("var A 1..3\ncon C exactly 1 1 : A B\n", graph, &error));
+            BOOST_CHECK_EQUAL(error, "line 2: unknown variable 'B'");
+            BOOST_TEST(!CSPProblemLoader::parse("var A 1,x\n", graph, &error));
+            BOOST_CHECK_EQUAL(error.substr(0, 8), "line 1: ");
+            // lists with an empty element, be it the first, a middle or the last one
+            for (std::string list : { ",1,2", "1,,2", "1,2," })
+            {
+                BOOST_TEST(!CSPProblemLoader::parse("var A 1\nvar B " + list + "\n", graph, &error), list);
+                BOOST_CHECK_EQUAL(error, "line 2: expected 'var <name> <domain>'");
+            }
+            BOOST_TEST(!CSPProblemLoader::parse("vars 1,2, : A\n", graph, &error));
+            BOOST_CHECK_EQUAL(error, "line 1: expected 'vars <domain> : <name> ...'");
+            BOOST_TEST(!CSPProblemLoader::parse("con C sometimes 1 1\n", graph, &error));
+            BOOST_TEST(!CSPProblemLoader::parse("\n\nsolve everything\n", graph, &error));
+            BOOST_CHECK_EQUAL(error, "line 3: unknown statement 'solve'");
+            BOOST_TEST(!CSPProblemLoader::load("this/file/does/not/exist.csp", graph, &error));
+            std::vector<std::string> names = graph.get_all_variable_names();
+            BOOST_REQUIRE_EQUAL(names.size(), 1);
+            BOOST_CHECK_EQUAL(names[0], "X");
+        }
+
+        BOOST_AUTO_TEST_CASE(ranges_wider_than_the_cap_are_rejected_and_the_largest_int_ends_one) {
+            // setup: a graph holding one variable
+            CSPGraph graph;
+            graph.add_variable("X", {1});
+            std::string error;
+
+            // test: ranges ending at the largest int stop after it, rather than wrapping around
+            CSPGraph loaded;
+            BOOST_REQUIRE_MESSAGE(CSPProblemLoader::parse("var A 2147483645..2147483647\n"
+                                                          "var B 1..65536\n"
+                                                          "family C exactly 2147483646..2147483647 1\n", loaded, &error), error);
+            BOOST_CHECK_EQUAL(loaded.get_variable("A")->getDomainSize(), 3);
+            BOOST_CHECK_EQUAL(loaded.get_variable("B")->getDomainSize(), 65536);
+            BOOST_CHECK_EQUAL(loaded.get_all_constraint_names().size(), 2);
+            // ranges spanning more than 65536 values are rejected with their line, nothing being loaded
+            BOOST_TEST(!CSPProblemLoader::parse("var A 1..3\nvar B 0..2147483647\n", graph, &error));
+            BOOST_CHECK_EQUAL(error, "line 2: range '0..2147483647' spans more than 65536 values");
+            BOOST_TEST(!CSPProblemLoader::parse("vars 0..65536 : A\n", graph, &error));
+            BOOST_CHECK_EQUAL(error, "line 1: range '0..65536' spans more than 65536 values");
+            BOOST_TEST(!CSPProblemLoader::parse("family C exactly -2147483648..2147483647 1\n", graph, &error));
+            BOOST_CHECK_EQUAL(error, "line 1: range '-2147483648..2147483647' spans more than 65536 values");
+            std::vector<std::string> names = graph.get_all_variable_names();
+            BOOST_REQUIRE_EQUAL(names.size(), 1);
+            BOOST_CHECK_EQUAL(names[0], "X");
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE_END();
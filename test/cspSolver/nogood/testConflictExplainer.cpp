@@ -0,0 +1,142 @@
+// Author: Akira Kudo
+// Description: Implements tests for the LevelSet & ConflictExplainer classes under CSPSolverImplementation.
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <vector>
+
+#include "src/cspSolver/nogood/ConflictExplainer.h"
+#include "src/graphImplementation/vertices/VariableVertex.h"
+
+using CSPSolverImplementation::ConflictExplainer, CSPSolverImplementation::LevelSet;
+using GraphImplementation::VariableVertex;
+
+// define fixture
+struct TestConflictExplainer_Fixture
+{
+    ConflictExplainer explainer;
+    // variables numbered as in a frozen graph
+    VariableVertex a = VariableVertex("a", {1, 2});
+    VariableVertex b = VariableVertex("b", {1, 2});
+    VariableVertex c = VariableVertex("c", {1, 2});
+
+    TestConflictExplainer_Fixture()
+    {
+        a.setId(0);
+        b.setId(1);
+        c.setId(2);
+        explainer.reset(3);
+    };
+    ~TestConflictExplainer_Fixture() {};
+};
+
+BOOST_AUTO_TEST_SUITE(LevelSet_test_suite, * boost::unit_test::label("LevelSet"));
+
+    // set of decision levels, numbered from 1
+    // void insert(size_t level); void erase(size_t level); void merge(const LevelSet& other); ...
+    BOOST_AUTO_TEST_SUITE(insert_erase_and_merge);
+
+        BOOST_AUTO_TEST_CASE(levels_past_a_word_are_kept) {
+            // setup: levels on both sides of 64
+            LevelSet levels, others;
+            BOOST_TEST(levels.empty());
+            levels.insert(3);
+            levels.insert(70);
+            others.insert(1);
+            others.insert(3);
+
+            // test: merging keeps every level once, in order
+            levels.merge(others);
+            BOOST_TEST(levels.levels() == std::vector<size_t>({1, 3, 70}));
+            BOOST_TEST(levels.contains(70));
+            BOOST_TEST(!levels.contains(2));
+            BOOST_TEST(!levels.contains(500));
+            levels.erase(70);
+            levels.erase(1);
+            levels.erase(3);
+            BOOST_TEST(levels.empty());
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_FIXTURE_TEST_SUITE(ConflictExplainer_test_suite, TestConflictExplainer_Fixture,
+                         * boost::unit_test::label("ConflictExplainer"));
+
+    // opens the next decision level / restores every explanation changed since the last decision
+    // void decide(uint32_t vv_id, int val); void undoLastDecision();
+    BOOST_AUTO_TEST_SUITE(decide_and_undoLastDecision);
+
+        BOOST_AUTO_TEST_CASE(decisions_explain_their_variable) {
+            // setup: decide a then b
+            explainer.decide(0, 1);
+            explainer.decide(1, 2);
+
+            // test: each variable is explained by its own level, & decisions are kept in order
+            BOOST_CHECK_EQUAL(explainer.level(), 2);
+            BOOST_TEST(explainer.explanationOf(0).levels() == std::vector<size_t>({1}));
+            BOOST_TEST(explainer.explanationOf(1).levels() == std::vector<size_t>({2}));
+            BOOST_TEST(explainer.explanationOf(2).empty());
+            BOOST_CHECK_EQUAL(explainer.decisionAt(2).vv_id, 1);
+            BOOST_CHECK_EQUAL(explainer.decisionAt(2).val, 2);
+
+            // undoing b's decision leaves a's as is
+            explainer.undoLastDecision();
+            BOOST_CHECK_EQUAL(explainer.level(), 1);
+            BOOST_TEST(explainer.explanationOf(1).empty());
+            BOOST_TEST(explainer.explanationOf(0).levels() == std::vector<size_t>({1}));
+            explainer.undoLastDecision();
+            explainer.undoLastDecision();
+            BOOST_CHECK_EQUAL(explainer.level(), 0);
+            BOOST_TEST(explainer.explanationOf(0).empty());
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+    // removals from vv are now also explained by whatever explains removals from the variables of scope
+    // void explainBy(const VariableVertex* vv, const std::vector<VariableVertex*>& scope);
+    BOOST_AUTO_TEST_SUITE(explainBy);
+
+        BOOST_AUTO_TEST_CASE(explanations_gather_through_scopes_and_are_undone) {
+            // setup: a & b decided, then c reduced through a constraint over all three
+            explainer.decide(0, 1);
+            explainer.decide(1, 1);
+            explainer.explainBy(&c, {&a, &b, &c});
+
+            // test: c is explained by both decisions
+            BOOST_TEST(explainer.explanationOf(2).levels() == std::vector<size_t>({1, 2}));
+
+            // c reduced again at a third level, then that level undone
+            explainer.decide(0, 1);
+            LevelSet third;
+            third.insert(3);
+            explainer.explainBy(2, third);
+            BOOST_TEST(explainer.explanationOf(2).levels() == std::vector<size_t>({1, 2, 3}));
+            explainer.undoLastDecision();
+            BOOST_TEST(explainer.explanationOf(2).levels() == std::vector<size_t>({1, 2}));
+            // undoing b's level takes c back to before it was reduced at all
+            explainer.undoLastDecision();
+            BOOST_TEST(explainer.explanationOf(2).empty());
+        }
+
+        BOOST_AUTO_TEST_CASE(removals_before_any_decision_or_of_unknown_variables_are_not_explained) {
+            // setup: a variable outside of the numbering
+            VariableVertex unknown = VariableVertex("unknown", {1});
+            unknown.setId(7);
+
+            // test: before any decision, there is nothing to explain by
+            explainer.explainBy(&a, {&a, &b});
+            BOOST_TEST(explainer.explanationOf(0).empty());
+            // unknown variables are skipped, a only getting b's level
+            explainer.decide(1, 1);
+            explainer.explainBy(&unknown, {&a, &b});
+            explainer.explainBy(&a, {&unknown, &b});
+            BOOST_TEST(explainer.explanationOf(0).levels() == std::vector<size_t>({1}));
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,69 @@
+// Author: Akira Kudo
+// Description: Implements tests for the NogoodStore class under CSPSolverImplementation.
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+
+#include "src/cspSolver/nogood/NogoodStore.h"
+
+using CSPSolverImplementation::NogoodStore;
+
+BOOST_AUTO_TEST_SUITE(NogoodStore_test_suite, * boost::unit_test::label("NogoodStore"));
+
+    // keeps nogood, forgetting the nogood learned first if capacity nogoods are kept already
+    // void add(Nogood nogood);
+    BOOST_AUTO_TEST_SUITE(add);
+
+        BOOST_AUTO_TEST_CASE(full_store_forgets_the_oldest_nogood) {
+            // setup: a store of 2 nogoods, given 3
+            NogoodStore store = NogoodStore(2);
+            store.add({ {0, 1} });
+            store.add({ {1, 1}, {2, 2} });
+            store.add({ {3, 3} });
+
+            // test: the first one was replaced by the third
+            BOOST_REQUIRE_EQUAL(store.size(), 2);
+            BOOST_CHECK_EQUAL(store.at(0)[0].vv_id, 3);
+            BOOST_CHECK_EQUAL(store.at(1).size(), 2);
+            BOOST_CHECK_EQUAL(store.at(1)[1].val, 2);
+            // then the second one
+            store.add({ {4, 4} });
+            BOOST_CHECK_EQUAL(store.at(1)[0].vv_id, 4);
+        }
+
+        BOOST_AUTO_TEST_CASE(empty_nogoods_and_capacity_zero_keep_nothing) {
+            NogoodStore store = NogoodStore(0);
+            store.add({ {0, 1} });
+            BOOST_CHECK_EQUAL(store.size(), 0);
+            store.setCapacity(3);
+            store.add({});
+            BOOST_CHECK_EQUAL(store.size(), 0);
+            store.add({ {0, 1} });
+            BOOST_CHECK_EQUAL(store.size(), 1);
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+    // forgets every nogood / maximum number of nogoods kept; changing it forgets every nogood
+    // void clear(); void setCapacity(size_t capacity);
+    BOOST_AUTO_TEST_SUITE(clear_and_setCapacity);
+
+        BOOST_AUTO_TEST_CASE(nogoods_are_forgotten) {
+            NogoodStore store;
+            BOOST_CHECK_EQUAL(store.getCapacity(), 256);
+            store.add({ {0, 1} });
+            store.clear();
+            BOOST_CHECK_EQUAL(store.size(), 0);
+            store.add({ {0, 1} });
+            store.setCapacity(256);
+            BOOST_CHECK_EQUAL(store.size(), 1);
+            store.setCapacity(10);
+            BOOST_CHECK_EQUAL(store.size(), 0);
+            BOOST_CHECK_EQUAL(store.getCapacity(), 10);
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE_END();
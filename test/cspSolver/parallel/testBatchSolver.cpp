@@ -0,0 +1,178 @@
+// Author: Akira Kudo
+// Description: Implements tests for the BatchSolver class under CSPSolverImplementation.
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "src/cspSolver/CSPGraph.h"
+#include "src/cspSolver/CSPSolver.h"
+#include "src/cspSolver/parallel/BatchSolver.h"
+#include "src/graphImplementation/vertices/ConstraintVertex.h"
+
+using CSPSolverImplementation::BatchSolver, CSPSolverImplementation::CSPGraph, CSPSolverImplementation::CSPSolver;
+using GraphImplementation::ConstraintVertex, GraphImplementation::VariableVertex;
+
+// builds a problem whose answers are the permutations of 1..size, hence size! answers
+CSPGraph makePermutations(int size)
+{
+    CSPGraph permutations = CSPGraph();
+    for (int val = 1; val <= size; val++)
+        permutations.add_constraint("OnlyOne" + std::to_string(val), ConstraintVertex::exactlyN(val, 1));
+    for (int var = 0; var < size; var++)
+    {
+        std::string vv_name = "V" + std::to_string(var);
+        permutations.add_variable(vv_name, {});
+        for (int val = 1; val <= size; val++)
+        {
+            permutations.get_variable(vv_name)->addToDomain(val);
+            permutations.add_edge(vv_name, "OnlyOne" + std::to_string(val));
+        }
+    }
+    return permutations;
+};
+
+BOOST_AUTO_TEST_SUITE(BatchSolver_test_suite, * boost::unit_test::label("BatchSolver"));
+
+    // solves every graph, returning results in the same order
+    // rethrows the first exception thrown while solving, e.g. by a custom predicate
+    // std::vector<Result> solve(std::vector<CSPGraph> graphs);
+    BOOST_AUTO_TEST_SUITE(solve);
+
+        BOOST_AUTO_TEST_CASE(results_come_back_in_input_order) {
+            // setup: many problems of differing sizes, solved over 4 threads
+            std::vector<CSPGraph> graphs;
+            std::vector<size_t> expected_counts;
+            for (int i = 0; i < 24; i++)
+            {
+                int size = 1 + (i * 7) % 5;
+                graphs.push_back(makePermutations(size));
+                size_t factorial = 1;
+                for (int k = 2; k <= size; k++) factorial *= k;
+                expected_counts.push_back(factorial);
+            }
+            CSPGraph first = graphs[0];
+            BatchSolver batch = BatchSolver(4);
+            BOOST_REQUIRE_EQUAL(batch.getThreadCount(), 4);
+            auto results = batch.solve(graphs);
+
+            // test: each result matches its problem, & what a single solver returns
+            BOOST_REQUIRE_EQUAL(results.size(), graphs.size());
+            for (size_t i = 0; i < results.size(); i++)
+            {
+                BOOST_TEST(results[i].loaded);
+                BOOST_CHECK_EQUAL(results[i].solution_count, expected_counts[i]);
+                BOOST_CHECK_EQUAL(results[i].answers.size(), expected_counts[i]);
+            }
+            CSPSolver solver;
+            auto expected_answers = solver.arcConsistency(first);
+            BOOST_REQUIRE_EQUAL(results[0].answers.size(), expected_answers.size());
+            for (size_t i = 0; i < expected_answers.size(); i++)
+                BOOST_CHECK_EQUAL_COLLECTIONS(results[0].answers[i].begin(), results[0].answers[i].end(),
+                                              expected_answers[i].begin(), expected_answers[i].end());
+            BOOST_CHECK_EQUAL(results[0].revision_count, solver.getRevisionCount());
+
+            // a second batch reuses the same workspaces
+            auto again = batch.solve(graphs);
+            for (size_t i = 0; i < again.size(); i++) BOOST_CHECK_EQUAL(again[i].solution_count, expected_counts[i]);
+        }
+
+        BOOST_AUTO_TEST_CASE(settings_and_engine_are_used) {
+            // setup: only count answers, using DFS
+            CSPSolver settings = CSPSolver(CSPSolver::ParallelMode);
+            settings.setSolveMode(CSPSolver::CountOnlyMode);
+            BatchSolver batch = BatchSolver(2, settings, BatchSolver::DepthFirstSearchEngine);
+            auto results = batch.solve({ makePermutations(4), makePermutations(3) });
+
+            // test: answers are counted without being returned
+            BOOST_REQUIRE_EQUAL(results.size(), 2);
+            BOOST_CHECK_EQUAL(results[0].solution_count, 24);
+            BOOST_CHECK_EQUAL(results[1].solution_count, 6);
+            BOOST_TEST(results[0].answers.empty());
+        }
+
+        BOOST_AUTO_TEST_CASE(exceptions_of_predicates_are_rethrown) {
+            // setup: one problem among others holds a predicate that throws
+            CSPGraph throwing = makePermutations(3);
+            throwing.add_constraint("Throws", [] (int val, std::vector<VariableVertex*> others) -> bool
+            {
+                throw std::runtime_error("predicate failed");
+            });
+            throwing.add_edge("V0", "Throws");
+            std::vector<CSPGraph> graphs = { makePermutations(3), throwing, makePermutations(4) };
+
+            // test: solving rethrows for any number of threads, the batch remaining usable afterwards
+            for (size_t thread_count : { 1, 3 })
+            {
+                BatchSolver batch = BatchSolver(thread_count);
+                BOOST_CHECK_THROW(batch.solve(graphs), std::runtime_error);
+                auto results = batch.solve({ makePermutations(4) });
+                BOOST_REQUIRE_EQUAL(results.size(), 1);
+                BOOST_CHECK_EQUAL(results[0].solution_count, 24);
+            }
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+    // loads & solves every file, returning results in the same order as the paths
+    // rethrows the first exception thrown while solving, the loader being stopped first
+    // std::vector<Result> solveFiles(const std::vector<std::string>& paths);
+    BOOST_AUTO_TEST_SUITE(solveFiles);
+
+        BOOST_AUTO_TEST_CASE(binary_text_and_missing_files) {
+            // setup: a binary file, a text file, and a path to nothing
+            std::filesystem::path directory = std::filesystem::temp_directory_path();
+            std::string binary_path = (directory / "testBatchSolver.gcsp").string();
+            std::string text_path = (directory / "testBatchSolver.txt").string();
+            std::string missing_path = (directory / "testBatchSolver_missing.txt").string();
+            CSPSolver solver;
+            BOOST_REQUIRE(solver.saveCspGraph(makePermutations(4), binary_path));
+            {
+                std::ofstream text_file(text_path);
+                text_file << "vars 1..3 : A B C\n"
+                             "family OnlyOne{} exactly 1..3 1 : A B C\n";
+            }
+
+            // test: results come back in the order of the paths, the missing file failing to load
+            BatchSolver batch = BatchSolver(1);
+            auto results = batch.solveFiles({ binary_path, missing_path, text_path, binary_path });
+            BOOST_REQUIRE_EQUAL(results.size(), 4);
+            BOOST_TEST(results[0].loaded);
+            BOOST_CHECK_EQUAL(results[0].solution_count, 24);
+            BOOST_TEST(!results[1].loaded);
+            BOOST_TEST(!results[1].error.empty());
+            BOOST_CHECK_EQUAL(results[1].solution_count, 0);
+            BOOST_TEST(results[2].loaded);
+            BOOST_CHECK_EQUAL(results[2].solution_count, 6);
+            BOOST_CHECK_EQUAL(results[3].solution_count, 24);
+
+            std::remove(binary_path.c_str());
+            std::remove(text_path.c_str());
+        }
+
+        BOOST_AUTO_TEST_CASE(malformed_binary_file_reports_the_serializer_failure) {
+            // setup: a saved graph, cut short
+            std::string binary_path = (std::filesystem::temp_directory_path() / "testBatchSolver_truncated.gcsp").string();
+            CSPSolver solver;
+            BOOST_REQUIRE(solver.saveCspGraph(makePermutations(3), binary_path));
+            std::filesystem::resize_file(binary_path, std::filesystem::file_size(binary_path) - 1);
+
+            // test: the error tells the graph file is malformed, instead of complaining about text syntax
+            BatchSolver batch = BatchSolver(1);
+            auto results = batch.solveFiles({ binary_path });
+            BOOST_REQUIRE_EQUAL(results.size(), 1);
+            BOOST_TEST(!results[0].loaded);
+            BOOST_CHECK_EQUAL(results[0].error, binary_path + ": malformed graph file, saved by an incompatible version or corrupted");
+
+            std::remove(binary_path.c_str());
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,114 @@
+// Author: Akira Kudo
+// Description: Implements tests for the ThreadPool class under CSPSolverImplementation.
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "src/cspSolver/parallel/ThreadPool.h"
+
+using CSPSolverImplementation::ThreadPool;
+
+BOOST_AUTO_TEST_SUITE(ThreadPool_test_suite, * boost::unit_test::label("ThreadPool"));
+
+    // runs queued tasks until every task in group is finished, then rethrows
+    // the first exception thrown by a task of group, if any
+    // void wait(TaskGroup& group);
+    BOOST_AUTO_TEST_SUITE(submit_and_wait);
+
+        BOOST_AUTO_TEST_CASE(every_task_runs_once) {
+            // setup: submit many tasks writing into their own slot
+            ThreadPool pool = ThreadPool(4);
+            std::vector<int> ran(100, 0);
+            ThreadPool::TaskGroup group;
+            for (size_t i = 0; i < ran.size(); i++) pool.submit(group, [&ran, i] { ran[i]++; });
+            pool.wait(group);
+
+            // test: check every task ran exactly once
+            BOOST_TEST(group.finished());
+            for (int count : ran) BOOST_CHECK_EQUAL(count, 1);
+        }
+
+        BOOST_AUTO_TEST_CASE(single_thread_runs_tasks_while_waiting) {
+            // setup: a pool without background workers
+            ThreadPool pool = ThreadPool(1);
+            BOOST_REQUIRE_EQUAL(pool.getThreadCount(), 1);
+            int sum = 0;
+            ThreadPool::TaskGroup group;
+            for (int i = 1; i <= 10; i++) pool.submit(group, [&sum, i] { sum += i; });
+
+            // test: waiting runs every task on the calling thread
+            pool.wait(group);
+            BOOST_CHECK_EQUAL(sum, 55);
+        }
+
+        BOOST_AUTO_TEST_CASE(tasks_can_spawn_and_wait_on_subtasks) {
+            // setup: every task spawns subtasks and waits on them, fork-join style
+            ThreadPool pool = ThreadPool(3);
+            std::atomic<int> leaves(0);
+            ThreadPool::TaskGroup group;
+            for (int i = 0; i < 8; i++)
+            {
+                pool.submit(group, [&pool, &leaves]
+                {
+                    ThreadPool::TaskGroup subgroup;
+                    for (int j = 0; j < 8; j++) pool.submit(subgroup, [&leaves] { leaves++; });
+                    pool.wait(subgroup);
+                });
+            }
+            pool.wait(group);
+
+            // test: check no subtask was lost, and nothing deadlocked
+            BOOST_CHECK_EQUAL(leaves.load(), 64);
+        }
+
+        BOOST_AUTO_TEST_CASE(waiting_sleeps_while_another_thread_runs_the_last_task) {
+            // setup: a background worker takes a slow task before we start waiting on it
+            ThreadPool pool = ThreadPool(2);
+            std::atomic<bool> started(false);
+            ThreadPool::TaskGroup group;
+            pool.submit(group, [&started]
+            {
+                started = true;
+                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            });
+            while (!started) std::this_thread::yield();
+            std::clock_t cpu_start = std::clock();
+            pool.wait(group);
+
+            // test: the task finished, while waiting on it took little processor time
+            BOOST_TEST(group.finished());
+            BOOST_TEST(double(std::clock() - cpu_start) / CLOCKS_PER_SEC < 0.1);
+        }
+
+        BOOST_AUTO_TEST_CASE(exceptions_of_tasks_are_rethrown_once_the_group_is_finished) {
+            // setup: some tasks throw, the others count themselves
+            ThreadPool pool = ThreadPool(3);
+            std::atomic<int> ran(0);
+            ThreadPool::TaskGroup group;
+            for (int i = 0; i < 20; i++)
+            {
+                if (i % 5 == 0) pool.submit(group, [] { throw std::runtime_error("task failed"); });
+                else pool.submit(group, [&ran] { ran++; });
+            }
+
+            // test: waiting rethrows, yet only once every task has run
+            BOOST_CHECK_THROW(pool.wait(group), std::runtime_error);
+            BOOST_TEST(group.finished());
+            BOOST_CHECK_EQUAL(ran.load(), 16);
+            // the exception was handed over, and the pool remains usable
+            BOOST_CHECK_NO_THROW(pool.wait(group));
+            pool.submit(group, [&ran] { ran++; });
+            BOOST_CHECK_NO_THROW(pool.wait(group));
+            BOOST_CHECK_EQUAL(ran.load(), 17);
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE_END();
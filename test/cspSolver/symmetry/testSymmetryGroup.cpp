@@ -0,0 +1,162 @@
+// Author: Akira Kudo
+// Description: Implements tests for the SymmetryGroup class under CSPSolverImplementation.
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "src/cspSolver/CSPGraph.h"
+#include "src/cspSolver/symmetry/SymmetryGroup.h"
+#include "src/graphImplementation/vertices/ConstraintVertex.h"
+#include "src/graphImplementation/vertices/VariableVertex.h"
+
+using CSPSolverImplementation::CSPGraph, CSPSolverImplementation::SymmetryGroup;
+using GraphImplementation::ConstraintVertex, GraphImplementation::VariableVertex;
+
+// define fixture
+struct TestSymmetryGroup_Fixture
+{
+    SymmetryGroup group;
+    // A, B, C & D can each be 1, 2 or 3, exactly one of them being 1 & exactly one being 2
+    CSPGraph graph;
+
+    TestSymmetryGroup_Fixture()
+    {
+        for (std::string vv_name : {"A", "B", "C", "D"}) graph.add_variable(vv_name, {1, 2, 3});
+        graph.add_constraint("OnlyOne1", ConstraintVertex::exactlyN(1, 1));
+        graph.add_constraint("OnlyOne2", ConstraintVertex::exactlyN(2, 1));
+        for (std::string vv_name : {"A", "B", "C", "D"})
+        {
+            graph.add_edge(vv_name, "OnlyOne1");
+            graph.add_edge(vv_name, "OnlyOne2");
+        }
+    };
+    ~TestSymmetryGroup_Fixture() {};
+};
+
+BOOST_FIXTURE_TEST_SUITE(SymmetryGroup_test_suite, TestSymmetryGroup_Fixture, * boost::unit_test::label("SymmetryGroup"));
+
+    // finds the interchangeable variables & values of graph given its current domains
+    // void detect(const CSPGraph& graph);
+    BOOST_AUTO_TEST_SUITE(detect);
+
+        BOOST_AUTO_TEST_CASE(variables_touching_the_same_constraints_and_twin_counted_values_are_interchangeable) {
+            // setup: freeze the graph as is
+            graph.freeze();
+            group.detect(graph);
+
+            // test: the four variables are interchangeable, & so are 1 & 2, 3 being counted by nothing
+            BOOST_REQUIRE_EQUAL(group.getVariableClasses().size(), 1);
+            BOOST_TEST(group.getVariableClasses()[0] == std::vector<uint32_t>({0, 1, 2, 3}));
+            BOOST_REQUIRE_EQUAL(group.getValueClasses().size(), 1);
+            BOOST_TEST(group.getValueClasses()[0] == std::vector<int>({1, 2}));
+            BOOST_TEST(group.getValueHolders(0) == std::vector<uint32_t>({0, 1, 2, 3}));
+        }
+
+        BOOST_AUTO_TEST_CASE(differences_in_constraints_domains_or_bounds_tell_apart) {
+            // setup: D is also in a constraint of its own, C lost value 3, and there must be two 2
+            graph.add_constraint("DIsSpecial", ConstraintVertex::lesserOrEqualToN(3, 1));
+            graph.add_edge("D", "DIsSpecial");
+            graph.remove_vertex("OnlyOne2");
+            graph.add_constraint("Two2", ConstraintVertex::exactlyN(2, 2));
+            for (std::string vv_name : {"A", "B", "C", "D"}) graph.add_edge(vv_name, "Two2");
+            graph.freeze();
+            graph.variable_at(2)->removeFromDomain(3);
+            group.detect(graph);
+
+            // test: only A & B are left interchangeable, & no value
+            BOOST_REQUIRE_EQUAL(group.getVariableClasses().size(), 1);
+            BOOST_TEST(group.getVariableClasses()[0] == std::vector<uint32_t>({0, 1}));
+            BOOST_TEST(group.getValueClasses().empty());
+        }
+
+        BOOST_AUTO_TEST_CASE(custom_predicates_rule_out_their_variables_and_values) {
+            // setup: D can't be 1 as a custom predicate
+            graph.add_constraint("DNot1", [] (int val, std::vector<VariableVertex*> others) { return val != 1; });
+            graph.add_edge("D", "DNot1");
+            graph.freeze();
+            group.detect(graph);
+
+            // test: D is left out, and so are the values it holds, that is every value
+            BOOST_REQUIRE_EQUAL(group.getVariableClasses().size(), 1);
+            BOOST_TEST(group.getVariableClasses()[0] == std::vector<uint32_t>({0, 1, 2}));
+            BOOST_TEST(group.getValueClasses().empty());
+            // clearing forgets every class
+            group.clear();
+            BOOST_TEST(group.empty());
+        }
+
+        BOOST_AUTO_TEST_CASE(every_value_is_alike_to_all_different_and_alike_bounds) {
+            // setup: X, Y & Z all different, then bounded alike for 1 & 2 by a global cardinality constraint
+            CSPGraph other = CSPGraph();
+            for (std::string vv_name : {"X", "Y", "Z"}) other.add_variable(vv_name, {1, 2, 3});
+            other.add_constraint("AllDiff", ConstraintVertex::allDifferent());
+            for (std::string vv_name : {"X", "Y", "Z"}) other.add_edge(vv_name, "AllDiff");
+            other.freeze();
+            group.detect(other);
+            BOOST_REQUIRE_EQUAL(group.getValueClasses().size(), 1);
+            BOOST_TEST(group.getValueClasses()[0] == std::vector<int>({1, 2, 3}));
+
+            // test: bounds over the variables set 3 apart from 1 & 2
+            other.add_constraint("Bounds", ConstraintVertex::globalCardinality({ {1, 0, 1}, {2, 0, 1}, {3, 1, 1} }));
+            for (std::string vv_name : {"X", "Y", "Z"}) other.add_edge(vv_name, "Bounds");
+            other.freeze();
+            group.detect(other);
+            BOOST_REQUIRE_EQUAL(group.getValueClasses().size(), 1);
+            BOOST_TEST(group.getValueClasses()[0] == std::vector<int>({1, 2}));
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+    // number of answers symmetric to the answer given by values, itself included / key of those answers
+    // size_t orbitSize(const int* values) const; std::vector<int> orbitKey(const int* values) const;
+    BOOST_AUTO_TEST_SUITE(orbitSize_and_orbitKey);
+
+        BOOST_AUTO_TEST_CASE(symmetric_answers_are_counted_and_share_a_key) {
+            // setup: freeze the graph as is
+            graph.freeze();
+            group.detect(graph);
+
+            // test: every answer is symmetric to the others, 4 variables taking 1 & 2 once each in 12 ways
+            std::vector<int> answer = {1, 3, 2, 3}, symmetric = {3, 2, 3, 1};
+            BOOST_CHECK_EQUAL(group.orbitSize(answer.data()), 12);
+            BOOST_TEST(group.orbitKey(answer.data()) == group.orbitKey(symmetric.data()));
+        }
+
+        BOOST_AUTO_TEST_CASE(answers_taking_values_in_different_ways_differ) {
+            // setup: X & Y are free to take 1 or 2
+            CSPGraph other = CSPGraph();
+            other.add_variable("X", {1, 2});
+            other.add_variable("Y", {1, 2});
+            other.freeze();
+            group.detect(other);
+
+            // test: the answers where both are the same & those where they differ are two of each
+            std::vector<int> same = {1, 1}, also_same = {2, 2}, different = {2, 1};
+            BOOST_CHECK_EQUAL(group.orbitSize(same.data()), 2);
+            BOOST_CHECK_EQUAL(group.orbitSize(different.data()), 2);
+            BOOST_TEST(group.orbitKey(same.data()) == group.orbitKey(also_same.data()));
+            BOOST_TEST(group.orbitKey(same.data()) != group.orbitKey(different.data()));
+        }
+
+        BOOST_AUTO_TEST_CASE(large_orbits_saturate) {
+            // setup: 30 free variables of 30 values
+            CSPGraph other = CSPGraph();
+            std::set<int> domain;
+            for (int val = 0; val < 30; val++) domain.insert(val);
+            for (int i = 0; i < 30; i++) other.add_variable("V" + std::to_string(i), domain);
+            other.freeze();
+            group.detect(other);
+
+            // test: 30! answers are symmetric to an answer where every value is taken
+            std::vector<int> answer(domain.begin(), domain.end());
+            BOOST_CHECK_EQUAL(group.orbitSize(answer.data()), SIZE_MAX);
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE_END();
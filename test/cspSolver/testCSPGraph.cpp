@@ -5,6 +5,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include <algorithm>
+#include <cstdint>
 #include <set>
 #include <string>
 #include <vector>
@@ -964,6 +965,255 @@ BOOST_FIXTURE_TEST_SUITE(CSPGraph_test_suite, TestCSPGraph_Fixture, * boost::uni
 
     BOOST_AUTO_TEST_SUITE_END();
 
+    // numbers variables & constraints densely in the order they were added, and
+    // stores the adjacency as flat arrays of ids; does nothing if already frozen
+    // void freeze();
+    BOOST_AUTO_TEST_SUITE(freeze);
+
+        BOOST_AUTO_TEST_CASE(ids_follow_insertion_order) {
+            // setup: add vertices and edges, then freeze
+            g.add_variable("vv1", {0, 1});
+            g.add_constraint("cv1", GraphImplementation::ConstraintVertex::exactlyN(0, 1));
+            g.add_variable("vv2", {0, 1});
+            g.add_constraint("cv2", GraphImplementation::ConstraintVertex::exactlyN(1, 1));
+            g.add_variable("vv3", {0, 1});
+            g.add_edge("vv1", "cv1");
+            g.add_edge("vv2", "cv1");
+            g.add_edge("vv3", "cv1");
+            g.add_edge("vv3", "cv2");
+            g.freeze();
+
+            // test: check ids & sizes of the frozen view
+            BOOST_TEST_REQUIRE(g.is_frozen());
+            BOOST_CHECK_EQUAL(g.num_variables(), 3);
+            BOOST_CHECK_EQUAL(g.num_constraints(), 2);
+            BOOST_CHECK_EQUAL(g.num_arcs(), 4);
+            BOOST_TEST(g.variable_at(0) == g.get_variable("vv1"));
+            BOOST_TEST(g.variable_at(2) == g.get_variable("vv3"));
+            BOOST_TEST(g.constraint_at(1) == g.get_constraint("cv2"));
+            BOOST_CHECK_EQUAL(g.get_variable("vv2")->getId(), 1);
+            BOOST_CHECK_EQUAL(g.get_constraint("cv1")->getId(), 0);
+        }
+
+        BOOST_AUTO_TEST_CASE(adjacency_by_id_matches_adjacency_by_name) {
+            // setup: add vertices and edges, then freeze
+            g.add_variable("vv1", {0, 1});
+            g.add_variable("vv2", {0, 1});
+            g.add_variable("vv3", {0, 1});
+            g.add_constraint("cv1", GraphImplementation::ConstraintVertex::exactlyN(0, 1));
+            g.add_constraint("cv2", GraphImplementation::ConstraintVertex::exactlyN(1, 1));
+            g.add_edge("vv3", "cv1");
+            g.add_edge("vv1", "cv1");
+            g.add_edge("vv3", "cv2");
+            g.freeze();
+
+            // test: check neighbor ids point to the same vertices as neighbors obtained by name
+            for (uint32_t cv_id = 0; cv_id < g.num_constraints(); cv_id++)
+            {
+                auto by_name = g.get_variable_neighbors(g.constraint_at(cv_id)->getName());
+                auto by_id = g.variable_neighbor_ids(cv_id);
+                BOOST_REQUIRE_EQUAL(by_name.size(), by_id.size());
+                for (uint32_t position = 0; position < by_id.size(); position++)
+                {
+                    BOOST_TEST(g.variable_at(by_id[position]) == by_name[position]);
+                    // arcs know their constraint & main variable
+                    uint32_t arc = g.arc_id(cv_id, position);
+                    BOOST_CHECK_EQUAL(g.arc_constraint_id(arc), cv_id);
+                    BOOST_CHECK_EQUAL(g.arc_main_variable_id(arc), by_id[position]);
+                }
+            }
+            for (uint32_t vv_id = 0; vv_id < g.num_variables(); vv_id++)
+            {
+                auto by_name = g.get_constraint_neighbors(g.variable_at(vv_id)->getName());
+                auto by_id = g.constraint_neighbor_ids(vv_id);
+                BOOST_REQUIRE_EQUAL(by_name.size(), by_id.size());
+                for (uint32_t position = 0; position < by_id.size(); position++)
+                    BOOST_TEST(g.constraint_at(by_id[position]) == by_name[position]);
+            }
+            BOOST_CHECK_EQUAL(g.constraint_neighbor_ids(1).size(), 0);
+        }
+
+        BOOST_AUTO_TEST_CASE(structural_change_unfreezes) {
+            // setup: freeze a small graph
+            g.add_variable("vv1", {0, 1});
+            g.add_constraint("cv1", GraphImplementation::ConstraintVertex::exactlyN(0, 1));
+            g.freeze();
+            // precondition: graph is frozen
+            BOOST_TEST_REQUIRE(g.is_frozen());
+
+            // test: any change to vertices or edges unfreezes the graph, while
+            // freezing again takes the change into account
+            g.add_edge("vv1", "cv1");
+            BOOST_TEST(!g.is_frozen());
+            g.freeze();
+            BOOST_CHECK_EQUAL(g.num_arcs(), 1);
+            g.remove_edge("vv1", "cv1");
+            BOOST_TEST(!g.is_frozen());
+            g.freeze();
+            g.add_variable("vv2", {0});
+            BOOST_TEST(!g.is_frozen());
+            g.freeze();
+            g.remove_vertex("vv1");
+            BOOST_TEST(!g.is_frozen());
+            g.freeze();
+            BOOST_CHECK_EQUAL(g.num_variables(), 1);
+            BOOST_TEST(g.variable_at(0) == g.get_variable("vv2"));
+            BOOST_CHECK_EQUAL(g.num_arcs(), 0);
+        }
+
+        BOOST_AUTO_TEST_CASE(copy_of_frozen_graph_is_frozen_with_same_ids) {
+            // setup: freeze a graph, then copy it
+            g.add_variable("vv1", {0, 1});
+            g.add_variable("vv2", {0, 1});
+            g.add_constraint("cv1", GraphImplementation::ConstraintVertex::exactlyN(0, 1));
+            g.add_edge("vv2", "cv1");
+            g.add_edge("vv1", "cv1");
+            g.freeze();
+            CSPSolverImplementation::CSPGraph copied_g = g;
+
+            // test: the copy is frozen, its ids pointing to its own vertices
+            BOOST_TEST_REQUIRE(copied_g.is_frozen());
+            BOOST_TEST(compare_two_cspg(copied_g, g));
+            for (uint32_t vv_id = 0; vv_id < g.num_variables(); vv_id++)
+            {
+                BOOST_TEST(copied_g.variable_at(vv_id) != g.variable_at(vv_id));
+                BOOST_CHECK_EQUAL(copied_g.variable_at(vv_id)->getName(), g.variable_at(vv_id)->getName());
+            }
+            for (uint32_t arc = 0; arc < g.num_arcs(); arc++)
+                BOOST_CHECK_EQUAL(copied_g.arc_main_variable_id(arc), g.arc_main_variable_id(arc));
+            // neighbors by name come in the same order as in the original
+            auto copied_neighbors = copied_g.get_variable_neighbors("cv1");
+            BOOST_CHECK_EQUAL(copied_neighbors[0]->getName(), "vv2");
+            BOOST_CHECK_EQUAL(copied_neighbors[1]->getName(), "vv1");
+        }
+
+        BOOST_AUTO_TEST_CASE(requeued_arcs_are_those_of_the_other_variables_of_each_constraint) {
+            // setup: vv1 & vv2 share cv1, vv2 & vv3 share cv2, and vv2 is alone in cv3
+            for (auto vv_name : {"vv1", "vv2", "vv3"}) g.add_variable(vv_name, {0, 1});
+            g.add_constraint("cv1", GraphImplementation::ConstraintVertex::exactlyN(0, 1));
+            g.add_constraint("cv2", GraphImplementation::ConstraintVertex::exactlyN(1, 1));
+            g.add_constraint("cv3", GraphImplementation::ConstraintVertex::exactlyN(1, 1));
+            g.add_edge("vv1", "cv1");
+            g.add_edge("vv2", "cv1");
+            g.add_edge("vv2", "cv2");
+            g.add_edge("vv3", "cv2");
+            g.add_edge("vv2", "cv3");
+            g.freeze();
+            auto requeued = [](const CSPSolverImplementation::CSPGraph& graph, uint32_t vv_id)
+            {
+                CSPSolverImplementation::IdSpan arcs = graph.requeue_arc_ids_of(vv_id);
+                return std::vector<uint32_t>(arcs.begin(), arcs.end());
+            };
+
+            // test: arcs are numbered cv1: (vv1, vv2) = 0 & 1, cv2: (vv2, vv3) = 2 & 3, cv3: (vv2) = 4
+            BOOST_TEST(requeued(g, 0) == std::vector<uint32_t>({1}));
+            BOOST_TEST(requeued(g, 1) == std::vector<uint32_t>({0, 3}));
+            BOOST_TEST(requeued(g, 2) == std::vector<uint32_t>({2}));
+            // copies share the very same lists, & subgraphs list their own
+            CSPSolverImplementation::CSPGraph copied_g = g;
+            BOOST_TEST(copied_g.requeue_arc_ids_of(1).begin() == g.requeue_arc_ids_of(1).begin());
+            // cv2 keeps its scope order there, vv2 & vv3 becoming 1 & 0, hence the arc of vv2 being 0
+            BOOST_TEST(requeued(g.induced_subgraph({2, 1}), 0) == std::vector<uint32_t>({0}));
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+    // replaces every group of two or more cardinality constraints over the same variables
+    // by a single global cardinality constraint; returns the number of constraints created
+    // size_t fuse_cardinality_constraints();
+    BOOST_AUTO_TEST_SUITE(fuse_cardinality_constraints);
+
+        BOOST_AUTO_TEST_CASE(groups_sharing_a_scope_are_fused) {
+            // setup: a row of three cells with one constraint per value, another constraint over 
+            // part of the row, a lone constraint over a single cell & a custom predicate
+            g.add_variable("c1", {1, 2, 3});
+            g.add_variable("c2", {1, 2, 3});
+            g.add_variable("c3", {1, 2, 3});
+            g.add_constraint("One1", ConstraintVertex::exactlyN(1, 1));
+            g.add_constraint("AtMostOne2", ConstraintVertex::lesserOrEqualToN(2, 1));
+            g.add_constraint("Pair3", ConstraintVertex::greaterOrEqualToN(3, 1));
+            g.add_constraint("AtLeastOne3", ConstraintVertex::greaterOrEqualToN(3, 1));
+            g.add_constraint("Custom", [] (int val, std::vector<VariableVertex*> others) { return true; });
+            // the row is linked in differing orders
+            for (auto vv_name : {"c1", "c2", "c3"}) g.add_edge(vv_name, "One1");
+            for (auto vv_name : {"c3", "c1", "c2"}) g.add_edge(vv_name, "AtMostOne2");
+            for (auto vv_name : {"c2", "c3", "c1"}) g.add_edge(vv_name, "AtLeastOne3");
+            for (auto vv_name : {"c1", "c2"}) g.add_edge(vv_name, "Pair3");
+            for (auto vv_name : {"c1", "c2", "c3"}) g.add_edge(vv_name, "Custom");
+
+            // test: only the row constraints are fused, under the name of the first one
+            BOOST_CHECK_EQUAL(g.fuse_cardinality_constraints(), 1);
+            BOOST_CHECK_EQUAL(g.get_all_constraint_names().size(), 3);
+            BOOST_TEST(g.get_constraint("AtMostOne2") == nullptr);
+            BOOST_TEST(g.get_constraint("AtLeastOne3") == nullptr);
+            BOOST_TEST(g.get_constraint("Pair3") != nullptr);
+            BOOST_TEST(g.get_constraint("Custom") != nullptr);
+            ConstraintVertex* fused = g.get_constraint("One1");
+            BOOST_REQUIRE(fused != nullptr);
+            BOOST_CHECK_EQUAL(fused->getKernel().getType(), GraphImplementation::ConstraintKernel::GlobalCardinality);
+            BOOST_CHECK_EQUAL(fused->getDescription(), "Fuses One1 AtMostOne2 AtLeastOne3");
+            BOOST_CHECK_EQUAL(g.get_variable_neighbors("One1").size(), 3);
+            auto bounds = fused->getKernel().getBounds();
+            BOOST_REQUIRE_EQUAL(bounds.size(), 3);
+            BOOST_CHECK_EQUAL(bounds[0].min, 1);
+            BOOST_CHECK_EQUAL(bounds[0].max, 1);
+            BOOST_CHECK_EQUAL(bounds[1].min, 0);
+            BOOST_CHECK_EQUAL(bounds[1].max, 1);
+            BOOST_CHECK_EQUAL(bounds[2].min, 1);
+            BOOST_CHECK_EQUAL(bounds[2].max, 3);
+
+            // fusing again finds nothing left to fuse
+            BOOST_CHECK_EQUAL(g.fuse_cardinality_constraints(), 0);
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+    // ids of the variables of each connected component, variables being connected through the constraints
+    // they share / graph holding copies of the given variables & the constraints whose scope is among them
+    // std::vector<std::vector<uint32_t>> connected_components() const; CSPGraph induced_subgraph(...) const;
+    BOOST_AUTO_TEST_SUITE(connected_components_and_induced_subgraph);
+
+        BOOST_AUTO_TEST_CASE(constraints_connect_variables_into_components) {
+            // setup: a & c share a constraint, as do c & e; b is on its own in a constraint & d is free;
+            // a constraint without any variable connects nothing
+            for (auto vv_name : {"a", "b", "c", "d", "e"}) g.add_variable(vv_name, {1, 2});
+            g.add_constraint("AC", ConstraintVertex::exactlyN(1, 1));
+            g.add_constraint("B", ConstraintVertex::exactlyN(2, 1));
+            g.add_constraint("EC", ConstraintVertex::lesserOrEqualToN(2, 1));
+            g.add_constraint("Nothing", ConstraintVertex::exactlyN(1, 1));
+            for (auto vv_name : {"a", "c"}) g.add_edge(vv_name, "AC");
+            g.add_edge("b", "B");
+            for (auto vv_name : {"e", "c"}) g.add_edge(vv_name, "EC");
+            g.freeze();
+
+            // test 1: three components, in the order of their smallest id
+            std::vector<std::vector<uint32_t>> components = g.connected_components();
+            BOOST_REQUIRE_EQUAL(components.size(), 3);
+            BOOST_TEST(components[0] == std::vector<uint32_t>({0, 2, 4}));
+            BOOST_TEST(components[1] == std::vector<uint32_t>({1}));
+            BOOST_TEST(components[2] == std::vector<uint32_t>({3}));
+
+            // test 2: the first component holds both its constraints, their scopes keeping their order
+            g.get_variable("c")->removeFromDomain(2);
+            CSPSolverImplementation::CSPGraph sub = g.induced_subgraph(components[0]);
+            BOOST_TEST(sub.is_frozen());
+            BOOST_CHECK_EQUAL(sub.num_variables(), 3);
+            BOOST_TEST(sub.get_all_variable_names() == std::vector<std::string>({"a", "c", "e"}));
+            BOOST_TEST(sub.get_all_constraint_names() == std::vector<std::string>({"AC", "EC"}));
+            BOOST_CHECK_EQUAL(sub.variable_at(2)->getName(), "e");
+            BOOST_CHECK_EQUAL(sub.variable_neighbor_ids(1)[0], 2);
+            BOOST_CHECK_EQUAL(sub.constraint_neighbor_ids(1).size(), 2);
+            // domains are copied as they are
+            BOOST_TEST(sub.get_variable("c")->getDomain() == std::set<int>({1}));
+            // test 3: a free variable comes alone, and constraints reaching outside are left out
+            CSPSolverImplementation::CSPGraph free = g.induced_subgraph({3});
+            BOOST_CHECK_EQUAL(free.num_variables(), 1);
+            BOOST_CHECK_EQUAL(free.num_constraints(), 0);
+            BOOST_CHECK_EQUAL(g.induced_subgraph({0, 1}).num_constraints(), 1);
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
     // attempt to emulate real world possible use cases to catch potential further errors
     BOOST_AUTO_TEST_CASE(real_world_use_case) {
         /*
@@ -0,0 +1,251 @@
+// Author: Akira Kudo
+// Description: Implements tests for the CSPSession class under CSPSolverImplementation.
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "src/cspSolver/CSPGraph.h"
+#include "src/cspSolver/CSPSession.h"
+#include "src/cspSolver/CSPSolver.h"
+#include "src/graphImplementation/domains/Domain.h"
+#include "src/graphImplementation/vertices/ConstraintVertex.h"
+#include "src/graphImplementation/vertices/VariableVertex.h"
+
+using CSPSolverImplementation::CSPGraph, CSPSolverImplementation::CSPSession, CSPSolverImplementation::CSPSolver;
+using GraphImplementation::ConstraintVertex, GraphImplementation::Domain, GraphImplementation::VariableVertex;
+
+// builds a problem whose answers are the permutations of 1..size over variables V0.., hence size! answers
+CSPGraph makeSessionPermutations(int size)
+{
+    CSPGraph permutations = CSPGraph();
+    for (int val = 1; val <= size; val++)
+        permutations.add_constraint("OnlyOne" + std::to_string(val), ConstraintVertex::exactlyN(val, 1));
+    for (int var = 0; var < size; var++)
+    {
+        std::string vv_name = "V" + std::to_string(var);
+        permutations.add_variable(vv_name, {});
+        for (int val = 1; val <= size; val++)
+        {
+            permutations.get_variable(vv_name)->addToDomain(val);
+            permutations.add_edge(vv_name, "OnlyOne" + std::to_string(val));
+        }
+    }
+    return permutations;
+};
+
+// domains of every variable of graph, by name
+std::vector<std::set<int>> sessionDomains(const CSPSession& session, int size)
+{
+    CSPGraph graph = session.getGraph();
+    std::vector<std::set<int>> domains;
+    for (int var = 0; var < size; var++) domains.push_back(graph.get_variable("V" + std::to_string(var))->getDomain());
+    return domains;
+};
+
+BOOST_AUTO_TEST_SUITE(CSPSession_test_suite, * boost::unit_test::label("CSPSession"));
+
+    // propagates graph to its fixpoint right away
+    // CSPSession(CSPGraph graph, const CSPSolver& settings=CSPSolver(), Frontier frontier=Frontier(Frontier::QueueMode));
+    BOOST_AUTO_TEST_SUITE(constructor);
+
+        BOOST_AUTO_TEST_CASE(starts_at_fixpoint) {
+            // setup: V0 can only be 1, which no other variable can be then
+            CSPGraph graph = makeSessionPermutations(3);
+            graph.get_variable("V0")->removeFromDomain({2, 3});
+            CSPSession session = CSPSession(graph);
+
+            // test: the other variables lost 1, and searching from there finds both answers
+            BOOST_TEST(session.isConsistent());
+            std::vector<std::set<int>> expected { {1}, {2, 3}, {2, 3} };
+            BOOST_TEST(sessionDomains(session, 3) == expected);
+            BOOST_TEST(session.getRevisionCount() > 0);
+            BOOST_CHECK_EQUAL(session.solve().size(), 2);
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+    // removes every value but val / removes val from the domain of a variable, then revises
+    // the arcs of its neighbors through the constraints touching it
+    // bool restrictDomainTo(const std::string& vv_name, int val); bool removeFromDomain(const std::string& vv_name, int val);
+    BOOST_AUTO_TEST_SUITE(restrictDomainTo_and_removeFromDomain);
+
+        BOOST_AUTO_TEST_CASE(same_fixpoint_as_from_scratch_with_fewer_revisions) {
+            // setup: learn facts one at a time, and after each one start another session
+            // with every fact so far given at once, as if propagating again from scratch
+            CSPSession incremental = CSPSession(makeSessionPermutations(6));
+            size_t revisions_before_facts = incremental.getRevisionCount();
+            CSPGraph with_facts = makeSessionPermutations(6);
+            size_t from_scratch_revisions = 0;
+            auto check_same_fixpoint = [&incremental, &with_facts, &from_scratch_revisions]()
+            {
+                CSPSession from_scratch = CSPSession(with_facts);
+                from_scratch_revisions += from_scratch.getRevisionCount();
+                BOOST_TEST(sessionDomains(incremental, 6) == sessionDomains(from_scratch, 6));
+                BOOST_CHECK_EQUAL(incremental.solve().size(), from_scratch.solve().size());
+            };
+
+            // test: both reach the same domains after each fact, the facts costing fewer revisions
+            BOOST_TEST(incremental.restrictDomainTo("V0", 1));
+            with_facts.get_variable("V0")->removeFromDomain({2, 3, 4, 5, 6});
+            check_same_fixpoint();
+            BOOST_TEST(incremental.removeFromDomain("V1", 2));
+            with_facts.get_variable("V1")->removeFromDomain(2);
+            check_same_fixpoint();
+            BOOST_TEST(incremental.removeFromDomain("V2", 2));
+            with_facts.get_variable("V2")->removeFromDomain(2);
+            check_same_fixpoint();
+            BOOST_TEST(incremental.restrictDomainTo("V3", 3));
+            with_facts.get_variable("V3")->removeFromDomain({1, 2, 4, 5, 6});
+            check_same_fixpoint();
+            BOOST_TEST(incremental.getRevisionCount() - revisions_before_facts < from_scratch_revisions);
+            // 2 goes to V4 or V5, the other one sharing 4, 5 & 6 with V1 & V2
+            BOOST_CHECK_EQUAL(incremental.solve().size(), 12);
+        }
+
+        BOOST_AUTO_TEST_CASE(wiping_out_a_domain_is_inconsistent) {
+            // setup: two variables can't both be 1
+            CSPSession session = CSPSession(makeSessionPermutations(3));
+            BOOST_TEST(session.restrictDomainTo("V0", 1));
+
+            // test: the second fact leaves no answer, and the session stays inconsistent
+            BOOST_TEST(!session.restrictDomainTo("V1", 1));
+            BOOST_TEST(!session.isConsistent());
+            BOOST_TEST(!session.removeFromDomain("V2", 3));
+            BOOST_TEST(session.solve().empty());
+        }
+
+        BOOST_AUTO_TEST_CASE(unknown_names_change_nothing) {
+            CSPSession session = CSPSession(makeSessionPermutations(3));
+            BOOST_TEST(!session.restrictDomainTo("Nobody", 1));
+            BOOST_TEST(!session.removeFromDomain("OnlyOne1", 1));
+            BOOST_TEST(session.isConsistent());
+            BOOST_CHECK_EQUAL(session.solve().size(), 6);
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+    // adds a variable / a constraint over the variables of scope / an edge, then revises the affected arcs
+    // bool addVariable(...); bool addConstraint(...); bool addEdge(const std::string& vv_name, const std::string& cv_name);
+    BOOST_AUTO_TEST_SUITE(addVariable_addConstraint_and_addEdge);
+
+        BOOST_AUTO_TEST_CASE(structural_facts_propagate) {
+            // setup: permutations of 1..3, to which a new variable W is tied
+            CSPSession session = CSPSession(makeSessionPermutations(3));
+            BOOST_TEST(session.addVariable("W", Domain({1, 2})));
+            BOOST_CHECK_EQUAL(session.solve().size(), 12);
+
+            // test: V0 is told not to be 1 or 2 through a new unary constraint
+            BOOST_TEST(session.addConstraint("V0Is3", ConstraintVertex::exactlyN(3, 1), { "V0" }));
+            std::vector<std::set<int>> expected { {3}, {1, 2}, {1, 2} };
+            BOOST_TEST(sessionDomains(session, 3) == expected);
+            BOOST_CHECK_EQUAL(session.solve().size(), 4);
+
+            // tying W to OnlyOne1 then forces W to 2, as V1 or V2 is already 1
+            BOOST_TEST(session.addEdge("W", "OnlyOne1"));
+            BOOST_CHECK_EQUAL(session.solve().size(), 2);
+            BOOST_TEST(session.isConsistent());
+
+            // names already taken or unknown change nothing
+            BOOST_TEST(!session.addVariable("V0", Domain({1})));
+            BOOST_TEST(!session.addConstraint("Unknown", ConstraintVertex::exactlyN(1, 1), { "Nobody" }));
+            BOOST_TEST(!session.addEdge("Nobody", "OnlyOne1"));
+            BOOST_CHECK_EQUAL(session.solve().size(), 2);
+        }
+
+        BOOST_AUTO_TEST_CASE(empty_domain_is_inconsistent) {
+            CSPSession session = CSPSession(makeSessionPermutations(2));
+            BOOST_TEST(!session.addVariable("Empty", Domain()));
+            BOOST_TEST(!session.isConsistent());
+            BOOST_TEST(session.solve().empty());
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+    // searches every answer left from the current fixpoint, as many as the solve mode asks for
+    // std::vector<std::vector<VariableVertex>> solve(); size_t solve(CSPSolver::SolutionVisitor visitor);
+    BOOST_AUTO_TEST_SUITE(solve);
+
+        BOOST_AUTO_TEST_CASE(matches_arc_consistency_and_leaves_session_as_is) {
+            // setup: a session & a solver using the same settings, in every search mode
+            for (CSPSolver::SearchMode search_mode : { CSPSolver::CopyMode, CSPSolver::TrailMode, CSPSolver::ParallelMode })
+            {
+                CSPSolver settings = CSPSolver(search_mode);
+                settings.setThreadCount(2);
+                CSPSession session = CSPSession(makeSessionPermutations(4), settings);
+                BOOST_TEST(session.removeFromDomain("V0", 1));
+                CSPGraph graph = makeSessionPermutations(4);
+                graph.get_variable("V0")->removeFromDomain(1);
+
+                // test: answers come in the same order as from arcConsistency
+                auto expected = settings.arcConsistency(graph);
+                auto actual = session.solve();
+                BOOST_REQUIRE_EQUAL(actual.size(), expected.size());
+                for (size_t i = 0; i < expected.size(); i++)
+                    BOOST_CHECK_EQUAL_COLLECTIONS(actual[i].begin(), actual[i].end(), expected[i].begin(), expected[i].end());
+                BOOST_TEST(session.getSolveRevisionCount() > 0);
+                // solving again finds the same answers, the fixpoint being untouched
+                BOOST_CHECK_EQUAL(session.solve().size(), 18);
+            }
+        }
+
+        BOOST_AUTO_TEST_CASE(visitor_and_solve_mode) {
+            // setup: stop at the first answer
+            CSPSolver settings;
+            settings.setSolveMode(CSPSolver::FirstSolutionMode);
+            CSPSession session = CSPSession(makeSessionPermutations(4), settings);
+
+            // test: a single answer is visited
+            size_t visited = 0;
+            BOOST_CHECK_EQUAL(session.solve([&visited](const CSPSolverImplementation::AssignmentView& answer)
+            {
+                visited++;
+                BOOST_CHECK_EQUAL(answer.size(), 4);
+                return CSPSolver::KeepSearching;
+            }), 1);
+            BOOST_CHECK_EQUAL(visited, 1);
+        }
+
+        BOOST_AUTO_TEST_CASE(components_are_searched_one_at_a_time) {
+            // setup: two permutation problems side by side, of 3! answers each, and a fact on one of them
+            CSPGraph graph = makeSessionPermutations(3);
+            for (int val = 1; val <= 3; val++) graph.add_constraint("Other" + std::to_string(val), ConstraintVertex::exactlyN(val, 1));
+            for (int var = 0; var < 3; var++)
+            {
+                std::string vv_name = "W" + std::to_string(var);
+                graph.add_variable(vv_name, {1, 2, 3});
+                for (int val = 1; val <= 3; val++) graph.add_edge(vv_name, "Other" + std::to_string(val));
+            }
+            CSPSolver settings;
+            settings.setDecompositionMode(CSPSolver::ComponentMode);
+            CSPSession session = CSPSession(graph, settings);
+            BOOST_TEST(session.removeFromDomain("W0", 1));
+
+            // test: the answers are the product of the 6 & 4 answers of each problem
+            auto answers = session.solve();
+            BOOST_CHECK_EQUAL(answers.size(), 6 * 4);
+            for (auto& answer : answers) BOOST_TEST(!answer[3].domainContains(1));
+        }
+
+        BOOST_AUTO_TEST_CASE(solving_again_after_a_fact_reuses_cached_states) {
+            // setup: solve with a transposition cache, then rule out V0 being 1
+            CSPSolver settings;
+            settings.setTranspositionCacheSize(100);
+            CSPSession session = CSPSession(makeSessionPermutations(4), settings);
+            BOOST_CHECK_EQUAL(session.solve().size(), 24);
+            BOOST_TEST(session.removeFromDomain("V0", 1));
+
+            // test: the branches on V0 being 2, 3 or 4 were searched by the first solve already
+            size_t solve_revisions = session.getSolveRevisionCount();
+            BOOST_CHECK_EQUAL(session.solve().size(), 18);
+            // the session searches with copies of settings, sharing its cache
+            BOOST_CHECK_GE(settings.getCacheHitCount(), 3);
+            BOOST_CHECK_LT(session.getSolveRevisionCount(), solve_revisions);
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -6,9 +6,12 @@
 #include <boost/test/unit_test.hpp>
 
 #include <algorithm>
+#include <cstdio>
+#include <filesystem>
 #include <set>
 #include <string>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include "src/cspSolver/frontier/Frontier.h"
@@ -53,6 +56,16 @@ namespace _unit_test_befriender
             solver.getAllCheckAgainArcs(frontier, graph, arc);
         }
 
+        static uint32_t pickSplitVariable(CSPSolver& solver, const CSPGraph& graph)
+        {
+            return solver.pickSplitVariable(graph);
+        }
+
+        static std::vector<size_t>& constraintWeights(CSPSolver& solver)
+        {
+            return solver.constraint_weights;
+        }
+
         static bool compareCSPGraphBasedOnVariablesAndConstraintNames(CSPGraph& graph1, CSPGraph& graph2) 
         {
             // given we can't reliably compare constraint predicates, check: 
@@ -152,24 +165,878 @@ BOOST_FIXTURE_TEST_SUITE(CSPSolver_test_suite, TestCSPSolver_Fixture, * boost::u
 
     BOOST_AUTO_TEST_SUITE_END();
 
-    // save a created CSP graph
-    // void saveCspGraph(GraphImplementation::Graph graph, std::string saveDir);
-    BOOST_AUTO_TEST_SUITE(saveCspGraph);
+    // save a created CSP graph to a binary file / load a CSP graph saved with saveCspGraph
+    // bool saveCspGraph(const CSPGraph& graph, std::string savePath);
+    // CSPGraph loadCspGraph(std::string loadPath);
+    BOOST_AUTO_TEST_SUITE(saveCspGraph_and_loadCspGraph);
+
+        BOOST_AUTO_TEST_CASE(loaded_graph_has_the_same_answers) {
+            // setup: connect every square to every constraint, then save the graph
+            // (the format itself is tested in testCSPGraphSerializer.cpp)
+            for (std::string vv_name : cspg.get_all_variable_names())
+                for (std::string cv_name : cspg.get_all_constraint_names()) cspg.add_edge(vv_name, cv_name);
+            for (int i = 1; i <= 7; i++) cspg.get_variable("Square " + std::to_string(i))->restrictDomainTo(i);
+            std::string path = (std::filesystem::temp_directory_path() / "testCSPSolver.gcsp").string();
+            BOOST_REQUIRE(solver.saveCspGraph(cspg, path));
+
+            // test: solving the loaded graph gives the same two answers
+            CSPGraph loaded = solver.loadCspGraph(path);
+            std::remove(path.c_str());
+            auto expected = solver.arcConsistency(cspg);
+            auto actual = solver.arcConsistency(loaded);
+            BOOST_REQUIRE_EQUAL(expected.size(), 2);
+            BOOST_REQUIRE_EQUAL(actual.size(), 2);
+            for (size_t i = 0; i < expected.size(); i++)
+                BOOST_CHECK_EQUAL_COLLECTIONS(expected[i].begin(), expected[i].end(), actual[i].begin(), actual[i].end());
+        }
+
+        BOOST_AUTO_TEST_CASE(missing_file_loads_an_empty_graph) {
+            CSPGraph loaded = solver.loadCspGraph("this/file/does/not/exist.gcsp");
+            BOOST_TEST(loaded.get_all_variable_names().empty());
+            BOOST_TEST(loaded.get_all_constraint_names().empty());
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+    // how branches are explored after splitting a domain
+    // void setSearchMode(SearchMode search_mode);
+    BOOST_AUTO_TEST_SUITE(setSearchMode);
+
+        BOOST_AUTO_TEST_CASE(copy_and_trail_modes_find_the_same_answers) {
+            // setup: create a problem with several answers - any permutation of 1, 2, 3
+            CSPGraph permutations = CSPGraph();
+            for (int val : {1, 2, 3})
+                permutations.add_constraint("OnlyOne" + std::to_string(val), ConstraintVertex::exactlyN(val, 1));
+            for (std::string vv_name : {"A", "B", "C"})
+            {
+                permutations.add_variable(vv_name, {1, 2, 3});
+                for (int val : {1, 2, 3}) permutations.add_edge(vv_name, "OnlyOne" + std::to_string(val));
+            }
+
+            // test: both search modes return the 6 answers, in the same order
+            CSPSolver copy_solver = CSPSolver(CSPSolver::CopyMode);
+            CSPSolver trail_solver = CSPSolver(CSPSolver::TrailMode);
+            BOOST_REQUIRE_EQUAL(copy_solver.getSearchMode(), CSPSolver::CopyMode);
+            auto copy_answers = copy_solver.arcConsistency(permutations);
+            auto trail_answers = trail_solver.arcConsistency(permutations);
+            BOOST_REQUIRE_EQUAL(copy_answers.size(), 6);
+            BOOST_REQUIRE_EQUAL(trail_answers.size(), 6);
+            for (size_t i = 0; i < copy_answers.size(); i++)
+                BOOST_CHECK_EQUAL_COLLECTIONS(copy_answers[i].begin(), copy_answers[i].end(),
+                                              trail_answers[i].begin(), trail_answers[i].end());
+            // both modes do the same work
+            BOOST_CHECK_GT(trail_solver.getRevisionCount(), 0);
+            BOOST_CHECK_EQUAL(copy_solver.getRevisionCount(), trail_solver.getRevisionCount());
+            // the graph passed in is left untouched
+            BOOST_CHECK_EQUAL(permutations.get_variable("A")->getDomainSize(), 3);
+        }
+
+        BOOST_AUTO_TEST_CASE(parallel_mode_merges_answers_in_branch_order) {
+            // setup: create a problem with several answers - any permutation of 1, 2, 3, 4
+            CSPGraph permutations = CSPGraph();
+            for (int val : {1, 2, 3, 4})
+                permutations.add_constraint("OnlyOne" + std::to_string(val), ConstraintVertex::exactlyN(val, 1));
+            for (std::string vv_name : {"A", "B", "C", "D"})
+            {
+                permutations.add_variable(vv_name, {1, 2, 3, 4});
+                for (int val : {1, 2, 3, 4}) permutations.add_edge(vv_name, "OnlyOne" + std::to_string(val));
+            }
+
+            // test: parallel search returns the 24 answers in the same order as a sequential search
+            CSPSolver sequential_solver = CSPSolver(CSPSolver::TrailMode);
+            CSPSolver parallel_solver = CSPSolver(CSPSolver::ParallelMode);
+            parallel_solver.setThreadCount(4);
+            parallel_solver.setSpawnCutoffDepth(2);
+            BOOST_REQUIRE_EQUAL(parallel_solver.getThreadCount(), 4);
+            BOOST_REQUIRE_EQUAL(parallel_solver.getSpawnCutoffDepth(), 2);
+            auto sequential_answers = sequential_solver.arcConsistency(permutations);
+            auto parallel_answers = parallel_solver.arcConsistency(permutations);
+            BOOST_REQUIRE_EQUAL(sequential_answers.size(), 24);
+            BOOST_REQUIRE_EQUAL(parallel_answers.size(), 24);
+            for (size_t i = 0; i < sequential_answers.size(); i++)
+                BOOST_CHECK_EQUAL_COLLECTIONS(sequential_answers[i].begin(), sequential_answers[i].end(),
+                                              parallel_answers[i].begin(), parallel_answers[i].end());
+            // revisions made by every worker add up to those of the sequential search
+            BOOST_CHECK_EQUAL(sequential_solver.getRevisionCount(), parallel_solver.getRevisionCount());
+        }
+
+        BOOST_AUTO_TEST_CASE(single_valued_domains_are_checked_before_being_an_answer) {
+            // setup: every variable already has a single value, which breaks the only constraint
+            CSPGraph broken = CSPGraph();
+            broken.add_constraint("OnlyOne2", ConstraintVertex::exactlyN(2, 1));
+            for (std::string vv_name : {"A", "B"})
+            {
+                broken.add_variable(vv_name, {1});
+                broken.add_edge(vv_name, "OnlyOne2");
+            }
+
+            // test: no search mode returns it as an answer
+            for (CSPSolver::SearchMode mode : {CSPSolver::CopyMode, CSPSolver::TrailMode, CSPSolver::ParallelMode})
+            {
+                CSPSolver mode_solver = CSPSolver(mode);
+                BOOST_CHECK(mode_solver.arcConsistency(broken).empty());
+                BOOST_CHECK(mode_solver.depthFirstSearchWithPruning(broken).empty());
+            }
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+    // which answers a search looks for
+    // void setSolveMode(SolveMode solve_mode); void setSolutionLimit(size_t solution_limit);
+    BOOST_AUTO_TEST_SUITE(setSolveMode);
+
+        BOOST_AUTO_TEST_CASE(first_and_limited_answers_match_the_full_enumeration) {
+            // setup: create a problem with several answers - any permutation of 1, 2, 3, 4
+            CSPGraph permutations = CSPGraph();
+            for (int val : {1, 2, 3, 4})
+                permutations.add_constraint("OnlyOne" + std::to_string(val), ConstraintVertex::exactlyN(val, 1));
+            for (std::string vv_name : {"A", "B", "C", "D"})
+            {
+                permutations.add_variable(vv_name, {1, 2, 3, 4});
+                for (int val : {1, 2, 3, 4}) permutations.add_edge(vv_name, "OnlyOne" + std::to_string(val));
+            }
+            auto all_answers = CSPSolver().arcConsistency(permutations);
+            BOOST_REQUIRE_EQUAL(all_answers.size(), 24);
+
+            // test: in every search mode & for both engines, limited searches return the first answers found
+            for (CSPSolver::SearchMode mode : {CSPSolver::CopyMode, CSPSolver::TrailMode, CSPSolver::ParallelMode})
+            {
+                CSPSolver mode_solver = CSPSolver(mode);
+                mode_solver.setThreadCount(4);
+                mode_solver.setSolveMode(CSPSolver::FirstSolutionMode);
+                BOOST_REQUIRE_EQUAL(mode_solver.getSolveMode(), CSPSolver::FirstSolutionMode);
+                auto first = mode_solver.arcConsistency(permutations);
+                BOOST_REQUIRE_EQUAL(first.size(), 1);
+                BOOST_CHECK_EQUAL_COLLECTIONS(first[0].begin(), first[0].end(), 
+                                              all_answers[0].begin(), all_answers[0].end());
+                BOOST_CHECK_EQUAL(mode_solver.getSolutionCount(), 1);
+
+                mode_solver.setSolveMode(CSPSolver::SolutionLimitMode);
+                mode_solver.setSolutionLimit(5);
+                BOOST_REQUIRE_EQUAL(mode_solver.getSolutionLimit(), 5);
+                auto limited = mode_solver.arcConsistency(permutations);
+                BOOST_REQUIRE_EQUAL(limited.size(), 5);
+                for (size_t i = 0; i < limited.size(); i++)
+                    BOOST_CHECK_EQUAL_COLLECTIONS(limited[i].begin(), limited[i].end(), 
+                                                  all_answers[i].begin(), all_answers[i].end());
+            }
+            CSPSolver dfs_solver = CSPSolver();
+            dfs_solver.setSolveMode(CSPSolver::SolutionLimitMode);
+            dfs_solver.setSolutionLimit(3);
+            BOOST_CHECK_EQUAL(dfs_solver.depthFirstSearchWithPruning(permutations).size(), 3);
+            // a limit of 0 looks for nothing at all
+            dfs_solver.setSolutionLimit(0);
+            BOOST_CHECK(dfs_solver.arcConsistency(permutations).empty());
+            BOOST_CHECK_EQUAL(dfs_solver.getRevisionCount(), 0);
+        }
+
+        BOOST_AUTO_TEST_CASE(count_only_counts_without_returning_answers) {
+            // setup: create a problem with several answers - any permutation of 1, 2, 3, 4
+            CSPGraph permutations = CSPGraph();
+            for (int val : {1, 2, 3, 4})
+                permutations.add_constraint("OnlyOne" + std::to_string(val), ConstraintVertex::exactlyN(val, 1));
+            for (std::string vv_name : {"A", "B", "C", "D"})
+            {
+                permutations.add_variable(vv_name, {1, 2, 3, 4});
+                for (int val : {1, 2, 3, 4}) permutations.add_edge(vv_name, "OnlyOne" + std::to_string(val));
+            }
+
+            // test: every engine & search mode counts the 24 answers, returning none of them
+            for (CSPSolver::SearchMode mode : {CSPSolver::CopyMode, CSPSolver::TrailMode, CSPSolver::ParallelMode})
+            {
+                CSPSolver mode_solver = CSPSolver(mode);
+                mode_solver.setThreadCount(4);
+                mode_solver.setSolveMode(CSPSolver::CountOnlyMode);
+                BOOST_CHECK(mode_solver.arcConsistency(permutations).empty());
+                BOOST_CHECK_EQUAL(mode_solver.getSolutionCount(), 24);
+                BOOST_CHECK(mode_solver.depthFirstSearchWithPruning(permutations).empty());
+                BOOST_CHECK_EQUAL(mode_solver.getSolutionCount(), 24);
+                // visitors aren't called either
+                size_t visited = 0;
+                size_t counted = mode_solver.arcConsistency(permutations, [&visited] (const AssignmentView&)
+                {
+                    visited++;
+                    return CSPSolver::KeepSearching;
+                });
+                BOOST_CHECK_EQUAL(counted, 24);
+                BOOST_CHECK_EQUAL(visited, 0);
+            }
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+    // how arc consistency decides which arcs to revise again after a domain was reduced
+    // void setPropagationMode(PropagationMode propagation_mode);
+    BOOST_AUTO_TEST_SUITE(setPropagationMode);
+
+        BOOST_AUTO_TEST_CASE(residue_mode_finds_the_same_answers_with_fewer_revisions) {
+            // setup: a Latin square of size 4, where each value appears once per row & column,
+            // plus a custom predicate forbidding value 1 in the first cell, which is always revised
+            CSPGraph latin = CSPGraph();
+            for (int line = 0; line < 4; line++)
+                for (int val : {1, 2, 3, 4})
+                {
+                    latin.add_constraint("Row" + std::to_string(line) + "Has" + std::to_string(val), 
+                                         ConstraintVertex::exactlyN(val, 1));
+                    latin.add_constraint("Col" + std::to_string(line) + "Has" + std::to_string(val), 
+                                         ConstraintVertex::exactlyN(val, 1));
+                }
+            latin.add_constraint("Not1", [] (int val, std::vector<VariableVertex*> others) { return val != 1; });
+            for (int row = 0; row < 4; row++)
+                for (int col = 0; col < 4; col++)
+                {
+                    std::string vv_name = "Cell" + std::to_string(row) + std::to_string(col);
+                    latin.add_variable(vv_name, {1, 2, 3, 4});
+                    for (int val : {1, 2, 3, 4})
+                    {
+                        latin.add_edge(vv_name, "Row" + std::to_string(row) + "Has" + std::to_string(val));
+                        latin.add_edge(vv_name, "Col" + std::to_string(col) + "Has" + std::to_string(val));
+                    }
+                }
+            latin.add_edge("Cell00", "Not1");
+
+            // test: both propagation modes return the same answers in the same order,
+            // residue mode making fewer revisions to get there
+            CSPSolver ac3_solver = CSPSolver();
+            CSPSolver residue_solver = CSPSolver();
+            residue_solver.setPropagationMode(CSPSolver::ResidueMode);
+            BOOST_REQUIRE_EQUAL(ac3_solver.getPropagationMode(), CSPSolver::AC3Mode);
+            BOOST_REQUIRE_EQUAL(residue_solver.getPropagationMode(), CSPSolver::ResidueMode);
+            auto ac3_answers = ac3_solver.arcConsistency(latin);
+            auto residue_answers = residue_solver.arcConsistency(latin);
+            // 576 Latin squares of size 4, a quarter of which have 1 in the first cell
+            BOOST_REQUIRE_EQUAL(ac3_answers.size(), 432);
+            BOOST_REQUIRE_EQUAL(residue_answers.size(), 432);
+            for (size_t i = 0; i < ac3_answers.size(); i++)
+                BOOST_CHECK_EQUAL_COLLECTIONS(ac3_answers[i].begin(), ac3_answers[i].end(),
+                                              residue_answers[i].begin(), residue_answers[i].end());
+            BOOST_CHECK_LT(residue_solver.getRevisionCount(), ac3_solver.getRevisionCount());
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+    // which variable arc consistency splits the domain of once propagation stalls
+    // void setBranchingHeuristic(BranchingHeuristic branching_heuristic);
+    BOOST_AUTO_TEST_SUITE(setBranchingHeuristic);
+
+        BOOST_AUTO_TEST_CASE(each_heuristic_picks_its_variable) {
+            // setup: A has 3 values & 1 constraint, B 2 values & 1 constraint, C 3 values & 3 constraints,
+            // D a single value & 3 constraints, which is never picked
+            CSPGraph graph = CSPGraph();
+            for (std::string cv_name : {"C1", "C2", "C3"}) graph.add_constraint(cv_name, ConstraintVertex::exactlyN(1, 1));
+            graph.add_variable("A", {1, 2, 3});
+            graph.add_variable("B", {1, 2});
+            graph.add_variable("C", {1, 2, 3});
+            graph.add_variable("D", {1});
+            graph.add_edge("A", "C1");
+            graph.add_edge("B", "C2");
+            for (std::string cv_name : {"C1", "C2", "C3"})
+            {
+                graph.add_edge("C", cv_name);
+                graph.add_edge("D", cv_name);
+            }
+            graph.freeze();
+
+            // test: ids are given in the order variables were added - A is 0, B 1, C 2
+            BOOST_REQUIRE_EQUAL(solver.getBranchingHeuristic(), CSPSolver::InputOrder);
+            BOOST_CHECK_EQUAL(_unit_test_befriender::TestBefriender::pickSplitVariable(solver, graph), 0);
+            solver.setBranchingHeuristic(CSPSolver::SmallestDomain);
+            BOOST_CHECK_EQUAL(_unit_test_befriender::TestBefriender::pickSplitVariable(solver, graph), 1);
+            solver.setBranchingHeuristic(CSPSolver::LargestDegree);
+            BOOST_CHECK_EQUAL(_unit_test_befriender::TestBefriender::pickSplitVariable(solver, graph), 2);
+            solver.setBranchingHeuristic(CSPSolver::DomainOverDegree);
+            BOOST_CHECK_EQUAL(_unit_test_befriender::TestBefriender::pickSplitVariable(solver, graph), 2);
+            // without any failure, weighted degrees are degrees
+            solver.setBranchingHeuristic(CSPSolver::DomainOverWeightedDegree);
+            BOOST_CHECK_EQUAL(_unit_test_befriender::TestBefriender::pickSplitVariable(solver, graph), 2);
+            // once C2 caused failures, B with 2 values over a weight of 6 comes before C with 3 over 8
+            std::vector<size_t>& weights = _unit_test_befriender::TestBefriender::constraintWeights(solver);
+            weights.assign(graph.num_constraints(), 0);
+            weights[graph.get_constraint("C2")->getId()] = 5;
+            BOOST_CHECK_EQUAL(_unit_test_befriender::TestBefriender::pickSplitVariable(solver, graph), 1);
+        }
+
+        BOOST_AUTO_TEST_CASE(every_heuristic_finds_the_same_answers) {
+            // setup: a Latin square of size 4, where each value appears once per row & column
+            CSPGraph latin = CSPGraph();
+            for (int line = 0; line < 4; line++)
+                for (int val : {1, 2, 3, 4})
+                {
+                    latin.add_constraint("Row" + std::to_string(line) + "Has" + std::to_string(val), 
+                                         ConstraintVertex::exactlyN(val, 1));
+                    latin.add_constraint("Col" + std::to_string(line) + "Has" + std::to_string(val), 
+                                         ConstraintVertex::exactlyN(val, 1));
+                }
+            for (int row = 0; row < 4; row++)
+                for (int col = 0; col < 4; col++)
+                {
+                    std::string vv_name = "Cell" + std::to_string(row) + std::to_string(col);
+                    latin.add_variable(vv_name, {1, 2, 3, 4});
+                    for (int val : {1, 2, 3, 4})
+                    {
+                        latin.add_edge(vv_name, "Row" + std::to_string(row) + "Has" + std::to_string(val));
+                        latin.add_edge(vv_name, "Col" + std::to_string(col) + "Has" + std::to_string(val));
+                    }
+                }
+            // fixing the first row & the first cell of the second row leaves fewer answers
+            latin.get_variable("Cell00")->restrictDomainTo(1);
+            latin.get_variable("Cell01")->restrictDomainTo(2);
+            latin.get_variable("Cell02")->restrictDomainTo(3);
+            latin.get_variable("Cell03")->restrictDomainTo(4);
+            latin.get_variable("Cell10")->restrictDomainTo(2);
+
+            // test: every heuristic finds the same answers, whatever their order
+            auto to_values = [] (const std::vector<VariableVertex>& answer)
+            {
+                std::vector<int> values;
+                for (const VariableVertex& vv : answer) values.push_back(vv.getDomainStore().min());
+                return values;
+            };
+            std::set<std::vector<int>> expected_values;
+            for (auto& answer : CSPSolver().arcConsistency(latin)) expected_values.insert(to_values(answer));
+            BOOST_REQUIRE_GT(expected_values.size(), 1);
+            for (CSPSolver::BranchingHeuristic heuristic : {CSPSolver::SmallestDomain, CSPSolver::LargestDegree,
+                                                            CSPSolver::DomainOverDegree, CSPSolver::DomainOverWeightedDegree})
+            {
+                CSPSolver heuristic_solver = CSPSolver();
+                heuristic_solver.setBranchingHeuristic(heuristic);
+                std::set<std::vector<int>> actual_values;
+                for (auto& answer : heuristic_solver.arcConsistency(latin)) actual_values.insert(to_values(answer));
+                BOOST_TEST(actual_values == expected_values);
+            }
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+    // how arc consistency goes back up once every value of a split variable was explored
+    // void setBacktrackMode(BacktrackMode backtrack_mode); void setNogoodLimit(size_t nogood_limit);
+    BOOST_AUTO_TEST_SUITE(setBacktrackMode);
+
+        BOOST_AUTO_TEST_CASE(backjumping_skips_branchings_unrelated_to_the_failure) {
+            // setup: A, B & C are free, and come before P, Q & R which can't each take 1 or 2 exactly once
+            // (no single constraint tells, so every choice of A, B & C ends up splitting P)
+            CSPGraph graph = CSPGraph();
+            for (std::string vv_name : {"A", "B", "C", "P", "Q", "R"}) graph.add_variable(vv_name, {1, 2});
+            for (int val : {1, 2})
+            {
+                graph.add_constraint("OnlyOne" + std::to_string(val), ConstraintVertex::exactlyN(val, 1));
+                for (std::string vv_name : {"P", "Q", "R"}) graph.add_edge(vv_name, "OnlyOne" + std::to_string(val));
+            }
+
+            // test: the failure of P doesn't depend on A, B nor C, whose second values are skipped
+            for (CSPSolver::SearchMode search_mode : { CSPSolver::CopyMode, CSPSolver::TrailMode })
+            {
+                CSPSolver chronological = CSPSolver(search_mode);
+                BOOST_TEST(chronological.arcConsistency(graph).empty());
+                BOOST_CHECK_EQUAL(chronological.getSkippedNodeCount(), 0);
+                CSPSolver backjumping = CSPSolver(search_mode);
+                backjumping.setBacktrackMode(CSPSolver::BackjumpingMode);
+                BOOST_TEST(backjumping.arcConsistency(graph).empty());
+                BOOST_CHECK_EQUAL(backjumping.getSkippedNodeCount(), 3);
+                BOOST_CHECK_LT(backjumping.getRevisionCount(), chronological.getRevisionCount());
+            }
+        }
+
+        BOOST_AUTO_TEST_CASE(learned_nogoods_rule_out_failures_in_other_branches) {
+            // setup: P, Q & R take 1, 2 & 3 at most once each, A being 3 or not; once A is 3, they can't
+            // all be different anymore, which shows only after splitting P; X & B are free, X coming first
+            CSPGraph graph = CSPGraph();
+            graph.add_variable("X", {1, 2});
+            graph.add_variable("A", {1, 3});
+            graph.add_variable("B", {1, 2});
+            for (std::string vv_name : {"P", "Q", "R"}) graph.add_variable(vv_name, {1, 2, 3});
+            for (int val : {1, 2, 3})
+            {
+                graph.add_constraint("AtMostOne" + std::to_string(val), ConstraintVertex::lesserOrEqualToN(val, 1));
+                for (std::string vv_name : {"P", "Q", "R"}) graph.add_edge(vv_name, "AtMostOne" + std::to_string(val));
+            }
+            graph.add_edge("A", "AtMostOne3");
+
+            // test: the same answers come in the same order; once X = 1 taught that A can't be 3,
+            // X = 2 rules it out right away, skipping B's values in between the first time
+            CSPSolver chronological = CSPSolver();
+            auto expected = chronological.arcConsistency(graph);
+            BOOST_REQUIRE_EQUAL(expected.size(), 24);
+            for (CSPSolver::SearchMode search_mode : { CSPSolver::CopyMode, CSPSolver::TrailMode, CSPSolver::ParallelMode })
+            {
+                CSPSolver backjumping = CSPSolver(search_mode);
+                backjumping.setBacktrackMode(CSPSolver::BackjumpingMode);
+                backjumping.setSpawnCutoffDepth(1);
+                backjumping.setThreadCount(2);
+                auto actual = backjumping.arcConsistency(graph);
+                BOOST_REQUIRE_EQUAL(actual.size(), expected.size());
+                for (size_t i = 0; i < expected.size(); i++)
+                    BOOST_CHECK_EQUAL_COLLECTIONS(actual[i].begin(), actual[i].end(), expected[i].begin(), expected[i].end());
+                BOOST_TEST(backjumping.getLearnedNogoodCount() >= 1);
+                BOOST_TEST(backjumping.getSkippedNodeCount() >= 1);
+                // branches of X run as separate tasks in ParallelMode, which learn on their own
+                if (search_mode != CSPSolver::ParallelMode) 
+                    BOOST_CHECK_LT(backjumping.getRevisionCount(), chronological.getRevisionCount());
+            }
+            // without keeping any nogood, backjumping alone still skips B's values
+            CSPSolver without_nogoods = CSPSolver();
+            without_nogoods.setBacktrackMode(CSPSolver::BackjumpingMode);
+            without_nogoods.setNogoodLimit(0);
+            BOOST_CHECK_EQUAL(without_nogoods.arcConsistency(graph).size(), 24);
+            BOOST_CHECK_EQUAL(without_nogoods.getLearnedNogoodCount(), 0);
+            BOOST_CHECK_EQUAL(without_nogoods.getSkippedNodeCount(), 2);
+        }
+
+        BOOST_AUTO_TEST_CASE(backjumping_finds_the_same_answers) {
+            // setup: a Latin square of size 4 with a custom predicate forbidding 1 in the first cell,
+            // fused into global cardinality constraints or not
+            CSPGraph latin = CSPGraph();
+            for (int line = 0; line < 4; line++)
+                for (int val : {1, 2, 3, 4})
+                {
+                    latin.add_constraint("Row" + std::to_string(line) + "Has" + std::to_string(val), 
+                                         ConstraintVertex::exactlyN(val, 1));
+                    latin.add_constraint("Col" + std::to_string(line) + "Has" + std::to_string(val), 
+                                         ConstraintVertex::exactlyN(val, 1));
+                }
+            latin.add_constraint("Not1", [] (int val, std::vector<VariableVertex*> others) { return val != 1; });
+            for (int row = 0; row < 4; row++)
+                for (int col = 0; col < 4; col++)
+                {
+                    std::string vv_name = "Cell" + std::to_string(row) + std::to_string(col);
+                    latin.add_variable(vv_name, {1, 2, 3, 4});
+                    for (int val : {1, 2, 3, 4})
+                    {
+                        latin.add_edge(vv_name, "Row" + std::to_string(row) + "Has" + std::to_string(val));
+                        latin.add_edge(vv_name, "Col" + std::to_string(col) + "Has" + std::to_string(val));
+                    }
+                }
+            latin.add_edge("Cell00", "Not1");
+            CSPGraph fused_latin = latin;
+            fused_latin.fuse_cardinality_constraints();
+
+            // test: every propagation mode & heuristic gives the answers of chronological backtracking
+            CSPSolver chronological = CSPSolver();
+            auto expected = chronological.arcConsistency(latin);
+            BOOST_REQUIRE_EQUAL(expected.size(), 432);
+            for (CSPGraph* graph : {&latin, &fused_latin})
+                for (CSPSolver::BranchingHeuristic heuristic : { CSPSolver::InputOrder, CSPSolver::DomainOverWeightedDegree })
+                    for (CSPSolver::PropagationMode propagation_mode : { CSPSolver::AC3Mode, CSPSolver::ResidueMode })
+                    {
+                        CSPSolver backjumping = CSPSolver();
+                        backjumping.setBacktrackMode(CSPSolver::BackjumpingMode);
+                        backjumping.setBranchingHeuristic(heuristic);
+                        backjumping.setPropagationMode(propagation_mode);
+                        auto actual = backjumping.arcConsistency(*graph);
+                        BOOST_REQUIRE_EQUAL(actual.size(), expected.size());
+                        if (heuristic != CSPSolver::InputOrder) continue;
+                        for (size_t i = 0; i < expected.size(); i++)
+                            BOOST_CHECK_EQUAL_COLLECTIONS(actual[i].begin(), actual[i].end(), 
+                                                          expected[i].begin(), expected[i].end());
+                    }
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+    // how arc consistency deals with interchangeable variables & values
+    // void setSymmetryMode(SymmetryMode symmetry_mode);
+    BOOST_AUTO_TEST_SUITE(setSymmetryMode);
+
+        BOOST_AUTO_TEST_CASE(interchangeable_crew_members_give_a_single_answer) {
+            // setup: among A, B, C & D, exactly one is Gnosia (1) and exactly one is an engineer (2)
+            CSPGraph graph = CSPGraph();
+            for (std::string vv_name : {"A", "B", "C", "D"}) graph.add_variable(vv_name, {1, 2, 3});
+            graph.add_constraint("OneGnosia", ConstraintVertex::exactlyN(1, 1));
+            graph.add_constraint("OneEngineer", ConstraintVertex::exactlyN(2, 1));
+            for (std::string vv_name : {"A", "B", "C", "D"})
+            {
+                graph.add_edge(vv_name, "OneGnosia");
+                graph.add_edge(vv_name, "OneEngineer");
+            }
+
+            // test: the 12 answers are all symmetric, leaving A = 1, B = 2 & the others 3
+            CSPSolver every_answer = CSPSolver();
+            BOOST_CHECK_EQUAL(every_answer.arcConsistency(graph).size(), 12);
+            BOOST_CHECK_EQUAL(every_answer.getExpandedSolutionCount(), 12);
+            for (CSPSolver::SymmetryMode symmetry_mode : { CSPSolver::LexLeaderMode, CSPSolver::CanonicalMode })
+            {
+                CSPSolver breaking = CSPSolver();
+                breaking.setSymmetryMode(symmetry_mode);
+                auto answers = breaking.arcConsistency(graph);
+                BOOST_REQUIRE_EQUAL(answers.size(), 1);
+                std::vector<int> values;
+                for (VariableVertex& vv : answers[0]) values.push_back(vv.getDomainStore().min());
+                BOOST_TEST(values == std::vector<int>({1, 2, 3, 3}));
+                BOOST_CHECK_LT(breaking.getRevisionCount(), every_answer.getRevisionCount());
+                // only canonical answers stand for the others
+                size_t multiplicity = (symmetry_mode == CSPSolver::CanonicalMode) ? 12 : 1;
+                BOOST_TEST(breaking.getMultiplicities() == std::vector<size_t>({multiplicity}));
+                BOOST_CHECK_EQUAL(breaking.getExpandedSolutionCount(), multiplicity);
+            }
+        }
+
+        BOOST_AUTO_TEST_CASE(canonical_answers_leave_out_symmetric_answers_lex_leader_keeps) {
+            // setup: X, Y & Z are free to take 1, 2 or 3
+            CSPGraph graph = CSPGraph();
+            for (std::string vv_name : {"X", "Y", "Z"}) graph.add_variable(vv_name, {1, 2, 3});
+
+            // test: lex-leader keeps 111, 112, 122 & 123, of which 112 & 122 are symmetric
+            CSPSolver lex_leader = CSPSolver();
+            lex_leader.setSymmetryMode(CSPSolver::LexLeaderMode);
+            BOOST_CHECK_EQUAL(lex_leader.arcConsistency(graph).size(), 4);
+            // canonical answers stand for the 3, 18 & 6 answers where all three, two or none are the same
+            CSPSolver canonical = CSPSolver();
+            canonical.setSymmetryMode(CSPSolver::CanonicalMode);
+            BOOST_CHECK_EQUAL(canonical.arcConsistency(graph).size(), 3);
+            BOOST_TEST(canonical.getMultiplicities() == std::vector<size_t>({3, 18, 6}));
+            BOOST_CHECK_EQUAL(canonical.getExpandedSolutionCount(), 27);
+            // visitors are handed the same multiplicities
+            std::vector<size_t> visited;
+            canonical.arcConsistency(graph, [&visited](const AssignmentView& answer)
+            {
+                visited.push_back(answer.multiplicity());
+                return CSPSolver::KeepSearching;
+            });
+            BOOST_TEST(visited == std::vector<size_t>({3, 18, 6}));
+            // depth first search ignores symmetries
+            BOOST_CHECK_EQUAL(canonical.depthFirstSearchWithPruning(graph).size(), 27);
+        }
+
+        BOOST_AUTO_TEST_CASE(canonical_answers_stand_for_every_answer_in_every_mode) {
+            // setup: 7 players with two Gnosia (1), an engineer (2), a doctor (3) & crew (4); the first one 
+            // claims not to be Gnosia, which only a custom predicate tells, & the doctor & engineer are told 
+            // apart from the rest, but not from each other, by a global cardinality constraint
+            CSPGraph graph = CSPGraph();
+            std::vector<std::string> players = {"P0", "P1", "P2", "P3", "P4", "P5", "P6"};
+            for (const std::string& player : players) graph.add_variable(player, {1, 2, 3, 4});
+            graph.add_constraint("TwoGnosia", ConstraintVertex::exactlyN(1, 2));
+            graph.add_constraint("Roles", ConstraintVertex::globalCardinality({ {2, 1, 1}, {3, 1, 1} }));
+            for (const std::string& player : players)
+            {
+                graph.add_edge(player, "TwoGnosia");
+                graph.add_edge(player, "Roles");
+            }
+            graph.add_constraint("P0Claim", [] (int val, std::vector<VariableVertex*> others) { return val != 1; });
+            graph.add_edge("P0", "P0Claim");
+            CSPSolver every_answer = CSPSolver();
+            // the Gnosia among the 6 others, then the engineer & doctor among the 5 left
+            BOOST_REQUIRE_EQUAL(every_answer.arcConsistency(graph).size(), 15 * 5 * 4);
+            // 4 free variables of 3 values, both being interchangeable
+            CSPGraph free_graph = CSPGraph();
+            for (std::string vv_name : {"W", "X", "Y", "Z"}) free_graph.add_variable(vv_name, {1, 2, 3});
+
+            // test: whatever the mode, canonical answers stand for every answer exactly
+            for (auto [searched, expected] : { std::make_pair(&graph, 300), std::make_pair(&free_graph, 81) })
+                for (CSPSolver::SearchMode search_mode : { CSPSolver::CopyMode, CSPSolver::TrailMode, CSPSolver::ParallelMode })
+                    for (CSPSolver::SolveMode solve_mode : { CSPSolver::AllSolutionsMode, CSPSolver::CountOnlyMode })
+                        for (CSPSolver::BacktrackMode backtrack_mode : { CSPSolver::ChronologicalMode, CSPSolver::BackjumpingMode })
+                        {
+                            CSPSolver canonical = CSPSolver(search_mode);
+                            canonical.setSymmetryMode(CSPSolver::CanonicalMode);
+                            canonical.setSolveMode(solve_mode);
+                            canonical.setBacktrackMode(backtrack_mode);
+                            canonical.setSpawnCutoffDepth(2);
+                            canonical.setThreadCount(2);
+                            canonical.arcConsistency(*searched);
+                            BOOST_CHECK_EQUAL(canonical.getExpandedSolutionCount(), expected);
+                            BOOST_CHECK_LT(canonical.getSolutionCount(), expected);
+                        }
+            // the 4 free variables take 1 value, 2 values in two ways (3-1 & 2-2), or 3 values 
+            CSPSolver canonical = CSPSolver(CSPSolver::ParallelMode);
+            canonical.setSymmetryMode(CSPSolver::CanonicalMode);
+            canonical.setSpawnCutoffDepth(2);
+            BOOST_CHECK_EQUAL(canonical.arcConsistency(free_graph).size(), 4);
+        }
+
+        BOOST_AUTO_TEST_CASE(interchangeable_variables_and_values_are_all_counted) {
+            // setup: a Latin square of size 3, its cells & values being the only symmetries found,
+            // & a free pair of variables next to it, interchangeable with each other & of their own values
+            CSPGraph graph = CSPGraph();
+            for (int line = 0; line < 3; line++)
+            {
+                graph.add_constraint("Row" + std::to_string(line), ConstraintVertex::allDifferent());
+                graph.add_constraint("Col" + std::to_string(line), ConstraintVertex::allDifferent());
+            }
+            for (int row = 0; row < 3; row++)
+                for (int col = 0; col < 3; col++)
+                {
+                    std::string vv_name = "Cell" + std::to_string(row) + std::to_string(col);
+                    graph.add_variable(vv_name, {1, 2, 3});
+                    graph.add_edge(vv_name, "Row" + std::to_string(row));
+                    graph.add_edge(vv_name, "Col" + std::to_string(col));
+                }
+            graph.add_variable("Free0", {7, 8});
+            graph.add_variable("Free1", {7, 8});
+            CSPSolver every_answer = CSPSolver();
+            BOOST_REQUIRE_EQUAL(every_answer.arcConsistency(graph).size(), 12 * 4);
+
+            // test: values 1, 2 & 3 being interchangeable leaves 2 Latin squares, each standing for 6,
+            // and the free pair gives 2 answers, each standing for 2
+            CSPSolver canonical = CSPSolver();
+            canonical.setSymmetryMode(CSPSolver::CanonicalMode);
+            BOOST_CHECK_EQUAL(canonical.arcConsistency(graph).size(), 2 * 2);
+            BOOST_TEST(canonical.getMultiplicities() == std::vector<size_t>({12, 12, 12, 12}));
+            BOOST_CHECK_EQUAL(canonical.getExpandedSolutionCount(), 12 * 4);
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+    // maximum number of propagated states arc consistency keeps the answers found below of
+    // void setTranspositionCacheSize(size_t cache_size);
+    BOOST_AUTO_TEST_SUITE(setTranspositionCacheSize);
+
+        BOOST_AUTO_TEST_CASE(searching_again_replays_cached_answers_in_every_mode) {
+            // setup: 4 variables taking 1 to 4 once each, hence 24 answers
+            CSPGraph graph = CSPGraph();
+            for (int val = 1; val <= 4; val++)
+                graph.add_constraint("OnlyOne" + std::to_string(val), ConstraintVertex::exactlyN(val, 1));
+            for (std::string vv_name : {"A", "B", "C", "D"})
+            {
+                graph.add_variable(vv_name, {1, 2, 3, 4});
+                for (int val = 1; val <= 4; val++) graph.add_edge(vv_name, "OnlyOne" + std::to_string(val));
+            }
+
+            // test: the second search reports the same answers in the same order, revising less
+            for (CSPSolver::SearchMode search_mode : { CSPSolver::CopyMode, CSPSolver::TrailMode, CSPSolver::ParallelMode })
+                for (CSPSolver::SolveMode solve_mode : { CSPSolver::AllSolutionsMode, CSPSolver::FirstSolutionMode, CSPSolver::CountOnlyMode })
+                {
+                    CSPSolver uncached = CSPSolver(search_mode);
+                    uncached.setSolveMode(solve_mode);
+                    auto expected = uncached.arcConsistency(graph);
+                    CSPSolver cached = uncached;
+                    cached.setTranspositionCacheSize(100);
+                    cached.setSpawnCutoffDepth(2);
+                    cached.setThreadCount(2);
+                    cached.arcConsistency(graph);
+                    size_t first_revisions = cached.getRevisionCount();
+                    BOOST_CHECK_EQUAL(cached.getCacheHitCount(), 0);
+                    auto actual = cached.arcConsistency(graph);
+                    BOOST_REQUIRE_EQUAL(actual.size(), expected.size());
+                    for (size_t i = 0; i < expected.size(); i++)
+                        BOOST_CHECK_EQUAL_COLLECTIONS(actual[i].begin(), actual[i].end(), expected[i].begin(), expected[i].end());
+                    BOOST_CHECK_EQUAL(cached.getSolutionCount(), uncached.getSolutionCount());
+                    // the first answer being found without any failure, no state was searched to its end
+                    if (solve_mode == CSPSolver::FirstSolutionMode) continue;
+                    BOOST_CHECK_GT(cached.getCacheHitCount(), 0);
+                    BOOST_CHECK_LT(cached.getRevisionCount(), first_revisions);
+                }
+        }
+
+        BOOST_AUTO_TEST_CASE(copies_share_the_cache_which_tells_graphs_apart) {
+            // setup: X & Y take 1 to 3, X not being 1, & a copy of a caching solver
+            CSPGraph graph = CSPGraph();
+            graph.add_variable("X", {1, 2, 3});
+            graph.add_variable("Y", {1, 2, 3});
+            graph.add_constraint("XNot", ConstraintVertex::exactlyN(1, 0));
+            graph.add_edge("X", "XNot");
+            CSPSolver cached = CSPSolver();
+            cached.setTranspositionCacheSize(100);
+            CSPSolver copy = cached;
+            BOOST_CHECK_EQUAL(cached.arcConsistency(graph).size(), 6);
+
+            // test 1: the copy finds the states searched by the original
+            BOOST_CHECK_EQUAL(copy.arcConsistency(graph).size(), 6);
+            BOOST_CHECK_GT(copy.getCacheHitCount(), 0);
+            // test 2: the same constraint counting another value is told apart, & so is a constraint added
+            CSPGraph other = CSPGraph();
+            other.add_variable("X", {1, 2, 3});
+            other.add_variable("Y", {1, 2, 3});
+            other.add_constraint("XNot", ConstraintVertex::exactlyN(2, 0));
+            other.add_edge("X", "XNot");
+            auto answers = copy.arcConsistency(other);
+            BOOST_REQUIRE_EQUAL(answers.size(), 6);
+            for (auto& answer : answers) BOOST_TEST(!answer[0].domainContains(2));
+            graph.add_constraint("AtMostOne3", ConstraintVertex::lesserOrEqualToN(3, 1));
+            graph.add_edge("X", "AtMostOne3");
+            graph.add_edge("Y", "AtMostOne3");
+            BOOST_CHECK_EQUAL(copy.arcConsistency(graph).size(), 5);
+            // test 3: a cache too small forgets states, answers being found all the same
+            copy.clearTranspositionCache();
+            copy.setTranspositionCacheSize(1);
+            BOOST_CHECK_EQUAL(copy.arcConsistency(graph).size(), 5);
+            BOOST_CHECK_GT(copy.getCacheEvictionCount(), 0);
+            BOOST_CHECK_EQUAL(cached.getTranspositionCacheSize(), 1);
+        }
+
+        BOOST_AUTO_TEST_CASE(graphs_holding_custom_predicates_are_never_cached) {
+            // setup: two graphs alike but for a custom predicate of the same name & default description,
+            // ruling out 1 for X in one & 2 in the other
+            auto make_graph = [](int ruled_out)
+            {
+                CSPGraph returned = CSPGraph();
+                returned.add_variable("X", {1, 2, 3});
+                returned.add_variable("Y", {1, 2, 3});
+                returned.add_constraint("XNot", [ruled_out] (int val, std::vector<VariableVertex*> others) 
+                { 
+                    return val != ruled_out; 
+                });
+                returned.add_edge("X", "XNot");
+                return returned;
+            };
+            CSPSolver cached = CSPSolver();
+            cached.setTranspositionCacheSize(100);
+            BOOST_CHECK_EQUAL(cached.arcConsistency(make_graph(1)).size(), 6);
+
+            // test: the second graph gets its own answers, the cache being left untouched
+            auto answers = cached.arcConsistency(make_graph(2));
+            BOOST_REQUIRE_EQUAL(answers.size(), 6);
+            for (auto& answer : answers) BOOST_TEST(!answer[0].domainContains(2));
+            BOOST_CHECK_EQUAL(cached.getCacheHitCount() + cached.getCacheMissCount(), 0);
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+    // whether arc consistency splits the graph into its connected components first
+    // void setDecompositionMode(DecompositionMode decomposition_mode);
+    BOOST_AUTO_TEST_SUITE(setDecompositionMode);
+
+        BOOST_AUTO_TEST_CASE(components_combine_into_the_same_answers_in_every_mode) {
+            // setup: two villages of 3 players with one Gnosia (1), one engineer (2) & one crew member (3)
+            // each, and a free player who may be 7 or 8, hence 6 * 6 * 2 answers
+            CSPGraph graph = CSPGraph();
+            for (std::string village : {"North", "South"})
+            {
+                for (int val = 1; val <= 3; val++)
+                    graph.add_constraint(village + std::to_string(val), ConstraintVertex::exactlyN(val, 1));
+                for (int player = 0; player < 3; player++)
+                {
+                    std::string vv_name = village + "Player" + std::to_string(player);
+                    graph.add_variable(vv_name, {1, 2, 3});
+                    for (int val = 1; val <= 3; val++) graph.add_edge(vv_name, village + std::to_string(val));
+                }
+            }
+            graph.add_variable("Free", {7, 8});
+            auto values_of = [](const std::vector<std::vector<VariableVertex>>& answers)
+            {
+                std::set<std::vector<int>> returned;
+                for (const std::vector<VariableVertex>& answer : answers)
+                {
+                    std::vector<int> values;
+                    for (const VariableVertex& vv : answer) values.push_back(vv.getDomainStore().min());
+                    returned.insert(values);
+                }
+                return returned;
+            };
+            CSPSolver whole = CSPSolver();
+            std::set<std::vector<int>> expected = values_of(whole.arcConsistency(graph));
+            BOOST_REQUIRE_EQUAL(expected.size(), 72);
+
+            // test: whatever the mode, the components give the same answers, with fewer revisions
+            for (CSPSolver::SearchMode search_mode : { CSPSolver::CopyMode, CSPSolver::TrailMode, CSPSolver::ParallelMode })
+                for (CSPSolver::SolveMode solve_mode : { CSPSolver::AllSolutionsMode, CSPSolver::SolutionLimitMode, CSPSolver::CountOnlyMode })
+                {
+                    CSPSolver decomposing = CSPSolver(search_mode);
+                    decomposing.setDecompositionMode(CSPSolver::ComponentMode);
+                    decomposing.setSolveMode(solve_mode);
+                    decomposing.setSolutionLimit(10);
+                    decomposing.setThreadCount(2);
+                    auto answers = decomposing.arcConsistency(graph);
+                    BOOST_CHECK_EQUAL(decomposing.getComponentCount(), 3);
+                    BOOST_CHECK_LT(decomposing.getRevisionCount(), whole.getRevisionCount());
+                    std::set<std::vector<int>> actual = values_of(answers);
+                    BOOST_TEST(std::includes(expected.begin(), expected.end(), actual.begin(), actual.end()));
+                    size_t expected_count = (solve_mode == CSPSolver::SolutionLimitMode) ? 10 : 72;
+                    BOOST_CHECK_EQUAL(decomposing.getSolutionCount(), expected_count);
+                    BOOST_CHECK_EQUAL(answers.size(), (solve_mode == CSPSolver::CountOnlyMode) ? 0 : expected_count);
+                    BOOST_CHECK_EQUAL(actual.size(), answers.size());
+                }
+        }
 
-        BOOST_AUTO_TEST_CASE(not_implemented_yet) {
-            // *not implemented yet; have to find a way to serialize 
-            // constraints first, and I don't think we need that yet
+        BOOST_AUTO_TEST_CASE(a_component_without_answers_leaves_none_and_symmetries_multiply) {
+            // setup: 3 free variables of 2 values, and a village where 2 players can't both be Gnosia
+            CSPGraph graph = CSPGraph();
+            for (std::string vv_name : {"X", "Y", "Z"}) graph.add_variable(vv_name, {1, 2});
+            CSPSolver decomposing = CSPSolver();
+            decomposing.setDecompositionMode(CSPSolver::ComponentMode);
+            decomposing.setSymmetryMode(CSPSolver::CanonicalMode);
+
+            // test 1: each free variable is a component whose 2 values are interchangeable, hence a single 
+            // answer standing for all 8
+            BOOST_CHECK_EQUAL(decomposing.arcConsistency(graph).size(), 1);
+            BOOST_TEST(decomposing.getMultiplicities() == std::vector<size_t>({8}));
+            BOOST_CHECK_EQUAL(decomposing.getExpandedSolutionCount(), 8);
+            // test 2: a component without answers leaves none, even when only counting
+            graph.add_variable("P0", {1});
+            graph.add_variable("P1", {1});
+            graph.add_constraint("AtMostOneGnosia", ConstraintVertex::lesserOrEqualToN(1, 1));
+            graph.add_edge("P0", "AtMostOneGnosia");
+            graph.add_edge("P1", "AtMostOneGnosia");
+            BOOST_CHECK_EQUAL(decomposing.arcConsistency(graph).size(), 0);
+            decomposing.setSolveMode(CSPSolver::CountOnlyMode);
+            decomposing.arcConsistency(graph);
+            BOOST_CHECK_EQUAL(decomposing.getSolutionCount(), 0);
+            BOOST_CHECK_EQUAL(decomposing.getComponentCount(), 4);
+            // depth first search always searches the whole graph
+            decomposing.depthFirstSearchWithPruning(graph);
+            BOOST_CHECK_EQUAL(decomposing.getComponentCount(), 1);
         }
 
     BOOST_AUTO_TEST_SUITE_END();
 
-    // load a CSP graph
-    // void loadCspGraph(std::string loadDir);
-    BOOST_AUTO_TEST_SUITE(loadCspGraph);
+    // run arc consistency, handing each answer to visitor as soon as it is found
+    // size_t arcConsistency(CSPGraph graph, SolutionVisitor visitor, ...);
+    BOOST_AUTO_TEST_SUITE(arcConsistency_with_visitor);
 
-        BOOST_AUTO_TEST_CASE(not_implemented_yet) {
-            // *not implemented yet; have to find a way to serialize 
-            // constraints first, and I don't think we need that yet
+        BOOST_AUTO_TEST_CASE(visitor_sees_the_same_answers_as_the_returned_vector) {
+            // setup: create a problem with several answers - any permutation of 1, 2, 3
+            CSPGraph permutations = CSPGraph();
+            for (int val : {1, 2, 3})
+                permutations.add_constraint("OnlyOne" + std::to_string(val), ConstraintVertex::exactlyN(val, 1));
+            for (std::string vv_name : {"A", "B", "C"})
+            {
+                permutations.add_variable(vv_name, {1, 2, 3});
+                for (int val : {1, 2, 3}) permutations.add_edge(vv_name, "OnlyOne" + std::to_string(val));
+            }
+
+            // test: every answer is visited in the order it is returned, with names & values by variable id
+            auto answers = solver.arcConsistency(permutations);
+            std::vector<std::vector<int>> visited_values;
+            size_t visited = solver.arcConsistency(permutations, [&] (const AssignmentView& answer)
+            {
+                BOOST_REQUIRE_EQUAL(answer.size(), 3);
+                BOOST_CHECK_EQUAL(answer.nameAt(0), "A");
+                BOOST_CHECK_EQUAL(answer.nameAt(2), "C");
+                std::vector<int> values;
+                for (uint32_t vv_id = 0; vv_id < answer.size(); vv_id++) values.push_back(answer.valueAt(vv_id));
+                visited_values.push_back(values);
+                return CSPSolver::KeepSearching;
+            });
+            BOOST_CHECK_EQUAL(visited, 6);
+            BOOST_REQUIRE_EQUAL(visited_values.size(), answers.size());
+            for (size_t i = 0; i < answers.size(); i++)
+                for (size_t vv_id = 0; vv_id < answers[i].size(); vv_id++)
+                    BOOST_CHECK_EQUAL(visited_values[i][vv_id], answers[i][vv_id].getDomainStore().min());
+        }
+
+        BOOST_AUTO_TEST_CASE(visitor_can_stop_the_search) {
+            // setup: create a problem with several answers - any permutation of 1, 2, 3, 4
+            CSPGraph permutations = CSPGraph();
+            for (int val : {1, 2, 3, 4})
+                permutations.add_constraint("OnlyOne" + std::to_string(val), ConstraintVertex::exactlyN(val, 1));
+            for (std::string vv_name : {"A", "B", "C", "D"})
+            {
+                permutations.add_variable(vv_name, {1, 2, 3, 4});
+                for (int val : {1, 2, 3, 4}) permutations.add_edge(vv_name, "OnlyOne" + std::to_string(val));
+            }
+            auto answers = CSPSolver().arcConsistency(permutations);
+            BOOST_REQUIRE_EQUAL(answers.size(), 24);
+
+            // test: in every search mode, the search ends with the first answer, which is the first returned one
+            for (CSPSolver::SearchMode mode : {CSPSolver::CopyMode, CSPSolver::TrailMode, CSPSolver::ParallelMode})
+            {
+                CSPSolver mode_solver = CSPSolver(mode);
+                mode_solver.setThreadCount(4);
+                std::vector<VariableVertex> first_answer;
+                size_t visited = mode_solver.arcConsistency(permutations, [&] (const AssignmentView& answer)
+                {
+                    first_answer = answer.toVariables();
+                    return CSPSolver::StopSearching;
+                });
+                BOOST_CHECK_EQUAL(visited, 1);
+                BOOST_CHECK_EQUAL_COLLECTIONS(first_answer.begin(), first_answer.end(),
+                                              answers[0].begin(), answers[0].end());
+            }
+            // stopping early saves work in sequential modes
+            CSPSolver stopped_solver = CSPSolver(CSPSolver::TrailMode);
+            stopped_solver.arcConsistency(permutations, [] (const AssignmentView&) { return CSPSolver::StopSearching; });
+            CSPSolver full_solver = CSPSolver(CSPSolver::TrailMode);
+            full_solver.arcConsistency(permutations);
+            BOOST_CHECK_LT(stopped_solver.getRevisionCount(), full_solver.getRevisionCount());
         }
 
     BOOST_AUTO_TEST_SUITE_END();
@@ -181,7 +1048,102 @@ BOOST_FIXTURE_TEST_SUITE(CSPSolver_test_suite, TestCSPSolver_Fixture, * boost::u
     // run DFS with pruning and return all possible answers
     // std::vector<std::vector<GraphImplementation::VariableVertex>> depthFirstSearchWithPruning(CSPGraph graph);
     BOOST_AUTO_TEST_SUITE(depthFirstSearchWithPruning);
-    // implement another time?
+
+        BOOST_AUTO_TEST_CASE(finds_the_same_answers_as_arc_consistency) {
+            // setup: create a problem with several answers - any permutation of 1, 2, 3
+            CSPGraph permutations = CSPGraph();
+            for (int val : {1, 2, 3})
+                permutations.add_constraint("OnlyOne" + std::to_string(val), ConstraintVertex::exactlyN(val, 1));
+            for (std::string vv_name : {"A", "B", "C"})
+            {
+                permutations.add_variable(vv_name, {1, 2, 3});
+                for (int val : {1, 2, 3}) permutations.add_edge(vv_name, "OnlyOne" + std::to_string(val));
+            }
+            // fixing a value leaves 2 answers: B = 1 with A, C being 2, 3 in any order
+            permutations.get_variable("B")->restrictDomainTo(1);
+
+            // test: both engines return the same answers, in the same format
+            // (the order of answers may differ, as variables are picked by minimum remaining values)
+            auto dfs_answers = solver.depthFirstSearchWithPruning(permutations);
+            auto ac_answers = solver.arcConsistency(permutations);
+            BOOST_REQUIRE_EQUAL(dfs_answers.size(), 2);
+            BOOST_REQUIRE_EQUAL(ac_answers.size(), 2);
+            auto to_values = [] (const std::vector<VariableVertex>& answer)
+            {
+                std::vector<int> values;
+                for (const VariableVertex& vv : answer) 
+                {
+                    BOOST_REQUIRE_EQUAL(vv.getDomainSize(), 1);
+                    values.push_back(vv.getDomainStore().min());
+                }
+                return values;
+            };
+            std::set<std::vector<int>> dfs_values, ac_values;
+            for (auto& answer : dfs_answers) dfs_values.insert(to_values(answer));
+            for (auto& answer : ac_answers) ac_values.insert(to_values(answer));
+            BOOST_TEST(dfs_values == ac_values);
+            BOOST_TEST(dfs_values.count(std::vector<int>{2, 1, 3}) == 1);
+            BOOST_TEST(dfs_values.count(std::vector<int>{3, 1, 2}) == 1);
+            // variables are returned in the order they were added
+            BOOST_CHECK_EQUAL(dfs_answers[0][0].getName(), "A");
+            // the graph passed in is left untouched
+            BOOST_CHECK_EQUAL(permutations.get_variable("A")->getDomainSize(), 3);
+        }
+
+        BOOST_AUTO_TEST_CASE(no_answer) {
+            // setup: three variables can't hold exactly one of each of three values with two values only
+            CSPGraph pigeons = CSPGraph();
+            for (int val : {1, 2, 3})
+                pigeons.add_constraint("OnlyOne" + std::to_string(val), ConstraintVertex::exactlyN(val, 1));
+            for (std::string vv_name : {"A", "B", "C"})
+            {
+                pigeons.add_variable(vv_name, {1, 2});
+                for (int val : {1, 2, 3}) pigeons.add_edge(vv_name, "OnlyOne" + std::to_string(val));
+            }
+
+            // test: no answer is returned
+            BOOST_TEST(solver.depthFirstSearchWithPruning(pigeons).empty());
+        }
+
+        BOOST_AUTO_TEST_CASE(unary_constraint_is_checked) {
+            // setup: a single variable whose only constraint rules out one of its two values
+            CSPGraph unary = CSPGraph();
+            unary.add_constraint("Not1", [] (int val, std::vector<VariableVertex*> others) { return val != 1; });
+            unary.add_variable("A", {1, 2});
+            unary.add_edge("A", "Not1");
+
+            // test: only the value allowed by the constraint is returned
+            auto answers = solver.depthFirstSearchWithPruning(unary);
+            BOOST_REQUIRE_EQUAL(answers.size(), 1);
+            BOOST_REQUIRE_EQUAL(answers[0].size(), 1);
+            BOOST_CHECK_EQUAL(answers[0][0], VariableVertex("A", {2}));
+        }
+
+        BOOST_AUTO_TEST_CASE(visitor_can_stop_the_search) {
+            // setup: create a problem with several answers - any permutation of 1, 2, 3
+            CSPGraph permutations = CSPGraph();
+            for (int val : {1, 2, 3})
+                permutations.add_constraint("OnlyOne" + std::to_string(val), ConstraintVertex::exactlyN(val, 1));
+            for (std::string vv_name : {"A", "B", "C"})
+            {
+                permutations.add_variable(vv_name, {1, 2, 3});
+                for (int val : {1, 2, 3}) permutations.add_edge(vv_name, "OnlyOne" + std::to_string(val));
+            }
+
+            // test: counting visits every answer, stopping at the second one visits two
+            size_t counted = solver.depthFirstSearchWithPruning(permutations, 
+                [] (const AssignmentView&) { return CSPSolver::KeepSearching; });
+            BOOST_CHECK_EQUAL(counted, 6);
+            size_t seen = 0;
+            size_t visited = solver.depthFirstSearchWithPruning(permutations, [&seen] (const AssignmentView&)
+            {
+                seen++;
+                return (seen == 2) ? CSPSolver::StopSearching : CSPSolver::KeepSearching;
+            });
+            BOOST_CHECK_EQUAL(visited, 2);
+            BOOST_CHECK_EQUAL(seen, 2);
+        }
+
     BOOST_AUTO_TEST_SUITE_END();
 
 
@@ -1261,6 +2223,17 @@ struct TestCSPSolver_ArcConsistency_Fixture
     ~TestCSPSolver_ArcConsistency_Fixture()
     {};
 
+    // fixes the squares of sudoku_graph given as 81 characters read row by row, 'x' being left open
+    void fill_sudoku(const std::string& grid)
+    {
+        for (int i = 0; i < 81; i++)
+        {
+            if (grid[i] == 'x') continue;
+            std::string vv_name = "Square " + std::to_string(i / 9 + 1) + "-" + std::to_string(i % 9 + 1);
+            sudoku_graph.get_variable(vv_name)->restrictDomainTo(grid[i] - '0');
+        }
+    };
+
     void print_sudoku(CSPGraph& graph)
     {
         std::vector<VariableVertex*> non_unique_domains;
@@ -1656,6 +2629,56 @@ BOOST_FIXTURE_TEST_SUITE(CSPSolver_test_suite_ArcConsistency,
                                             actual_answer.begin(),   actual_answer.end());
         }
 
+        BOOST_AUTO_TEST_CASE(every_frontier_mode_finds_the_same_answer) {
+            // setup: create the puzzle of real_use_case_hard_version
+            fill_sudoku("xxxx6753x" "5xx92x1xx" "x4xxxxx7x"
+                        "xxxxx92xx" "x1473xxxx" "7x9xxxx1x"
+                        "x3xxxxx26" "425x71x89" "6x7283x51");
+            std::string expected_grid = "982167534" "573924168" "146358972"
+                                        "368519247" "214736895" "759842613"
+                                        "831495726" "425671389" "697283451";
+
+            auto check_single_answer = [&expected_grid] (std::vector<std::vector<VariableVertex>> answers)
+            {
+                BOOST_REQUIRE_EQUAL(answers.size(), 1);
+                for (VariableVertex& vv : answers[0])
+                {
+                    // "Square r-c"
+                    int row = vv.getName()[7] - '0';
+                    int col = vv.getName()[9] - '0';
+                    BOOST_REQUIRE_EQUAL(vv.getDomainSize(), 1);
+                    BOOST_CHECK_EQUAL(*vv.getDomain().begin(), expected_grid[(row - 1) * 9 + col - 1] - '0');
+                }
+            };
+
+            // test: every mode & heuristic only changes the order in which arcs are checked
+            check_single_answer(solver.arcConsistency(sudoku_graph, Frontier::QueueMode));
+            for (auto heuristic : {Frontier::SmallestDomainFirst, Frontier::LowestArityFirst, 
+                                   Frontier::MostRecentlyTightenedFirst})
+                check_single_answer(solver.arcConsistency(sudoku_graph, Frontier::PriorityQueueMode, heuristic));
+            // as well as with a custom comparator, here checking constraints by name
+            check_single_answer(solver.arcConsistency(sudoku_graph, Frontier(
+                [] (const ARC& arc1, const ARC& arc2) 
+                { 
+                    return arc1.constraint->getName() < arc2.constraint->getName(); 
+                })));
+        }
+
+        BOOST_AUTO_TEST_CASE(depth_first_search_finds_the_same_answer) {
+            // setup: create the puzzle of real_use_case_hard_version
+            fill_sudoku("xxxx6753x" "5xx92x1xx" "x4xxxxx7x"
+                        "xxxxx92xx" "x1473xxxx" "7x9xxxx1x"
+                        "x3xxxxx26" "425x71x89" "6x7283x51");
+
+            // test: DFS with forward checking returns the single answer of arc consistency
+            auto ac_answers = solver.arcConsistency(sudoku_graph);
+            auto dfs_answers = solver.depthFirstSearchWithPruning(sudoku_graph);
+            BOOST_REQUIRE_EQUAL(ac_answers.size(), 1);
+            BOOST_REQUIRE_EQUAL(dfs_answers.size(), 1);
+            BOOST_CHECK_EQUAL_COLLECTIONS(ac_answers[0].begin(), ac_answers[0].end(),
+                                          dfs_answers[0].begin(), dfs_answers[0].end());
+        }
+
         BOOST_AUTO_TEST_CASE(real_use_case_hard_version) {
 
             // setup: create a sudoku puzzle with the following initialization.
@@ -1852,6 +2875,123 @@ BOOST_FIXTURE_TEST_SUITE(CSPSolver_test_suite_ArcConsistency,
                                             actual_answer.begin(),   actual_answer.end());
         }
 
+        BOOST_AUTO_TEST_CASE(global_cardinality_makes_pigeonhole_deductions) {
+            // setup: a row of four cells, each value once, the first two cells only allowing 1 & 2;
+            // once as one exactlyN constraint per value, once fused into a global cardinality constraint
+            CSPGraph row = CSPGraph();
+            row.add_variable("A", {1, 2});
+            row.add_variable("B", {1, 2});
+            row.add_variable("C", {1, 2, 3, 4});
+            row.add_variable("D", {1, 2, 3, 4});
+            for (int val : {1, 2, 3, 4}) 
+            {
+                row.add_constraint("Has" + std::to_string(val), ConstraintVertex::exactlyN(val, 1));
+                for (auto vv_name : {"A", "B", "C", "D"}) row.add_edge(vv_name, "Has" + std::to_string(val));
+            }
+            CSPGraph fused_row = row;
+            BOOST_REQUIRE_EQUAL(fused_row.fuse_cardinality_constraints(), 1);
+
+            // test: propagation alone tells C & D are 3 or 4 once fused, which exactlyN constraints can't see
+            CSPSolver solver = CSPSolver();
+            for (CSPGraph* graph : {&row, &fused_row})
+            {
+                graph->freeze();
+                Frontier frontier = Frontier(Frontier::QueueMode);
+                _unit_test_befriender::TestBefriender::getAllToDoArcs(solver, *graph, frontier);
+                while (!frontier.empty()) 
+                    _unit_test_befriender::TestBefriender::singleArcConsistencyStep(solver, *graph, frontier);
+            }
+            BOOST_CHECK_EQUAL(row.get_variable("C")->getDomainSize(), 4);
+            BOOST_TEST(fused_row.get_variable("C")->getDomain() == std::set<int>({3, 4}));
+            BOOST_TEST(fused_row.get_variable("D")->getDomain() == std::set<int>({3, 4}));
+        }
+
+        BOOST_AUTO_TEST_CASE(all_different_finds_the_same_answer) {
+            // setup: the puzzle of real_use_case_hard_version, once with 243 exactlyN constraints,
+            // once with an alldifferent constraint per row, column & square
+            fill_sudoku("xxxx6753x" "5xx92x1xx" "x4xxxxx7x"
+                        "xxxxx92xx" "x1473xxxx" "7x9xxxx1x"
+                        "x3xxxxx26" "425x71x89" "6x7283x51");
+            CSPGraph all_different = CSPGraph();
+            for (std::string vv_name : sudoku_graph.get_all_variable_names())
+                all_different.add_variable(vv_name, sudoku_graph.get_variable(vv_name)->getDomain());
+            for (int pos_num = 1; pos_num < 10; pos_num++)
+                for (std::string type : {"row", "col", "squ"})
+                {
+                    // the variables of OnlyOne1 are those of every other value
+                    std::string cv_name = "AllDifferent-" + type + "-" + std::to_string(pos_num);
+                    all_different.add_constraint(cv_name, ConstraintVertex::allDifferent());
+                    for (VariableVertex* vv : sudoku_graph.get_variable_neighbors("OnlyOne1-" + type + "-" + std::to_string(pos_num)))
+                        all_different.add_edge(vv->getName(), cv_name);
+                }
+
+            // test: both give the same single answer, alldifferent constraints needing fewer revisions
+            auto expected = solver.arcConsistency(sudoku_graph);
+            size_t exactly_n_revisions = solver.getRevisionCount();
+            for (CSPSolver::PropagationMode propagation_mode : { CSPSolver::AC3Mode, CSPSolver::ResidueMode })
+            {
+                CSPSolver all_different_solver = CSPSolver();
+                all_different_solver.setPropagationMode(propagation_mode);
+                auto actual = all_different_solver.arcConsistency(all_different);
+                BOOST_REQUIRE_EQUAL(actual.size(), 1);
+                BOOST_REQUIRE_EQUAL(expected.size(), 1);
+                BOOST_CHECK_EQUAL_COLLECTIONS(actual[0].begin(), actual[0].end(), expected[0].begin(), expected[0].end());
+                BOOST_CHECK_LT(all_different_solver.getRevisionCount(), exactly_n_revisions);
+            }
+            BOOST_CHECK_EQUAL(solver.depthFirstSearchWithPruning(all_different).size(), 1);
+            // which fusing leaves as they are
+            BOOST_CHECK_EQUAL(all_different.fuse_cardinality_constraints(), 0);
+        }
+
+        BOOST_AUTO_TEST_CASE(fused_constraints_find_the_same_answers) {
+            // setup: a Latin square of size 4 with a custom predicate forbidding 1 in the first cell,
+            // and the same square once the constraints of each row & column are fused
+            CSPGraph latin = CSPGraph();
+            for (int line = 0; line < 4; line++)
+                for (int val : {1, 2, 3, 4})
+                {
+                    latin.add_constraint("Row" + std::to_string(line) + "Has" + std::to_string(val), 
+                                         ConstraintVertex::exactlyN(val, 1));
+                    latin.add_constraint("Col" + std::to_string(line) + "Has" + std::to_string(val), 
+                                         ConstraintVertex::exactlyN(val, 1));
+                }
+            latin.add_constraint("Not1", [] (int val, std::vector<VariableVertex*> others) { return val != 1; });
+            for (int row = 0; row < 4; row++)
+                for (int col = 0; col < 4; col++)
+                {
+                    std::string vv_name = "Cell" + std::to_string(row) + std::to_string(col);
+                    latin.add_variable(vv_name, {1, 2, 3, 4});
+                    for (int val : {1, 2, 3, 4})
+                    {
+                        latin.add_edge(vv_name, "Row" + std::to_string(row) + "Has" + std::to_string(val));
+                        latin.add_edge(vv_name, "Col" + std::to_string(col) + "Has" + std::to_string(val));
+                    }
+                }
+            latin.add_edge("Cell00", "Not1");
+            CSPGraph fused_latin = latin;
+            BOOST_REQUIRE_EQUAL(fused_latin.fuse_cardinality_constraints(), 8);
+
+            // test: every search mode & DFS return the same answers in the same order,
+            // with fewer revisions once fused
+            CSPSolver solver = CSPSolver();
+            auto expected = solver.arcConsistency(latin);
+            size_t unfused_revisions = solver.getRevisionCount();
+            BOOST_REQUIRE_EQUAL(expected.size(), 432);
+            for (CSPSolver::SearchMode search_mode : { CSPSolver::CopyMode, CSPSolver::TrailMode, CSPSolver::ParallelMode })
+            {
+                CSPSolver fused_solver = CSPSolver(search_mode);
+                fused_solver.setThreadCount(2);
+                auto actual = fused_solver.arcConsistency(fused_latin);
+                BOOST_REQUIRE_EQUAL(actual.size(), expected.size());
+                for (size_t i = 0; i < expected.size(); i++)
+                    BOOST_CHECK_EQUAL_COLLECTIONS(actual[i].begin(), actual[i].end(), expected[i].begin(), expected[i].end());
+                if (search_mode != CSPSolver::ParallelMode) BOOST_CHECK_LT(fused_solver.getRevisionCount(), unfused_revisions);
+            }
+            BOOST_CHECK_EQUAL(solver.depthFirstSearchWithPruning(fused_latin).size(), 432);
+            solver.setPropagationMode(CSPSolver::ResidueMode);
+            BOOST_CHECK_EQUAL(solver.arcConsistency(fused_latin).size(), 432);
+        }
+
     BOOST_AUTO_TEST_SUITE_END();
 
 BOOST_AUTO_TEST_SUITE_END();
\ No newline at end of file
@@ -0,0 +1,183 @@
+// Author: Akira Kudo
+// Description: Implements tests for the Trail class under CSPSolverImplementation.
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <set>
+
+#include "src/cspSolver/trail/Trail.h"
+#include "src/graphImplementation/vertices/VariableVertex.h"
+
+// define fixture
+struct TestTrail_Fixture
+{
+    CSPSolverImplementation::Trail trail;
+
+    GraphImplementation::VariableVertex vv1 = GraphImplementation::VariableVertex("vv1", {1, 2, 3});
+    GraphImplementation::VariableVertex vv2 = GraphImplementation::VariableVertex("vv2", {4, 5, 6});
+
+    TestTrail_Fixture() {};
+    ~TestTrail_Fixture() {};
+};
+
+BOOST_FIXTURE_TEST_SUITE(Trail_test_suite, TestTrail_Fixture, * boost::unit_test::label("Trail"));
+
+    // removes val from the domain of vv, recording the removal if a choice point is open
+    // bool removeFromDomain(GraphImplementation::VariableVertex* vv, int val);
+    BOOST_AUTO_TEST_SUITE(removeFromDomain);
+
+        BOOST_AUTO_TEST_CASE(outside_of_choice_point_is_not_recorded) {
+            // setup: remove a value with no choice point open
+            BOOST_TEST(trail.removeFromDomain(&vv1, 2));
+
+            // test: the value is gone, but nothing was recorded
+            BOOST_TEST(!vv1.domainContains(2));
+            BOOST_CHECK_EQUAL(trail.size(), 0);
+        };
+
+        BOOST_AUTO_TEST_CASE(inside_of_choice_point_is_recorded) {
+            // setup: open a choice point, then remove values
+            trail.markChoicePoint();
+            BOOST_TEST(trail.removeFromDomain(&vv1, 2));
+            // removing a value which isn't there records nothing
+            BOOST_TEST(!trail.removeFromDomain(&vv1, 2));
+
+            // test: check exactly one removal was recorded
+            BOOST_CHECK_EQUAL(trail.size(), 1);
+            BOOST_CHECK_EQUAL(vv1.getDomainSize(), 2);
+        };
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+    // removes every value but val from the domain of vv, recording removals if a choice point is open
+    // bool restrictDomainTo(GraphImplementation::VariableVertex* vv, int val);
+    BOOST_AUTO_TEST_SUITE(restrictDomainTo);
+
+        BOOST_AUTO_TEST_CASE(restrict_then_undo) {
+            // setup: restrict vv2 inside a choice point
+            trail.markChoicePoint();
+            BOOST_TEST(trail.restrictDomainTo(&vv2, 5));
+            // precondition: only 5 remains
+            BOOST_REQUIRE_EQUAL(vv2.getDomainSize(), 1);
+            BOOST_REQUIRE_EQUAL(trail.size(), 2);
+
+            // test: undoing restores the whole domain
+            trail.undoToLastChoicePoint();
+            std::set<int> expected {4, 5, 6};
+            std::set<int> actual = vv2.getDomain();
+            BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), actual.begin(), actual.end());
+            BOOST_CHECK_EQUAL(trail.size(), 0);
+        };
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+    // restores every removal made since the last choice point, then closes it
+    // void undoToLastChoicePoint();
+    BOOST_AUTO_TEST_SUITE(undoToLastChoicePoint);
+
+        BOOST_AUTO_TEST_CASE(nested_choice_points_undo_one_level_at_a_time) {
+            // setup: remove values across two nested choice points
+            trail.markChoicePoint();
+            trail.removeFromDomain(&vv1, 1);
+            trail.markChoicePoint();
+            trail.removeFromDomain(&vv1, 2);
+            trail.removeFromDomain(&vv2, 4);
+            // precondition: two choice points are open
+            BOOST_REQUIRE_EQUAL(trail.depth(), 2);
+
+            // test 1: undoing once only restores removals of the inner choice point
+            trail.undoToLastChoicePoint();
+            BOOST_TEST(vv1.domainContains(2));
+            BOOST_TEST(vv2.domainContains(4));
+            BOOST_TEST(!vv1.domainContains(1));
+            BOOST_CHECK_EQUAL(trail.depth(), 1);
+
+            // test 2: undoing again restores the rest
+            trail.undoToLastChoicePoint();
+            BOOST_TEST(vv1.domainContains(1));
+            BOOST_CHECK_EQUAL(trail.depth(), 0);
+            BOOST_CHECK_EQUAL(trail.size(), 0);
+        };
+
+        BOOST_AUTO_TEST_CASE(no_choice_point_does_nothing) {
+            // setup: remove a value outside of any choice point
+            trail.removeFromDomain(&vv1, 3);
+
+            // test: undoing doesn't bring it back
+            trail.undoToLastChoicePoint();
+            BOOST_TEST(!vv1.domainContains(3));
+            BOOST_CHECK_EQUAL(trail.depth(), 0);
+        };
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+    // number of empty / single valued domains, updated by changes made through the trail
+    // void setDomainCounts(size_t empty_domains, size_t single_domains);
+    BOOST_AUTO_TEST_SUITE(setDomainCounts);
+
+        BOOST_AUTO_TEST_CASE(counts_follow_removals_and_undos) {
+            // setup: neither vv1 nor vv2 is single valued nor empty
+            trail.setDomainCounts(0, 0);
+            trail.markChoicePoint();
+
+            // test 1: restricting a domain makes it single valued, emptying it makes it empty
+            trail.restrictDomainTo(&vv1, 2);
+            BOOST_CHECK_EQUAL(trail.singleDomainCount(), 1);
+            trail.removeFromDomain(&vv1, 2);
+            BOOST_CHECK_EQUAL(trail.singleDomainCount(), 0);
+            BOOST_CHECK_EQUAL(trail.emptyDomainCount(), 1);
+            // removing a value from a larger domain changes no count
+            trail.removeFromDomain(&vv2, 4);
+            BOOST_CHECK_EQUAL(trail.singleDomainCount(), 0);
+
+            // test 2: undoing brings the counts back along with the values
+            trail.undoToLastChoicePoint();
+            BOOST_CHECK_EQUAL(trail.singleDomainCount(), 0);
+            BOOST_CHECK_EQUAL(trail.emptyDomainCount(), 0);
+
+            // test 3: clearing resets the counts
+            trail.setDomainCounts(3, 4);
+            trail.clear();
+            BOOST_CHECK_EQUAL(trail.emptyDomainCount(), 0);
+            BOOST_CHECK_EQUAL(trail.singleDomainCount(), 0);
+        };
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+    // sets the domain hashes for the variables changes will be made to from here on
+    // void setDomainHashes(uint64_t domain_hash, uint64_t check_hash);
+    BOOST_AUTO_TEST_SUITE(setDomainHashes);
+
+        BOOST_AUTO_TEST_CASE(hashes_follow_removals_and_undos_while_hashing) {
+            // setup: hash the domains of vv1 as held now
+            uint64_t domain_hash = 0, check_hash = 0;
+            for (int val : {1, 2, 3})
+            {
+                domain_hash ^= CSPSolverImplementation::Trail::valueKey(vv1.getId(), val, 0);
+                check_hash ^= CSPSolverImplementation::Trail::valueKey(vv1.getId(), val, 1);
+            }
+            trail.setHashing(true);
+            trail.setDomainHashes(domain_hash, check_hash);
+            trail.markChoicePoint();
+
+            // test 1: removing a value changes both hashes, by the key of that value
+            trail.removeFromDomain(&vv1, 2);
+            BOOST_CHECK_EQUAL(trail.domainHash(), domain_hash ^ CSPSolverImplementation::Trail::valueKey(vv1.getId(), 2, 0));
+            BOOST_CHECK_EQUAL(trail.checkHash(), check_hash ^ CSPSolverImplementation::Trail::valueKey(vv1.getId(), 2, 1));
+
+            // test 2: undoing brings the hashes back along with the values
+            trail.undoToLastChoicePoint();
+            BOOST_CHECK_EQUAL(trail.domainHash(), domain_hash);
+            BOOST_CHECK_EQUAL(trail.checkHash(), check_hash);
+
+            // test 3: while not hashing, the hashes are left as they are
+            trail.setHashing(false);
+            trail.removeFromDomain(&vv1, 3);
+            BOOST_CHECK_EQUAL(trail.domainHash(), domain_hash);
+        };
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE_END();
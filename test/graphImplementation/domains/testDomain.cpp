@@ -0,0 +1,125 @@
+// Author: Akira Kudo
+// Description: Implements tests for the Domain class in GraphImplementation.
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <set>
+#include <vector>
+
+#include "src/graphImplementation/domains/Domain.h"
+
+using GraphImplementation::Domain;
+
+BOOST_AUTO_TEST_SUITE(Domain_test_suite, * boost::unit_test::label("Domain"));
+
+    // returns whether val is in the domain / inserts val if not there
+    // bool contains(int val) const; bool insert(int val);
+    BOOST_AUTO_TEST_SUITE(contains_and_insert);
+
+        BOOST_AUTO_TEST_CASE(bitset_and_set_mode_agree) {
+            // setup: create the same domain in both modes
+            Domain bitset_d = Domain({1, 3, 5, 9}, Domain::BitsetMode);
+            Domain set_d = Domain({1, 3, 5, 9}, Domain::SetMode);
+
+            // test: check both modes answer membership the same way
+            for (int val = -2; val < 12; val++)
+                BOOST_CHECK_EQUAL(bitset_d.contains(val), set_d.contains(val));
+            BOOST_CHECK_EQUAL(bitset_d.size(), 4);
+            BOOST_CHECK_EQUAL(set_d.size(), 4);
+            BOOST_TEST(bitset_d == set_d);
+        }
+
+        BOOST_AUTO_TEST_CASE(insert_outside_of_current_range) {
+            // setup: create a small domain, then insert values below & far above it
+            Domain d = Domain({10, 11, 12});
+            BOOST_TEST(d.insert(-5));
+            BOOST_TEST(d.insert(200));
+            // inserting an existing value doesn't change anything
+            BOOST_TEST(!d.insert(11));
+
+            // test: check every value is still there and in order
+            std::set<int> expected {-5, 10, 11, 12, 200};
+            std::set<int> actual = d.toSet();
+            BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), actual.begin(), actual.end());
+            BOOST_CHECK_EQUAL(d.size(), 5);
+            BOOST_CHECK_EQUAL(d.getMode(), Domain::BitsetMode);
+        }
+
+        BOOST_AUTO_TEST_CASE(very_wide_range_falls_back_to_set_mode) {
+            // setup: create a domain whose range is too wide for a bitset
+            Domain d = Domain({0, Domain::MAX_BITSET_RANGE * 4});
+
+            // test: check it switched mode but still holds the values
+            BOOST_CHECK_EQUAL(d.getMode(), Domain::SetMode);
+            BOOST_TEST(d.contains(0));
+            BOOST_TEST(d.contains(Domain::MAX_BITSET_RANGE * 4));
+            BOOST_CHECK_EQUAL(d.size(), 2);
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+    // removes val if there; returns whether the domain changed
+    // bool erase(int val);
+    BOOST_AUTO_TEST_SUITE(erase);
+
+        BOOST_AUTO_TEST_CASE(erase_existing_and_missing_values) {
+            // setup: create a sudoku-like domain
+            Domain d = Domain({1, 2, 3, 4, 5, 6, 7, 8, 9});
+
+            // test: erasing reports whether a value was removed, keeping size up to date
+            BOOST_TEST(d.erase(5));
+            BOOST_TEST(!d.erase(5));
+            BOOST_TEST(!d.erase(100));
+            BOOST_CHECK_EQUAL(d.size(), 8);
+            BOOST_TEST(!d.contains(5));
+        }
+
+        BOOST_AUTO_TEST_CASE(erase_while_iterating) {
+            // setup: create a domain spanning several words
+            Domain d = Domain({0, 1, 64, 65, 130});
+
+            // test: removing the value the iterator is on doesn't break iteration
+            std::vector<int> visited;
+            for (int val : d)
+            {
+                visited.push_back(val);
+                d.erase(val);
+            }
+            std::vector<int> expected {0, 1, 64, 65, 130};
+            BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), visited.begin(), visited.end());
+            BOOST_TEST(d.empty());
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+    // removes every value but val / every value not found in other
+    // bool keepOnly(int val); bool intersectWith(const Domain& other);
+    BOOST_AUTO_TEST_SUITE(keepOnly_and_intersectWith);
+
+        BOOST_AUTO_TEST_CASE(keep_only_one_value) {
+            Domain d = Domain({0, 1, 2, 3, 4, 5, 6, 7});
+            BOOST_TEST(d.keepOnly(5));
+            BOOST_CHECK_EQUAL(d.size(), 1);
+            BOOST_CHECK_EQUAL(d.min(), 5);
+            BOOST_CHECK_EQUAL(d.max(), 5);
+            // keeping a value that isn't there empties the domain
+            BOOST_TEST(d.keepOnly(3));
+            BOOST_TEST(d.empty());
+        }
+
+        BOOST_AUTO_TEST_CASE(intersect_with_other_domain) {
+            Domain d = Domain({0, 1, 2, 3, 4, 5, 6, 7});
+            Domain other = Domain({1, 3, 5, 7, 9});
+            BOOST_TEST(d.intersectWith(other));
+            std::set<int> expected {1, 3, 5, 7};
+            std::set<int> actual = d.toSet();
+            BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), actual.begin(), actual.end());
+            BOOST_CHECK_EQUAL(d.size(), 4);
+            // intersecting again changes nothing
+            BOOST_TEST(!d.intersectWith(other));
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,250 @@
+// Author: Akira Kudo
+// Description: Implements tests for the ConstraintKernel class in GraphImplementation.
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <set>
+#include <vector>
+
+#include "src/graphImplementation/vertices/ConstraintKernel.h"
+#include "src/graphImplementation/vertices/VariableVertex.h"
+
+using GraphImplementation::ConstraintKernel, GraphImplementation::VariableVertex;
+
+BOOST_AUTO_TEST_SUITE(ConstraintKernel_test_suite, * boost::unit_test::label("ConstraintKernel"));
+
+    // cardinality kernels are stored as plain data
+    // static ConstraintKernel lesserOrEqualToN(int checkedDomain, int n); ...
+    BOOST_AUTO_TEST_SUITE(cardinality_kernels);
+
+        BOOST_AUTO_TEST_CASE(kernels_hold_their_type_and_data) {
+            // setup: create one kernel of each type
+            ConstraintKernel leq = ConstraintKernel::lesserOrEqualToN(3, 1);
+            ConstraintKernel geq = ConstraintKernel::greaterOrEqualToN(4, 2);
+            ConstraintKernel exactly = ConstraintKernel::exactlyN(5, 3);
+
+            // test: check the type, counted value and n are kept
+            BOOST_CHECK_EQUAL(leq.getType(), ConstraintKernel::LesserOrEqualToN);
+            BOOST_CHECK_EQUAL(leq.getCheckedValue(), 3);
+            BOOST_CHECK_EQUAL(leq.getN(), 1);
+            BOOST_CHECK_EQUAL(geq.getType(), ConstraintKernel::GreaterOrEqualToN);
+            BOOST_CHECK_EQUAL(geq.getCheckedValue(), 4);
+            BOOST_CHECK_EQUAL(geq.getN(), 2);
+            BOOST_CHECK_EQUAL(exactly.getType(), ConstraintKernel::ExactlyN);
+            BOOST_CHECK_EQUAL(exactly.getCheckedValue(), 5);
+            BOOST_CHECK_EQUAL(exactly.getN(), 3);
+        }
+
+        BOOST_AUTO_TEST_CASE(exactly_n_on_a_small_scope) {
+            // setup: two other variables, one which has to be 1 and one which can be 1
+            VariableVertex has_to_be_1 = VariableVertex("has_to_be_1", {1});
+            VariableVertex can_be_1 = VariableVertex("can_be_1", {1, 2});
+            std::vector<VariableVertex*> var_list {&has_to_be_1, &can_be_1};
+            ConstraintKernel exactly_one = ConstraintKernel::exactlyN(1, 1);
+            ConstraintKernel exactly_two = ConstraintKernel::exactlyN(1, 2);
+            ConstraintKernel exactly_three = ConstraintKernel::exactlyN(1, 3);
+
+            // test: main value 1 makes two 1s necessary, anything else keeps 1 to 2 of them possible
+            BOOST_TEST(!exactly_one.isMet(1, var_list));
+            BOOST_TEST(exactly_one.isMet(2, var_list));
+            BOOST_TEST(exactly_two.isMet(1, var_list));
+            BOOST_TEST(exactly_two.isMet(2, var_list));
+            BOOST_TEST(exactly_three.isMet(1, var_list));
+            BOOST_TEST(!exactly_three.isMet(2, var_list));
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+    // bounds how many variables of the scope take each of several values at once
+    // static ConstraintKernel globalCardinality(std::vector<CardinalityBound> bounds);
+    BOOST_AUTO_TEST_SUITE(global_cardinality);
+
+        BOOST_AUTO_TEST_CASE(bounds_are_sorted_and_intersected) {
+            // setup: bounds out of order, value 2 being bounded twice
+            ConstraintKernel gcc = ConstraintKernel::globalCardinality({ {3, 0, 1}, {2, 1, 3}, {1, 1, 1}, {2, 0, 2} });
+
+            // test: one bound per value, in order of value
+            BOOST_CHECK_EQUAL(gcc.getType(), ConstraintKernel::GlobalCardinality);
+            const std::vector<ConstraintKernel::CardinalityBound>& bounds = gcc.getBounds();
+            BOOST_REQUIRE_EQUAL(bounds.size(), 3);
+            BOOST_CHECK_EQUAL(bounds[0].value, 1);
+            BOOST_CHECK_EQUAL(bounds[1].value, 2);
+            BOOST_CHECK_EQUAL(bounds[1].min, 1);
+            BOOST_CHECK_EQUAL(bounds[1].max, 2);
+            BOOST_CHECK_EQUAL(bounds[2].value, 3);
+            BOOST_TEST(ConstraintKernel::exactlyN(1, 1).getBounds().empty());
+        }
+
+        BOOST_AUTO_TEST_CASE(pigeonhole_is_seen_through_matching) {
+            // setup: each of 1, 2 & 3 taken exactly once, two variables sharing values 1 & 2
+            VariableVertex a = VariableVertex("a", {1, 2});
+            VariableVertex b = VariableVertex("b", {1, 2});
+            VariableVertex c = VariableVertex("c", {1, 2, 3});
+            std::vector<VariableVertex*> others {&a, &b};
+            ConstraintKernel gcc = ConstraintKernel::globalCardinality({ {1, 1, 1}, {2, 1, 1}, {3, 1, 1} });
+
+            // test: c can only be 3, which no exactlyN kernel alone tells
+            BOOST_TEST(!gcc.isMet(1, others));
+            BOOST_TEST(!gcc.isMet(2, others));
+            BOOST_TEST(gcc.isMet(3, others));
+            BOOST_TEST(ConstraintKernel::exactlyN(1, 1).isMet(1, others));
+            BOOST_TEST(ConstraintKernel::exactlyN(2, 1).isMet(1, others));
+
+            std::vector<VariableVertex*> scope {&c, &a, &b};
+            std::vector<std::vector<int>> unsupported;
+            BOOST_TEST(gcc.matchingSupports(scope, unsupported));
+            BOOST_REQUIRE_EQUAL(unsupported.size(), 3);
+            BOOST_TEST(unsupported[0] == std::vector<int>({1, 2}));
+            BOOST_TEST(unsupported[1].empty());
+            BOOST_TEST(unsupported[2].empty());
+        }
+
+        BOOST_AUTO_TEST_CASE(lower_and_upper_bounds) {
+            // setup: at least two 1s and at most one 2 among four variables, 3 being unbounded
+            VariableVertex a = VariableVertex("a", {1, 2});
+            VariableVertex b = VariableVertex("b", {1, 2, 3});
+            VariableVertex c = VariableVertex("c", {2, 3});
+            VariableVertex d = VariableVertex("d", {1, 3});
+            std::vector<VariableVertex*> scope {&a, &b, &c, &d};
+            ConstraintKernel gcc = ConstraintKernel::globalCardinality({ {1, 2, 4}, {2, 0, 1} });
+            std::vector<std::vector<int>> unsupported;
+
+            // test: every value keeps a support while a, b & d can all be 1
+            BOOST_TEST(gcc.matchingSupports(scope, unsupported));
+            for (const std::vector<int>& values : unsupported) BOOST_TEST(values.empty());
+
+            // once b can't be 1, a & d have to be 1
+            b.removeFromDomain(1);
+            BOOST_TEST(gcc.matchingSupports(scope, unsupported));
+            BOOST_TEST(unsupported[0] == std::vector<int>({2}));
+            BOOST_TEST(unsupported[1].empty());
+            BOOST_TEST(unsupported[2].empty());
+            BOOST_TEST(unsupported[3] == std::vector<int>({3}));
+
+            // once d can't be 1 either, no assignment is left
+            d.removeFromDomain(1);
+            BOOST_TEST(!gcc.matchingSupports(scope, unsupported));
+            BOOST_TEST(!gcc.isMet(1, {&b, &c, &d}));
+        }
+
+        BOOST_AUTO_TEST_CASE(bounded_value_missing_from_every_domain) {
+            VariableVertex a = VariableVertex("a", {1, 2});
+            std::vector<std::vector<int>> unsupported;
+            BOOST_TEST(!ConstraintKernel::globalCardinality({ {5, 1, 1} }).matchingSupports({&a}, unsupported));
+            BOOST_TEST(ConstraintKernel::globalCardinality({ {5, 0, 1} }).matchingSupports({&a}, unsupported));
+            BOOST_TEST(!ConstraintKernel::globalCardinality({ {1, 2, 1} }).isMet(1, {}));
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+    // checks if given domains allow every variable to take a value no other variable takes
+    // static ConstraintKernel allDifferent();
+    BOOST_AUTO_TEST_SUITE(all_different);
+
+        BOOST_AUTO_TEST_CASE(pigeonhole_is_seen_through_matching) {
+            // setup: two variables sharing values 1 & 2, a third one allowing 1, 2 & 3
+            VariableVertex a = VariableVertex("a", {1, 2});
+            VariableVertex b = VariableVertex("b", {1, 2});
+            VariableVertex c = VariableVertex("c", {1, 2, 3});
+            ConstraintKernel all_different = ConstraintKernel::allDifferent();
+
+            // test: c can only be 3, and no value is bounded as in a global cardinality constraint
+            BOOST_CHECK_EQUAL(all_different.getType(), ConstraintKernel::AllDifferent);
+            BOOST_TEST(all_different.usesMatching());
+            BOOST_TEST(all_different.getBounds().empty());
+            BOOST_TEST(!all_different.isMet(1, {&a, &b}));
+            BOOST_TEST(all_different.isMet(3, {&a, &b}));
+            std::vector<std::vector<int>> unsupported;
+            BOOST_TEST(all_different.matchingSupports({&c, &a, &b}, unsupported));
+            BOOST_TEST(unsupported[0] == std::vector<int>({1, 2}));
+            BOOST_TEST(unsupported[1].empty());
+            // three variables can't share two values
+            c.removeFromDomain(3);
+            BOOST_TEST(!all_different.matchingSupports({&c, &a, &b}, unsupported));
+        }
+
+        BOOST_AUTO_TEST_CASE(matching_is_reused_across_calls) {
+            // setup: four variables, starting without any matching
+            VariableVertex a = VariableVertex("a", {1, 2, 3, 4});
+            VariableVertex b = VariableVertex("b", {1, 2, 3, 4});
+            VariableVertex c = VariableVertex("c", {1, 2, 3, 4});
+            VariableVertex d = VariableVertex("d", {1, 2, 3, 4});
+            std::vector<VariableVertex*> scope {&a, &b, &c, &d};
+            ConstraintKernel all_different = ConstraintKernel::allDifferent();
+            std::vector<std::vector<int>> unsupported;
+            std::vector<int> matching;
+
+            // test: the matching found gives each variable a value of its own domain, all different
+            BOOST_TEST(all_different.matchingSupports(scope, unsupported, &matching));
+            BOOST_REQUIRE_EQUAL(matching.size(), 4);
+            std::vector<int> previous = matching;
+            for (size_t x = 0; x < scope.size(); x++) BOOST_TEST(scope[x]->getDomainStore().contains(matching[x]));
+            BOOST_CHECK_EQUAL(std::set<int>(matching.begin(), matching.end()).size(), 4);
+
+            // removing the value of a only moves a, the others keeping theirs
+            a.removeFromDomain(previous[0]);
+            BOOST_TEST(all_different.matchingSupports(scope, unsupported, &matching));
+            BOOST_TEST(matching[0] != previous[0]);
+            BOOST_TEST(a.getDomainStore().contains(matching[0]));
+            BOOST_CHECK_EQUAL(std::set<int>(matching.begin(), matching.end()).size(), 4);
+
+            // a matching that no longer fits at all, or is of another size, is just a worse starting point
+            std::vector<int> stale {7, 7, 7};
+            BOOST_TEST(all_different.matchingSupports(scope, unsupported, &stale));
+            BOOST_CHECK_EQUAL(stale.size(), 4);
+            b.restrictDomainTo(1);
+            c.restrictDomainTo(1);
+            BOOST_TEST(!all_different.matchingSupports(scope, unsupported, &matching));
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+    // any other predicate is kept as a std::function
+    // template <typename Pred> ConstraintKernel(Pred pred);
+    BOOST_AUTO_TEST_SUITE(custom_predicate);
+
+        BOOST_AUTO_TEST_CASE(lambda_becomes_custom_predicate) {
+            // setup: a predicate allowing only values greater than every other variable's minimum
+            ConstraintKernel greater_than_others = [] (int mainVal, std::vector<VariableVertex*> varList) {
+                for (VariableVertex* var : varList)
+                    if (mainVal <= var->getDomainStore().min()) return false;
+                return true;
+            };
+            VariableVertex other = VariableVertex("other", {2, 5});
+
+            // test: the kernel is a custom predicate, calling the lambda
+            BOOST_CHECK_EQUAL(greater_than_others.getType(), ConstraintKernel::CustomPredicate);
+            BOOST_TEST(!greater_than_others.isMet(2, {&other}));
+            BOOST_TEST(greater_than_others.isMet(3, {&other}));
+        }
+
+        BOOST_AUTO_TEST_CASE(cardinality_kernels_agree_with_std_function) {
+            // setup: the lambda the kernels replace, checking exactly n of checked value
+            auto exactly_n_as_lambda = [] (int checked, int n) {
+                return ConstraintKernel([=] (int mainVal, std::vector<VariableVertex*> varList) {
+                    int can_be = (mainVal == checked), has_to_be = (mainVal == checked);
+                    for (VariableVertex* var : varList)
+                    {
+                        can_be += var->domainContains(checked);
+                        has_to_be += (var->getDomainSize() == 1 && var->domainContains(checked));
+                    }
+                    return (has_to_be <= n && can_be >= n);
+                });
+            };
+            VariableVertex a = VariableVertex("a", {0});
+            VariableVertex b = VariableVertex("b", {0, 1});
+            VariableVertex c = VariableVertex("c", {1, 2});
+            std::vector<VariableVertex*> var_list {&a, &b, &c};
+
+            // test: both kernels agree on every main value, checked value & n
+            for (int checked = 0; checked < 3; checked++)
+                for (int n = 0; n < 5; n++)
+                    for (int mainVal = 0; mainVal < 3; mainVal++)
+                        BOOST_CHECK_EQUAL(ConstraintKernel::exactlyN(checked, n).isMet(mainVal, var_list),
+                                          exactly_n_as_lambda(checked, n).isMet(mainVal, var_list));
+        }
+
+    BOOST_AUTO_TEST_SUITE_END();
+
+BOOST_AUTO_TEST_SUITE_END();